@@ -429,6 +429,10 @@ void OSystem_GP2X::quit() {
 		SDL_JoystickClose(_joystick);
 	GP2X_HW::deviceDeinit();
 
+	// Write out savefiles still pending in the background, while the
+	// timer manager is still around.
+	_savefile->flushPendingSaves();
+
 	SDL_RemoveTimer(_timerID);
 	closeMixer();
 
@@ -511,6 +511,10 @@ void OSystem_SDL::quit() {
 
 	SDL_ShowCursor(SDL_ENABLE);
 
+	// Write out savefiles still pending in the background, while the
+	// timer manager is still around.
+	_savefile->flushPendingSaves();
+
 	SDL_RemoveTimer(_timerID);
 	closeMixer();
 
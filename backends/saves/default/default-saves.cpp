@@ -32,18 +32,94 @@
 #include "common/fs.h"
 #include "common/archive.h"
 #include "common/config-manager.h"
+#include "common/system.h"
+#include "common/timer.h"
 #include "common/zlib.h"
 
+#include <stdio.h>	// for rename()
 #include <errno.h>	// for removeSavefile()
 
 
-DefaultSaveFileManager::DefaultSaveFileManager() {
+/**
+ * OutSaveFile implementation which collects all data in memory. When it is
+ * finalized (or deleted), the data is handed over to the
+ * DefaultSaveFileManager, which compresses and writes it in the background.
+ * Write errors are reported by flushPendingSaves().
+ */
+class BackgroundSaveFile : public Common::WriteStream {
+private:
+	DefaultSaveFileManager *_manager;
+	Common::String _filename;
+	Common::MemoryWriteStreamDynamic *_buffer;
+	bool _err;
+
+	void queue() {
+		// The manager takes over the buffer; all further writes are dropped
+		if (!_manager->queuePendingSave(_filename, _buffer->getData(), _buffer->size()))
+			_err = true;
+		delete _buffer;
+		_buffer = 0;
+	}
+
+public:
+	BackgroundSaveFile(DefaultSaveFileManager *manager, const Common::String &filename)
+		: _manager(manager), _filename(filename), _err(false) {
+		_buffer = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+	}
+
+	~BackgroundSaveFile() {
+		if (_buffer)
+			queue();
+	}
+
+	bool err() const { return _err; }
+	void clearErr() { _err = false; }
+
+	uint32 write(const void *dataPtr, uint32 dataSize) {
+		if (!_buffer)
+			return 0;
+		return _buffer->write(dataPtr, dataSize);
+	}
+
+	void finalize() {
+		if (_buffer)
+			queue();
+	}
+};
+
+
+static Common::String readIndexString(Common::SeekableReadStream *in) {
+	Common::String str;
+	uint16 len = in->readUint16BE();
+	while (len-- > 0 && !in->eos())
+		str += (char)in->readByte();
+	return str;
+}
+
+static void writeIndexString(Common::WriteStream *out, const Common::String &str) {
+	out->writeUint16BE(str.size());
+	out->write(str.c_str(), str.size());
+}
+
+
+DefaultSaveFileManager::DefaultSaveFileManager() : _timerInstalled(false), _indexDirty(false) {
 }
 
-DefaultSaveFileManager::DefaultSaveFileManager(const Common::String &defaultSavepath) {
+DefaultSaveFileManager::DefaultSaveFileManager(const Common::String &defaultSavepath) : _timerInstalled(false), _indexDirty(false) {
 	ConfMan.registerDefault("savepath", defaultSavepath);
 }
 
+DefaultSaveFileManager::~DefaultSaveFileManager() {
+	// The timer manager may already be gone at this point, so the timer
+	// proc has to be removed by flushPendingSaves() before, see
+	// scummvm_main() and the quit() methods of the backends.
+	if (_timerInstalled)
+		warning("DefaultSaveFileManager: Destroyed without flushing pending savefiles");
+
+	writePendingSaves();
+	saveIndex();
+}
+
 
 void DefaultSaveFileManager::checkPath(const Common::FSNode &dir) {
 	clearError();
@@ -55,6 +131,9 @@ void DefaultSaveFileManager::checkPath(const Common::FSNode &dir) {
 }
 
 Common::StringList DefaultSaveFileManager::listSavefiles(const Common::String &pattern) {
+	// Make sure savefiles which are still being written show up
+	flushPendingSaves();
+
 	Common::String savePathName = getSavePath();
 	checkPath(Common::FSNode(savePathName));
 	if (getError() != Common::kNoError)
@@ -78,6 +157,9 @@ Common::StringList DefaultSaveFileManager::listSavefiles(const Common::String &p
 }
 
 Common::InSaveFile *DefaultSaveFileManager::openForLoading(const Common::String &filename) {
+	if (isSavePending(filename))
+		flushPendingSaves();
+
 	// Ensure that the savepath is valid. If not, generate an appropriate error.
 	Common::String savePathName = getSavePath();
 	checkPath(Common::FSNode(savePathName));
@@ -107,15 +189,17 @@ Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String
 	// recreate FSNode since checkPath may have changed/created the directory
 	Common::FSNode savePath(savePathName);
 
-	Common::FSNode file = savePath.getChild(filename);
-
-	// Open the file for saving
-	Common::WriteStream *sf = file.createWriteStream();
-
-	return Common::wrapCompressedWriteStream(sf);
+	// The data is collected in memory and written out in the background
+	// once the savefile is finalized, see queuePendingSave().
+	return new BackgroundSaveFile(this, filename);
 }
 
 bool DefaultSaveFileManager::removeSavefile(const Common::String &filename) {
+	if (isSavePending(filename))
+		flushPendingSaves();
+
+	invalidateIndexEntry(filename);
+
 	Common::String savePathName = getSavePath();
 	checkPath(Common::FSNode(savePathName));
 	if (getError() != Common::kNoError)
@@ -143,6 +227,317 @@ bool DefaultSaveFileManager::removeSavefile(const Common::String &filename) {
 	}
 }
 
+bool DefaultSaveFileManager::queuePendingSave(const Common::String &filename, byte *data, uint32 size) {
+	PendingSave *save = new PendingSave();
+	save->filename = filename;
+	save->data = data;
+	save->size = size;
+	save->pos = 0;
+	save->out = 0;
+
+	Common::FSNode file = Common::FSNode(getSavePath()).getChild(filename);
+	save->path = file.getPath();
+	save->tmpPath = save->path + ".tmp";
+
+	{
+		Common::StackLock lock(_pendingMutex);
+		_pendingSaves.push_back(save);
+	}
+
+	invalidateIndexEntry(filename);
+
+	// Note: The timer must never be (un)installed while holding _pendingMutex,
+	// since the timer manager holds its own lock while invoking timerProc.
+	bool timerInstalled;
+	{
+		Common::StackLock lock(_timerMutex);
+		if (!_timerInstalled)
+			_timerInstalled = g_system->getTimerManager()->installTimerProc(&timerProc, kSaveTimerInterval, this);
+		timerInstalled = _timerInstalled;
+	}
+
+	// Without a timer, write the savefile right away
+	if (!timerInstalled)
+		return flushPendingSaves();
+
+	return true;
+}
+
+bool DefaultSaveFileManager::flushPendingSaves() {
+	Common::String errorDesc = writePendingSaves();
+
+	{
+		Common::StackLock lock(_timerMutex);
+		if (_timerInstalled) {
+			g_system->getTimerManager()->removeTimerProc(&timerProc);
+			_timerInstalled = false;
+		}
+	}
+
+	saveIndex();
+
+	if (!errorDesc.empty()) {
+		setError(Common::kWritingFailed, errorDesc);
+		return false;
+	}
+
+	return true;
+}
+
+Common::String DefaultSaveFileManager::writePendingSaves() {
+	Common::StackLock lock(_pendingMutex);
+
+	while (!_pendingSaves.empty()) {
+		PendingSave *save = _pendingSaves.front();
+		processPendingSave(save, save->size);
+		_pendingSaves.pop_front();
+		discardPendingSave(save);
+	}
+
+	Common::String errorDesc = _pendingErrorDesc;
+	_pendingErrorDesc.clear();
+	return errorDesc;
+}
+
+bool DefaultSaveFileManager::isSavePending(const Common::String &filename) {
+	Common::StackLock lock(_pendingMutex);
+
+	for (PendingSaveList::const_iterator i = _pendingSaves.begin(); i != _pendingSaves.end(); ++i) {
+		if ((*i)->filename == filename)
+			return true;
+	}
+
+	return false;
+}
+
+void DefaultSaveFileManager::timerProc(void *refCon) {
+	DefaultSaveFileManager *manager = (DefaultSaveFileManager *)refCon;
+	Common::StackLock lock(manager->_pendingMutex);
+
+	if (manager->_pendingSaves.empty())
+		return;
+
+	// Only process a slice of the oldest savefile, so that other timers
+	// (e.g. music players) are not delayed noticeably.
+	PendingSave *save = manager->_pendingSaves.front();
+	if (manager->processPendingSave(save, kSaveSliceSize)) {
+		manager->_pendingSaves.pop_front();
+		manager->discardPendingSave(save);
+	}
+}
+
+bool DefaultSaveFileManager::processPendingSave(PendingSave *save, uint32 maxBytes) {
+	if (!save->out) {
+		// Write into a temporary file first, so that the old savefile stays
+		// intact if anything goes wrong while writing the new one.
+		Common::FSNode tmpFile(save->tmpPath);
+		save->out = Common::wrapCompressedWriteStream(tmpFile.createWriteStream());
+		if (!save->out) {
+			_pendingErrorDesc = "Could not create savefile '" + save->filename + "'";
+			warning("%s", _pendingErrorDesc.c_str());
+			return true;
+		}
+	}
+
+	const uint32 len = MIN(maxBytes, save->size - save->pos);
+	if (len > 0) {
+		save->out->write(save->data + save->pos, len);
+		save->pos += len;
+	}
+
+	if (!save->out->err() && save->pos < save->size)
+		return false;
+
+	save->out->finalize();
+	bool success = !save->out->err();
+	delete save->out;
+	save->out = 0;
+
+	if (success)
+		success = commitSavefile(save->tmpPath, save->path);
+	else
+		remove(save->tmpPath.c_str());
+
+	if (!success) {
+		_pendingErrorDesc = "Writing savefile '" + save->filename + "' failed";
+		warning("%s", _pendingErrorDesc.c_str());
+	}
+
+	return true;
+}
+
+void DefaultSaveFileManager::discardPendingSave(PendingSave *save) {
+	delete save->out;
+	free(save->data);
+	delete save;
+}
+
+bool DefaultSaveFileManager::commitSavefile(const Common::String &oldPath, const Common::String &newPath) {
+#if defined(WIN32) || defined(_WIN32_WCE)
+	// rename() does not replace existing files on Windows
+	remove(newPath.c_str());
+#endif
+	return rename(oldPath.c_str(), newPath.c_str()) == 0;
+}
+
+bool DefaultSaveFileManager::getSavefileStamp(const Common::FSNode &file, uint32 &size, uint32 &time) {
+	Common::SeekableReadStream *stream = file.createReadStream();
+	if (!stream)
+		return false;
+
+	size = stream->size();
+	time = 0;
+	delete stream;
+	return true;
+}
+
+bool DefaultSaveFileManager::getSaveMetaInfo(const Common::String &target, const Common::String &filename, Common::StringMap &metaInfo) {
+	if (isSavePending(filename) || !loadIndex(target))
+		return false;
+
+	SaveIndex::const_iterator entry = _index.find(filename);
+	if (entry == _index.end())
+		return false;
+
+	// Verify that the savefile was not modified since the entry was stored
+	uint32 size, time;
+	Common::FSNode file = Common::FSNode(getSavePath()).getChild(filename);
+	if (!getSavefileStamp(file, size, time) || size != entry->_value.fileSize || time != entry->_value.fileTime) {
+		invalidateIndexEntry(filename);
+		return false;
+	}
+
+	metaInfo = entry->_value.metaInfo;
+	return true;
+}
+
+void DefaultSaveFileManager::setSaveMetaInfo(const Common::String &target, const Common::String &filename, const Common::StringMap &metaInfo) {
+	if (isSavePending(filename) || !loadIndex(target))
+		return;
+
+	SaveIndexEntry entry;
+	Common::FSNode file = Common::FSNode(getSavePath()).getChild(filename);
+	if (!getSavefileStamp(file, entry.fileSize, entry.fileTime))
+		return;
+
+	entry.metaInfo = metaInfo;
+	_index[filename] = entry;
+	_indexDirty = true;
+}
+
+void DefaultSaveFileManager::invalidateIndexEntry(const Common::String &filename) {
+	// Savefiles are usually written by the running engine, so make sure
+	// the index of the active target is checked
+	const Common::String target = ConfMan.getActiveDomainName();
+	if (!target.empty())
+		loadIndex(target);
+
+	if (!_index.contains(filename))
+		return;
+
+	_index.erase(filename);
+	_indexDirty = true;
+}
+
+Common::FSNode DefaultSaveFileManager::getIndexFile() const {
+	// Note: The name deliberately does not start with the target name, so
+	// that it never matches the savefile patterns used by the engines.
+	return Common::FSNode(_indexSavePath).getChild("scummvm-" + _indexTarget + ".idx");
+}
+
+bool DefaultSaveFileManager::loadIndex(const Common::String &target) {
+	const Common::String savePath = getSavePath();
+
+	if (target.empty() || savePath.empty())
+		return false;
+
+	if (target == _indexTarget && savePath == _indexSavePath)
+		return true;
+
+	// Switching targets, so write out the old index first
+	saveIndex();
+
+	_index.clear();
+	_indexTarget = target;
+	_indexSavePath = savePath;
+	_indexDirty = false;
+
+	Common::FSNode file = getIndexFile();
+	if (!file.exists())
+		return true;
+
+	Common::SeekableReadStream *in = file.createReadStream();
+	if (!in)
+		return true;
+
+	if (in->readUint32BE() == MKID_BE('SIDX') && in->readUint32BE() == kSaveIndexVersion) {
+		uint32 count = in->readUint32BE();
+		while (count-- > 0 && !in->eos() && !in->err()) {
+			SaveIndexEntry entry;
+			Common::String filename = readIndexString(in);
+			entry.fileSize = in->readUint32BE();
+			entry.fileTime = in->readUint32BE();
+
+			uint32 keys = in->readUint32BE();
+			while (keys-- > 0 && !in->eos()) {
+				Common::String key = readIndexString(in);
+				entry.metaInfo[key] = readIndexString(in);
+			}
+
+			_index[filename] = entry;
+		}
+
+		if (in->eos() || in->err()) {
+			// The index is damaged, simply rebuild it from scratch
+			warning("Savefile index '%s' is corrupt", file.getName().c_str());
+			_index.clear();
+			_indexDirty = true;
+		}
+	}
+
+	delete in;
+	return true;
+}
+
+void DefaultSaveFileManager::saveIndex() {
+	if (!_indexDirty || _indexTarget.empty())
+		return;
+
+	_indexDirty = false;
+
+	Common::FSNode file = getIndexFile();
+	Common::String tmpPath = file.getPath() + ".tmp";
+	Common::WriteStream *out = Common::FSNode(tmpPath).createWriteStream();
+	if (!out)
+		return;
+
+	out->writeUint32BE(MKID_BE('SIDX'));
+	out->writeUint32BE(kSaveIndexVersion);
+	out->writeUint32BE(_index.size());
+
+	for (SaveIndex::const_iterator entry = _index.begin(); entry != _index.end(); ++entry) {
+		writeIndexString(out, entry->_key);
+		out->writeUint32BE(entry->_value.fileSize);
+		out->writeUint32BE(entry->_value.fileTime);
+
+		const Common::StringMap &metaInfo = entry->_value.metaInfo;
+		out->writeUint32BE(metaInfo.size());
+		for (Common::StringMap::const_iterator i = metaInfo.begin(); i != metaInfo.end(); ++i) {
+			writeIndexString(out, i->_key);
+			writeIndexString(out, i->_value);
+		}
+	}
+
+	out->finalize();
+	bool success = !out->err();
+	delete out;
+
+	if (!success || !commitSavefile(tmpPath, file.getPath())) {
+		warning("Could not write savefile index '%s'", file.getName().c_str());
+		remove(tmpPath.c_str());
+	}
+}
+
 Common::String DefaultSaveFileManager::getSavePath() const {
 
 	Common::String dir;
@@ -30,20 +30,54 @@
 #include "common/savefile.h"
 #include "common/str.h"
 #include "common/fs.h"
+#include "common/hashmap.h"
+#include "common/list.h"
+#include "common/mutex.h"
 
 /**
  * Provides a default savefile manager implementation for common platforms.
+ *
+ * Savefiles opened for saving are buffered in memory, and written into a
+ * temporary file which is then atomically renamed over the real savefile.
+ * Once the engine finalizes or deletes the OutSaveFile, the buffer is handed
+ * to a timer callback which compresses and writes it in small slices, so
+ * that the engine continues running immediately instead of waiting for zlib
+ * and the disk. Write errors are reported by the next flushPendingSaves().
+ *
+ * flushPendingSaves() has to be called before the timer manager is
+ * destroyed.
+ *
+ * Furthermore, a per-target index file with the meta information engines
+ * store via setSaveMetaInfo() is maintained in the savepath, so that the
+ * save/load dialog can be filled without opening every savefile.
  */
 class DefaultSaveFileManager : public Common::SaveFileManager {
 public:
 	DefaultSaveFileManager();
 	DefaultSaveFileManager(const Common::String &defaultSavepath);
+	virtual ~DefaultSaveFileManager();
 
 	virtual Common::StringList listSavefiles(const Common::String &pattern);
 	virtual Common::InSaveFile *openForLoading(const Common::String &filename);
 	virtual Common::OutSaveFile *openForSaving(const Common::String &filename);
 	virtual bool removeSavefile(const Common::String &filename);
 
+	virtual bool flushPendingSaves();
+	virtual bool isSavePending(const Common::String &filename);
+
+	virtual bool getSaveMetaInfo(const Common::String &target, const Common::String &filename, Common::StringMap &metaInfo);
+	virtual void setSaveMetaInfo(const Common::String &target, const Common::String &filename, const Common::StringMap &metaInfo);
+
+	/**
+	 * Queue the contents of a background savefile for writing.
+	 * Takes ownership of the (malloc'ed) data buffer.
+	 * Only to be used by the OutSaveFile implementation.
+	 *
+	 * @return false if the savefile had to be written right away (because
+	 *         no timer is available), and this failed
+	 */
+	bool queuePendingSave(const Common::String &filename, byte *data, uint32 size);
+
 protected:
 	/**
 	 * Get the path to the savegame directory.
@@ -57,6 +91,93 @@ protected:
 	 * Sets the internal error and error message accordingly.
 	 */
 	virtual void checkPath(const Common::FSNode &dir);
+
+	/**
+	 * Replace the file at newPath with the file at oldPath. Used to commit
+	 * a completely written temporary file to the real savefile name.
+	 */
+	virtual bool commitSavefile(const Common::String &oldPath, const Common::String &newPath);
+
+	/**
+	 * Determine size and modification time of the given savefile. These are
+	 * stored in the meta information index to detect savefiles which were
+	 * modified behind our back. The default implementation only determines
+	 * the size, and sets the time to 0.
+	 *
+	 * @return true on success, false if the file could not be examined.
+	 */
+	virtual bool getSavefileStamp(const Common::FSNode &file, uint32 &size, uint32 &time);
+
+private:
+	struct PendingSave {
+		Common::String filename;
+		Common::String path;
+		Common::String tmpPath;
+		byte *data;
+		uint32 size;
+		uint32 pos;
+		Common::WriteStream *out;
+	};
+
+	typedef Common::List<PendingSave *> PendingSaveList;
+
+	enum {
+		/** Amount of uncompressed data written per timer invocation. */
+		kSaveSliceSize = 32 * 1024,
+		/** Interval of the background save timer (in microseconds). */
+		kSaveTimerInterval = 10 * 1000
+	};
+
+	struct SaveIndexEntry {
+		uint32 fileSize;
+		uint32 fileTime;
+		Common::StringMap metaInfo;
+	};
+
+	typedef Common::HashMap<Common::String, SaveIndexEntry> SaveIndex;
+
+	enum {
+		kSaveIndexVersion = 1
+	};
+
+	PendingSaveList _pendingSaves;
+	Common::Mutex _pendingMutex;
+	Common::String _pendingErrorDesc;
+
+	/** Guards _timerInstalled. Never locked by the timer proc. */
+	Common::Mutex _timerMutex;
+	bool _timerInstalled;
+
+	SaveIndex _index;
+	Common::String _indexTarget;
+	Common::String _indexSavePath;
+	bool _indexDirty;
+
+	/**
+	 * Make sure the index of the given target is loaded, writing out the
+	 * index of the previous target if necessary.
+	 * @return false if no index is available (e.g. no savepath).
+	 */
+	bool loadIndex(const Common::String &target);
+	void saveIndex();
+	void invalidateIndexEntry(const Common::String &filename);
+	Common::FSNode getIndexFile() const;
+
+	static void timerProc(void *refCon);
+
+	/**
+	 * Write all pending savefiles, without touching the timer.
+	 * @return the description of the last error, or an empty string
+	 */
+	Common::String writePendingSaves();
+
+	/**
+	 * Write up to maxBytes of the given pending save. Returns true once
+	 * the savefile has been completely written and committed (or failed).
+	 * Must be called with _pendingMutex held.
+	 */
+	bool processPendingSave(PendingSave *save, uint32 maxBytes);
+	void discardPendingSave(PendingSave *save);
 };
 
 #endif
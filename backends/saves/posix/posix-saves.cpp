@@ -127,6 +127,17 @@ void POSIXSaveFileManager::checkPath(const Common::FSNode &dir) {
 		}
 	}
 }
+
+bool POSIXSaveFileManager::getSavefileStamp(const Common::FSNode &file, uint32 &size, uint32 &time) {
+	struct stat sb;
+
+	if (stat(file.getPath().c_str(), &sb) != 0)
+		return false;
+
+	size = sb.st_size;
+	time = sb.st_mtime;
+	return true;
+}
 #endif
 
 #endif
@@ -31,9 +31,10 @@
 #if defined(UNIX)
 /**
  * Customization of the DefaultSaveFileManager for POSIX platforms.
- * The only two differences are that the default constructor sets
- * up the savepath based on HOME, and that checkPath tries to
- * create the savedir, if missing, via the mkdir() syscall.
+ * The differences are that the default constructor sets up the
+ * savepath based on HOME, that checkPath tries to create the
+ * savedir, if missing, via the mkdir() syscall, and that savefile
+ * stamps for the meta information index are obtained via stat().
  */
 class POSIXSaveFileManager : public DefaultSaveFileManager {
 public:
@@ -47,6 +48,12 @@ protected:
 	 * Sets the internal error and error message accordingly.
 	 */
 	virtual void checkPath(const Common::FSNode &dir);
+
+	/**
+	 * Determines size and modification time of a savefile via stat(),
+	 * without opening it.
+	 */
+	virtual bool getSavefileStamp(const Common::FSNode &file, uint32 &size, uint32 &time);
 };
 #endif
 
@@ -27,6 +27,7 @@
 #include "base/commandLine.h"
 #include "base/plugins.h"
 #include "base/version.h"
+#include "base/videobench.h"
 
 #include "common/config-manager.h"
 #include "common/system.h"
@@ -62,6 +63,9 @@ static const char HELP_STRING[] =
 	"  -z, --list-games         Display list of supported games and exit\n"
 	"  -t, --list-targets       Display list of configured targets and exit\n"
 	"  --list-saves=TARGET	    Display a list of savegames for the game (TARGET) specified\n"
+	"  --bench-video=PATH       Decode the video PATH (or all videos in the directory\n"
+	"                           PATH) as fast as possible, print the decoding speed\n"
+	"                           and exit\n"
 	"\n"
 	"  -c, --config=CONFIG      Use alternate configuration file\n"
 	"  -p, --path=PATH          Path to where the game is installed\n"
@@ -351,6 +355,10 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 				return "list-saves";
 			END_OPTION
 
+			DO_LONG_OPTION("bench-video")
+				return "bench-video";
+			END_OPTION
+
 			DO_OPTION('c', "config")
 			END_OPTION
 
@@ -877,6 +885,9 @@ bool processSettings(Common::String &command, Common::StringMap &settings) {
 	} else if (command == "list-themes") {
 		listThemes();
 		return false;
+	} else if (command == "bench-video") {
+		runVideoBenchmark(settings["bench-video"]);
+		return false;
 	} else if (command == "version") {
 		printf("%s\n", gScummVMFullVersion);
 		printf("Features compiled in: %s\n", gScummVMFeatures);
@@ -44,11 +44,14 @@
 #include "common/EventRecorder.h"
 #include "common/file.h"
 #include "common/fs.h"
+#include "common/internedstring.h"
 #include "common/system.h"
 
 #include "gui/GuiManager.h"
 #include "gui/message.h"
 
+#include "graphics/surfacepool.h"
+
 #include "sound/audiocd.h"
 
 #include "backends/keymapper/keymapper.h"
@@ -428,13 +431,22 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 		// playback read the FIXME in sound/audiocd.h
 		Audio::AudioCDManager::destroy();
 
+		// Free the video frame buffers the engine left in the surface pool
+		Graphics::SharedSurfacePool::destroy();
+
 		// reset the graphics to default
 		setupGraphics(system);
 		launcherDialog();
 	}
+
+	// Write out savefiles still pending in the background, while the
+	// timer manager is still around.
+	system.getSavefileManager()->flushPendingSaves();
+
 	PluginManager::instance().unloadPlugins();
 	PluginManager::destroy();
 	Common::ConfigManager::destroy();
+	Common::InternedString::freePool();
 	Common::SearchManager::destroy();
 	GUI::GuiManager::destroy();
 
@@ -0,0 +1,353 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#include "base/videobench.h"
+#include "base/plugins.h"
+
+#include "common/archive.h"
+#include "common/debug.h"
+#include "common/fs.h"
+#include "common/list.h"
+#include "common/system.h"
+
+#include "engines/metaengine.h"
+
+#include "graphics/dither.h"
+#include "graphics/surface.h"
+#include "graphics/surfacepool.h"
+#include "graphics/video/avi_decoder.h"
+#include "graphics/video/dxa_decoder.h"
+#include "graphics/video/flic_decoder.h"
+#include "graphics/video/smk_decoder.h"
+#include "graphics/video/video_benchmark.h"
+#include "graphics/video/coktelvideo/coktelvideo.h"
+
+#include "sound/audiostream.h"
+#include "sound/mixer.h"
+
+#if defined(UNIX)
+#include <sys/resource.h>
+#endif
+
+namespace Base {
+
+/**
+ * A mixer which never plays anything. The decoders queue their sound into
+ * it, so that it does not have to be decoded, and the benchmark does not
+ * need the mixer of the backend.
+ */
+class NullMixer : public Audio::Mixer {
+public:
+	~NullMixer() {
+		for (Common::List<Audio::AudioStream *>::iterator i = _streams.begin(); i != _streams.end(); ++i)
+			delete *i;
+	}
+
+	bool isReady() const { return true; }
+
+	void playInputStream(SoundType type, Audio::SoundHandle *handle, Audio::AudioStream *input,
+			int id, byte volume, int8 balance, DisposeAfterUse::Flag autofreeStream,
+			bool permanent, bool reverseStereo) {
+		// The stream is still used by the decoder, so it may only be freed
+		// after the decoder is gone
+		if (autofreeStream == DisposeAfterUse::YES)
+			_streams.push_back(input);
+	}
+
+	void stopAll() {}
+	void stopID(int id) {}
+	void stopHandle(Audio::SoundHandle handle) {}
+
+	void pauseAll(bool paused) {}
+	void pauseID(int id, bool paused) {}
+	void pauseHandle(Audio::SoundHandle handle, bool paused) {}
+
+	bool isSoundIDActive(int id) { return false; }
+	int getSoundID(Audio::SoundHandle handle) { return 0; }
+	bool isSoundHandleActive(Audio::SoundHandle handle) { return false; }
+
+	void setChannelVolume(Audio::SoundHandle handle, byte volume) {}
+	void setChannelBalance(Audio::SoundHandle handle, int8 balance) {}
+
+	uint32 getSoundElapsedTime(Audio::SoundHandle handle) { return 0; }
+	Audio::Timestamp getElapsedTime(Audio::SoundHandle handle) { return Audio::Timestamp(0, getOutputRate()); }
+
+	bool hasActiveChannelOfType(SoundType type) { return false; }
+
+	void setVolumeForSoundType(SoundType type, int volume) {}
+	int getVolumeForSoundType(SoundType type) const { return kMaxMixerVolume; }
+
+	uint getOutputRate() const { return 22050; }
+
+private:
+	Common::List<Audio::AudioStream *> _streams;
+};
+
+/** The extensions of the videos decoded here, without an engine. */
+static const char *const s_videoExtensions[] = {
+	".avi", ".dxa", ".flc", ".fli", ".imd", ".smk", ".vmd", 0
+};
+
+static bool isVideoFile(const Common::String &fileName) {
+	Common::String name = fileName;
+	name.toLowercase();
+
+	for (int i = 0; s_videoExtensions[i]; i++) {
+		if (name.hasSuffix(s_videoExtensions[i]))
+			return true;
+	}
+
+	return false;
+}
+
+static bool benchVideoDecoder(const Common::FSNode &node, Graphics::VideoDecoder &video) {
+	// The decoders open their files through SearchMan
+	SearchMan.addDirectory("videobench", node.getParent(), 100);
+	bool loaded = video.loadFile(node.getName().c_str());
+	SearchMan.remove("videobench");
+
+	if (!loaded)
+		return false;
+
+	int width = video.getWidth();
+	int height = video.getHeight();
+	int32 frameCount = video.getFrameCount();
+
+	byte *frame = new byte[width * height];
+
+	Graphics::VideoBenchmark bench(node.getPath());
+	bench.start();
+	for (int32 i = 0; i < frameCount; i++) {
+		video.decodeNextFrame();
+		video.copyFrameToBuffer(frame, 0, 0, width);
+		bench.addFrame(frame, width, width, height);
+	}
+	bench.stop();
+
+	bench.printResult(width, height);
+
+	delete[] frame;
+	video.closeFile();
+	return true;
+}
+
+#if defined(ENABLE_GOB) || defined(ENABLE_SCI32) || defined(DYNAMIC_MODULES)
+
+static bool benchCoktelVideo(const Common::String &fileName, Common::SeekableReadStream &stream, bool vmd) {
+	// Full color VMDs (i.e. Indeo 3 ones) are dithered to a palette. The
+	// engines use the game's palette, any palette will do for measuring.
+	byte palette[768];
+	for (int i = 0; i < 256; i++) {
+		byte r = ((i >> 5) & 7) * 255 / 7;
+		byte g = ((i >> 2) & 7) * 255 / 7;
+		byte b = ( i       & 3) * 255 / 3;
+
+		Graphics::PaletteLUT::RGB2YUV(r, g, b, palette[i * 3 + 0], palette[i * 3 + 1], palette[i * 3 + 2]);
+	}
+
+	Graphics::PaletteLUT palLUT(5, Graphics::PaletteLUT::kPaletteYUV);
+	palLUT.setPalette(palette, Graphics::PaletteLUT::kPaletteYUV, 8, 0);
+
+	// Not part of the decoding, so build the table beforehand
+	for (int i = 0; i < 32; i++)
+		palLUT.buildNext();
+
+	Graphics::CoktelVideo *video;
+	if (vmd)
+		video = new Graphics::Vmd(&palLUT);
+	else
+		video = new Graphics::Imd();
+
+	if (!video->load(stream)) {
+		delete video;
+		return false;
+	}
+
+	video->setVideoMemory();
+
+	uint16 width = video->getWidth();
+	uint16 height = video->getHeight();
+	uint16 frameCount = video->getFramesCount();
+
+	byte *frame = new byte[width * height];
+
+	Graphics::VideoBenchmark bench(fileName);
+	bench.start();
+	for (uint16 i = 0; i < frameCount; i++) {
+		video->nextFrame();
+		video->copyCurrentFrame(frame, 0, 0, width, height, 0, 0, width);
+		bench.addFrame(frame, width, width, height);
+	}
+	bench.stop();
+
+	bench.printResult(width, height);
+
+	delete[] frame;
+	delete video;
+	return true;
+}
+
+#endif
+
+/**
+ * Let the engines decode a video in a format of their own.
+ * @return kNoError if the video was decoded, kUnsupportedGameidError if no
+ *         engine knows its format
+ */
+static Common::Error benchEngineVideo(const Common::FSNode &node) {
+	const EnginePlugin::List &plugins = EngineMan.getPlugins();
+	for (EnginePlugin::List::const_iterator iter = plugins.begin(); iter != plugins.end(); ++iter) {
+		NullMixer mixer;
+		Common::Error result = (**iter)->benchVideo(node, &mixer);
+		if (result != Common::kUnsupportedGameidError)
+			return result;
+	}
+
+	return Common::kUnsupportedGameidError;
+}
+
+/**
+ * Decode a single video.
+ * @param quiet	don't complain if the video is in an unsupported format
+ * @return true if the video could be decoded, or was skipped because of
+ *         quiet, false otherwise
+ */
+static bool benchVideo(const Common::FSNode &node, bool quiet) {
+	Common::String fileName = node.getPath();
+
+	Common::String name = node.getName();
+	name.toLowercase();
+
+	// Some decoders stop their sound when they are deleted, so the mixer has
+	// to outlive them
+	NullMixer mixer;
+
+	Graphics::VideoDecoder *decoder = 0;
+	if (name.hasSuffix(".smk"))
+		decoder = new Graphics::SmackerDecoder(&mixer);
+	else if (name.hasSuffix(".dxa"))
+		decoder = new Graphics::DXADecoder();
+	else if (name.hasSuffix(".fli") || name.hasSuffix(".flc"))
+		decoder = new Graphics::FlicDecoder();
+	else if (name.hasSuffix(".avi"))
+		decoder = new Graphics::AviDecoder(&mixer);
+
+	bool supported = false;
+	bool result = false;
+
+	if (decoder) {
+		supported = true;
+		result = benchVideoDecoder(node, *decoder);
+		delete decoder;
+	}
+
+#if defined(ENABLE_GOB) || defined(ENABLE_SCI32) || defined(DYNAMIC_MODULES)
+	if (name.hasSuffix(".imd") || name.hasSuffix(".vmd")) {
+		Common::SeekableReadStream *stream = node.createReadStream();
+		if (!stream) {
+			printf("Can't open \"%s\"\n", fileName.c_str());
+			return false;
+		}
+
+		supported = true;
+		result = benchCoktelVideo(fileName, *stream, name.hasSuffix(".vmd"));
+		delete stream;
+	}
+#endif
+
+	if (!supported) {
+		Common::Error error = benchEngineVideo(node);
+		if (error == Common::kUnsupportedGameidError) {
+			if (!quiet)
+				printf("\"%s\": Unsupported video format\n", fileName.c_str());
+			return quiet;
+		}
+
+		result = (error == Common::kNoError);
+	}
+
+	if (!result)
+		printf("\"%s\": Failed to decode the video\n", fileName.c_str());
+
+	return result;
+}
+
+/**
+ * Return the peak memory usage of the process in KB, or 0 if unknown.
+ */
+static uint32 getPeakMemoryUsage() {
+#if defined(UNIX)
+	struct rusage usage;
+	if (!getrusage(RUSAGE_SELF, &usage)) {
+#ifdef MACOSX
+		return usage.ru_maxrss / 1024;
+#else
+		return usage.ru_maxrss;
+#endif
+	}
+#endif
+	return 0;
+}
+
+bool runVideoBenchmark(const Common::String &path) {
+	Common::FSNode node(path);
+	if (!node.exists()) {
+		printf("Can't open \"%s\"\n", path.c_str());
+		return false;
+	}
+
+	bool result = true;
+
+	if (node.isDirectory()) {
+		Common::FSList files;
+		if (!node.getChildren(files, Common::FSNode::kListFilesOnly)) {
+			printf("Can't list \"%s\"\n", path.c_str());
+			return false;
+		}
+
+		Common::sort(files.begin(), files.end());
+
+		for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
+			// Files of the engines' formats can't be told apart by their
+			// extension, so all other files are tried quietly
+			if (!benchVideo(*file, !isVideoFile(file->getName())))
+				result = false;
+		}
+	} else
+		result = benchVideo(node, false);
+
+	Graphics::SurfacePool::Statistics poolStats;
+	SurfacePoolMan.getStatistics(poolStats);
+	printf("Surface pool: %d of %d surfaces reused, %d discarded, up to %d KB retained\n",
+		poolStats.reused, poolStats.acquired, poolStats.discarded, poolStats.peakRetainedBytes / 1024);
+
+	uint32 peakMemory = getPeakMemoryUsage();
+	if (peakMemory)
+		printf("Peak memory usage: %d KB\n", peakMemory);
+
+	return result;
+}
+
+} // End of namespace Base
@@ -0,0 +1,56 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#ifndef BASE_VIDEOBENCH_H
+#define BASE_VIDEOBENCH_H
+
+#include "common/str.h"
+
+namespace Base {
+
+/**
+ * Decode all frames of a video as fast as possible, without showing them or
+ * playing the sound, and print the decoding speed, the time of the slowest
+ * batch of frames and a CRC of all frames. With debug level 1, the CRC of
+ * each frame and the decoding time of each batch are printed as well. The
+ * backend is not initialized, so this runs without any audio or video
+ * output. Meant for comparing the speed of
+ * the video decoders, and for checking that optimizations don't change
+ * their output.
+ *
+ * The type of the video is derived from the file name's extension.
+ * Supported are Smacker, DXA, FLIC, AVI, Coktel Vision IMD and VMD videos,
+ * and the formats of the engines implementing MetaEngine::benchVideo(),
+ * e.g. QuickTime videos through the Mohawk engine.
+ *
+ * @param path	the path of the video to decode, or of a directory whose
+ *		videos are all decoded
+ * @return true if all videos could be decoded
+ */
+bool runVideoBenchmark(const Common::String &path);
+
+} // End of namespace Base
+
+#endif
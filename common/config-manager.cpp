@@ -225,8 +225,8 @@ void ConfigManager::flushToDisk() {
 		} else if (kKeymapperDomain == *i) {
 			writeDomain(*stream, *i, _keymapperDomain);
 #endif
-		} else if (_gameDomains.contains(*i)) {
-			writeDomain(*stream, *i, _gameDomains[*i]);
+		} else if (findGameDomain(*i)) {
+			writeDomain(*stream, *i, *findGameDomain(*i));
 		}
 	}
 
@@ -308,10 +308,7 @@ const ConfigManager::Domain *ConfigManager::getDomain(const String &domName) con
 	if (domName == kKeymapperDomain)
 		return &_keymapperDomain;
 #endif
-	if (_gameDomains.contains(domName))
-		return &_gameDomains[domName];
-
-	return 0;
+	return findGameDomain(domName);
 }
 
 ConfigManager::Domain *ConfigManager::getDomain(const String &domName) {
@@ -326,10 +323,7 @@ ConfigManager::Domain *ConfigManager::getDomain(const String &domName) {
 	if (domName == kKeymapperDomain)
 		return &_keymapperDomain;
 #endif
-	if (_gameDomains.contains(domName))
-		return &_gameDomains[domName];
-
-	return 0;
+	return const_cast<Domain *>(findGameDomain(domName));
 }
 
 
@@ -607,7 +601,18 @@ void ConfigManager::renameGameDomain(const String &oldName, const String &newNam
 
 bool ConfigManager::hasGameDomain(const String &domName) const {
 	assert(!domName.empty());
-	return isValidDomainName(domName) && _gameDomains.contains(domName);
+	return isValidDomainName(domName) && findGameDomain(domName) != 0;
+}
+
+const ConfigManager::Domain *ConfigManager::findGameDomain(const String &domName) const {
+	// Look up the domain without interning its name: if no name equal to
+	// it ignoring case has been interned yet, it can't be a game domain.
+	InternedString name;
+	if (!InternedString::findIgnoreCase(domName, name))
+		return 0;
+
+	DomainMap::const_iterator i = _gameDomains.find(name);
+	return (i != _gameDomains.end()) ? &i->_value : 0;
 }
 
 
@@ -32,6 +32,7 @@
 #include "common/singleton.h"
 #include "common/str.h"
 #include "common/hash-str.h"
+#include "common/internedstring.h"
 
 namespace Common {
 
@@ -66,7 +67,7 @@ public:
 		bool hasKVComment(const String &key) const;
 	};
 
-	typedef HashMap<String, Domain, IgnoreCase_Hash, IgnoreCase_EqualTo> DomainMap;
+	typedef HashMap<InternedString, Domain, InternedString_IgnoreCase_Hash, InternedString_IgnoreCase_EqualTo> DomainMap;
 
 	/** The name of the application domain (normally 'scummvm'). */
 	static const char *kApplicationDomain;
@@ -148,6 +149,7 @@ private:
 	ConfigManager();
 
 	void			loadFromStream(SeekableReadStream &stream);
+	const Domain *	findGameDomain(const String &domName) const;
 	void			writeDomain(WriteStream &stream, const String &name, const Domain &domain);
 
 	Domain			_transientDomain;
@@ -0,0 +1,177 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#include "common/delta.h"
+#include "common/flathashmap.h"
+#include "common/stream.h"
+
+namespace Common {
+
+// A delta starts with the size of the data, followed by a list of
+// operations, each of which is a type byte and its arguments.
+enum {
+	kDeltaEnd = 0,
+	kDeltaCopy = 1,		///< Copy bytes from the base: offset, length (uint32LE)
+	kDeltaLiteral = 2	///< Literal bytes: length (uint32LE), followed by the bytes
+};
+
+enum {
+	kDeltaBlockSize = 64
+};
+
+typedef FlatHashMap<uint, uint32> DeltaBlockMap;
+
+// The rolling checksum of rsync, which can be moved along a buffer one byte
+// at a time. The two halves are only kept modulo 2^16 when combined.
+struct DeltaChecksum {
+	uint32 a, b;
+
+	void init(const byte *data) {
+		a = b = 0;
+		for (int i = 0; i < kDeltaBlockSize; i++) {
+			a += data[i];
+			b += (kDeltaBlockSize - i) * data[i];
+		}
+	}
+
+	void roll(byte out, byte in) {
+		a += in - out;
+		b += a - kDeltaBlockSize * out;
+	}
+
+	uint value() const {
+		return (a & 0xFFFF) | (b << 16);
+	}
+};
+
+static uint32 writeLiteral(const byte *data, uint32 size, WriteStream &out) {
+	if (!size)
+		return 0;
+	out.writeByte(kDeltaLiteral);
+	out.writeUint32LE(size);
+	out.write(data, size);
+	return 5 + size;
+}
+
+uint32 encodeDelta(const byte *base, uint32 baseSize, const byte *data, uint32 dataSize, WriteStream &out) {
+	DeltaBlockMap blocks;
+	DeltaChecksum sum;
+	uint32 written = 4;
+	uint32 pos = 0, literalStart = 0;
+	bool haveSum = false;
+
+	out.writeUint32LE(dataSize);
+
+	// Index the blocks of the base, keeping the first one for each checksum
+	for (uint32 offs = 0; offs + kDeltaBlockSize <= baseSize; offs += kDeltaBlockSize) {
+		sum.init(base + offs);
+		if (!blocks.contains(sum.value()))
+			blocks[sum.value()] = offs;
+	}
+
+	while (!blocks.empty() && pos + kDeltaBlockSize <= dataSize) {
+		if (!haveSum) {
+			sum.init(data + pos);
+			haveSum = true;
+		}
+
+		DeltaBlockMap::const_iterator block = blocks.find(sum.value());
+		if (block != blocks.end() && !memcmp(base + block->_value, data + pos, kDeltaBlockSize)) {
+			uint32 start = pos;
+			uint32 baseStart = block->_value;
+			uint32 end = pos + kDeltaBlockSize;
+
+			// Grow the match in both directions, but not into earlier matches
+			while (start > literalStart && baseStart > 0 && data[start - 1] == base[baseStart - 1]) {
+				start--;
+				baseStart--;
+			}
+			while (end < dataSize && baseStart + (end - start) < baseSize && data[end] == base[baseStart + (end - start)])
+				end++;
+
+			written += writeLiteral(data + literalStart, start - literalStart, out);
+			out.writeByte(kDeltaCopy);
+			out.writeUint32LE(baseStart);
+			out.writeUint32LE(end - start);
+			written += 9;
+
+			pos = literalStart = end;
+			haveSum = false;
+		} else if (pos + kDeltaBlockSize < dataSize) {
+			sum.roll(data[pos], data[pos + kDeltaBlockSize]);
+			pos++;
+		} else {
+			break;
+		}
+	}
+
+	written += writeLiteral(data + literalStart, dataSize - literalStart, out);
+	out.writeByte(kDeltaEnd);
+	return written + 1;
+}
+
+byte *decodeDelta(const byte *base, uint32 baseSize, ReadStream &delta, uint32 &dataSize) {
+	dataSize = delta.readUint32LE();
+	if (delta.err() || delta.eos())
+		return 0;
+
+	byte *data = (byte *)malloc(dataSize ? dataSize : 1);
+	if (!data)
+		return 0;
+
+	uint32 pos = 0;
+	for (;;) {
+		const byte type = delta.readByte();
+		if (delta.err() || delta.eos())
+			break;
+
+		if (type == kDeltaEnd) {
+			if (pos == dataSize)
+				return data;
+			break;
+		}
+
+		if (type == kDeltaCopy) {
+			const uint32 offs = delta.readUint32LE();
+			const uint32 size = delta.readUint32LE();
+			if (offs > baseSize || size > baseSize - offs || size > dataSize - pos)
+				break;
+			memcpy(data + pos, base + offs, size);
+			pos += size;
+		} else if (type == kDeltaLiteral) {
+			const uint32 size = delta.readUint32LE();
+			if (size > dataSize - pos || delta.read(data + pos, size) != size)
+				break;
+			pos += size;
+		} else {
+			break;
+		}
+	}
+
+	free(data);
+	return 0;
+}
+
+}	// End of namespace Common
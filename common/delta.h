@@ -0,0 +1,62 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#ifndef COMMON_DELTA_H
+#define COMMON_DELTA_H
+
+#include "common/scummsys.h"
+
+namespace Common {
+
+class ReadStream;
+class WriteStream;
+
+/**
+ * Write a delta to the given stream, which turns the base buffer into the
+ * data buffer when passed to decodeDelta().
+ *
+ * The delta consists of references to runs of bytes of the base buffer
+ * and of literal bytes which do not occur there. Matching runs are found
+ * at any offset (using a rolling checksum over blocks of the base buffer,
+ * like rsync does), so data which merely moved, e.g. because something
+ * grew in front of it, is still encoded as a reference.
+ *
+ * @return the number of bytes written to the stream
+ */
+uint32 encodeDelta(const byte *base, uint32 baseSize, const byte *data, uint32 dataSize, WriteStream &out);
+
+/**
+ * Rebuild a buffer from its base buffer and a delta written by
+ * encodeDelta().
+ *
+ * @param dataSize	receives the size of the rebuilt buffer
+ * @return the rebuilt buffer, which the caller must free(), or 0 if the
+ *         delta is corrupt or refers to data beyond the base buffer
+ */
+byte *decodeDelta(const byte *base, uint32 baseSize, ReadStream &delta, uint32 &dataSize);
+
+}	// End of namespace Common
+
+#endif
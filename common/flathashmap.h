@@ -0,0 +1,540 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+// The hash map implementation in this file uses open addressing with
+// linear probing and "robin hood" displacement: on insertion, elements
+// which are closer to their home slot make room for those which are
+// further away. Erased elements are not replaced by dummy markers, instead
+// the following elements are shifted back by one slot ("backward shift
+// deletion"), so lookups never have to skip over deleted entries.
+
+#ifndef COMMON_FLATHASHMAP_H
+#define COMMON_FLATHASHMAP_H
+
+#include "common/func.h"
+#include "common/str.h"
+#include "common/util.h"
+
+#include <new>
+
+namespace Common {
+
+/**
+ * FlatHashMap<Key,Val> is an alternative to HashMap<Key,Val> which stores
+ * keys and values directly inside its table, instead of allocating a node
+ * for each entry. This avoids one cache miss per probed entry and makes
+ * iterating over the map a linear walk through memory. It is meant for
+ * hot paths with small keys and values, e.g. integer or reg_t keys.
+ *
+ * The interface mirrors that of HashMap, with one important difference:
+ * since entries are moved around inside the table, any insertion (via
+ * operator[], getVal or setVal) and any erase() invalidates references
+ * to values and all iterators. Only keep references while not modifying
+ * the map.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	struct Node {
+		Key _key;
+		Val _value;
+		explicit Node(const Key &key) : _key(key), _value() {}
+		Node(const Node &node) : _key(node._key), _value(node._value) {}
+	};
+
+private:
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> HM_t;
+
+	enum {
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// The quotient of the next two constants controls how much the
+		// table may fill up before being enlarged. Robin hood hashing keeps
+		// the probe sequences short even at high load factors.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 3,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 4,
+
+		// If an insertion would move an element further than this from
+		// its home slot, the table is enlarged instead.
+		FLATHASHMAP_MAX_DISTANCE = 255
+	};
+
+	/**
+	 * A slot of the table. The probe distance is kept next to the node, so
+	 * that a lookup usually touches a single cache line per probed slot.
+	 */
+	struct Slot {
+		uint _dist;	///< Probe distance plus one; zero for empty slots
+		Node _node;	///< Only constructed if _dist is non-zero
+	};
+
+	Slot *_storage;	///< Table of size _mask + 1
+	uint _mask;		///< Capacity of the map minus one; capacity is a power of two
+	uint _shift;	///< 32 minus log2 of the capacity, see homeSlot()
+	uint _size;
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	/** Default value, returned by the const getVal. */
+	const Val _defaultVal;
+
+	/**
+	 * Map a hash value to its home slot. Many of our hash functions (e.g.
+	 * the ones for integers) produce clustered values, which linear probing
+	 * does not cope well with. Hence the hash is scrambled via Fibonacci
+	 * hashing, using the top bits of the product.
+	 */
+	uint homeSlot(uint hash) const {
+		return (uint)((hash * 2654435769U) & 0xFFFFFFFF) >> _shift;
+	}
+
+	void allocStorage(uint capacity);
+	void freeStorage();
+	void assign(const HM_t &map);
+	int lookup(const Key &key) const;
+	int lookupAndCreateIfMissing(const Key &key);
+	int insertNew(const Key &key);
+	void expandStorage(uint newCapacity);
+
+	/**
+	 * Simple FlatHashMap iterator implementation.
+	 */
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		uint _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(uint idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != 0);
+			assert(_idx <= _hashmap->_mask);
+			assert(_hashmap->_storage[_idx]._dist != 0);
+			return &_hashmap->_storage[_idx]._node;
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(0) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			do {
+				_idx++;
+			} while (_idx <= _hashmap->_mask && _hashmap->_storage[_idx]._dist == 0);
+			if (_idx > _hashmap->_mask)
+				_idx = (uint)-1;
+
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const HM_t &map);
+	~FlatHashMap();
+
+	HM_t &operator=(const HM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		freeStorage();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getVal(const Key &key, const Val &defaultVal) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(const Key &key);
+
+	uint size() const { return _size; }
+
+	iterator	begin() {
+		// Find and return the first non-empty entry
+		for (uint ctr = 0; ctr <= _mask; ++ctr) {
+			if (_storage[ctr]._dist)
+				return iterator(ctr, this);
+		}
+		return end();
+	}
+	iterator	end() {
+		return iterator((uint)-1, this);
+	}
+
+	const_iterator	begin() const {
+		// Find and return the first non-empty entry
+		for (uint ctr = 0; ctr <= _mask; ++ctr) {
+			if (_storage[ctr]._dist)
+				return const_iterator(ctr, this);
+		}
+		return end();
+	}
+	const_iterator	end() const {
+		return const_iterator((uint)-1, this);
+	}
+
+	iterator	find(const Key &key) {
+		int ctr = lookup(key);
+		if (ctr >= 0)
+			return iterator(ctr, this);
+		return end();
+	}
+
+	const_iterator	find(const Key &key) const {
+		int ctr = lookup(key);
+		if (ctr >= 0)
+			return const_iterator(ctr, this);
+		return end();
+	}
+
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY);
+}
+
+/**
+ * Copy constructor, creates a full copy of the given hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const HM_t &map) : _defaultVal() {
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	freeStorage();
+}
+
+/**
+ * Internal method for allocating an empty table of the given capacity,
+ * which must be a power of two.
+ *
+ * @note We do *not* deallocate the previous storage here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::allocStorage(uint capacity) {
+	assert(capacity >= FLATHASHMAP_MIN_CAPACITY && (capacity & (capacity - 1)) == 0);
+
+	_mask = capacity - 1;
+	_shift = 32;
+	while (capacity > 1) {
+		capacity >>= 1;
+		_shift--;
+	}
+
+	// The nodes are constructed on demand via placement new
+	_storage = (Slot *)malloc((_mask + 1) * sizeof(Slot));
+	assert(_storage != NULL);
+	for (uint ctr = 0; ctr <= _mask; ++ctr)
+		_storage[ctr]._dist = 0;
+
+	_size = 0;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::freeStorage() {
+	for (uint ctr = 0; ctr <= _mask; ++ctr) {
+		if (_storage[ctr]._dist)
+			_storage[ctr]._node.~Node();
+	}
+
+	free(_storage);
+	_storage = 0;
+	_size = 0;
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one.
+ *
+ * @note We do *not* deallocate the previous storage here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const HM_t &map) {
+	allocStorage(map._mask + 1);
+
+	// Since both tables have the same layout, simply copy slot by slot.
+	for (uint ctr = 0; ctr <= _mask; ++ctr) {
+		if (map._storage[ctr]._dist) {
+			new ((void *)&_storage[ctr]._node) Node(map._storage[ctr]._node);
+			_storage[ctr]._dist = map._storage[ctr]._dist;
+			_size++;
+		}
+	}
+	assert(_size == map._size);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	if (shrinkArray && _mask >= FLATHASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+		return;
+	}
+
+	for (uint ctr = 0; ctr <= _mask; ++ctr) {
+		if (_storage[ctr]._dist) {
+			_storage[ctr]._node.~Node();
+			_storage[ctr]._dist = 0;
+		}
+	}
+
+	_size = 0;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::expandStorage(uint newCapacity) {
+	assert(newCapacity > _mask + 1);
+
+	const uint oldSize = _size;
+	const uint oldMask = _mask;
+	Slot *oldStorage = _storage;
+
+	allocStorage(newCapacity);
+
+	// Rehash all the old elements
+	for (uint ctr = 0; ctr <= oldMask; ++ctr) {
+		if (!oldStorage[ctr]._dist)
+			continue;
+
+		int idx = insertNew(oldStorage[ctr]._node._key);
+		assert(idx >= 0);
+		_storage[idx]._node._value = oldStorage[ctr]._node._value;
+		oldStorage[ctr]._node.~Node();
+	}
+
+	// Perform a sanity check: Old number of elements should match the new one!
+	// This check will fail if some previous operation corrupted this hashmap.
+	assert(_size == oldSize);
+
+	free(oldStorage);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+int FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	uint ctr = homeSlot(_hash(key));
+	for (uint dist = 1; ; ++dist) {
+		// An empty slot, or an element closer to its home slot than we are
+		// to ours, means the key cannot be in the table: the robin hood
+		// invariant would have placed it here otherwise.
+		if (_storage[ctr]._dist < dist)
+			return -1;
+		if (_storage[ctr]._dist == dist && _equal(_storage[ctr]._node._key, key))
+			return ctr;
+		ctr = (ctr + 1) & _mask;
+	}
+}
+
+/**
+ * Internal method for inserting a key which is known not to be contained
+ * in the map yet. Returns the slot the new node was placed in, or -1 if the
+ * table has to be enlarged first.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+int FlatHashMap<Key, Val, HashFunc, EqualFunc>::insertNew(const Key &key) {
+	uint pos = homeSlot(_hash(key));
+	uint dist = 1;
+
+	// Skip all elements which are at least as far away from their home
+	// slot as we are; the first one closer to home is displaced.
+	while (_storage[pos]._dist >= dist) {
+		if (++dist >= FLATHASHMAP_MAX_DISTANCE)
+			return -1;
+		pos = (pos + 1) & _mask;
+	}
+
+	if (_storage[pos]._dist == 0) {
+		new ((void *)&_storage[pos]._node) Node(key);
+		_storage[pos]._dist = dist;
+		_size++;
+		return pos;
+	}
+
+	// Find the end of the cluster, making sure no probe distance overflows
+	// when all elements in between are moved one slot further.
+	uint end = pos;
+	while (_storage[end]._dist) {
+		if (_storage[end]._dist + 1 >= FLATHASHMAP_MAX_DISTANCE)
+			return -1;
+		end = (end + 1) & _mask;
+	}
+
+	// Shift the elements in [pos, end) by one slot. This keeps them ordered
+	// by probe distance, so the robin hood invariant still holds afterwards.
+	uint prev = (end - 1) & _mask;
+	new ((void *)&_storage[end]._node) Node(_storage[prev]._node);
+	_storage[end]._dist = _storage[prev]._dist + 1;
+	for (end = prev; end != pos; end = prev) {
+		prev = (end - 1) & _mask;
+		_storage[end]._node = _storage[prev]._node;
+		_storage[end]._dist = _storage[prev]._dist + 1;
+	}
+
+	_storage[pos]._node._key = key;
+	_storage[pos]._node._value = Val();
+	_storage[pos]._dist = dist;
+	_size++;
+	return pos;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+int FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	int ctr = lookup(key);
+	if (ctr >= 0)
+		return ctr;
+
+	// Keep the load factor below a certain threshold.
+	uint capacity = _mask + 1;
+	if ((_size + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+		capacity = capacity < 500 ? (capacity * 4) : (capacity * 2);
+		expandStorage(capacity);
+	}
+
+	while ((ctr = insertNew(key)) < 0) {
+		// Some probe sequence got too long, which only happens with
+		// very poor hash functions. Just enlarge the table.
+		expandStorage((_mask + 1) * 2);
+	}
+
+	return ctr;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return lookup(key) >= 0;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getVal(key);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	int ctr = lookupAndCreateIfMissing(key);
+	return _storage[ctr]._node._value;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	return getVal(key, _defaultVal);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key, const Val &defaultVal) const {
+	int ctr = lookup(key);
+	if (ctr >= 0)
+		return _storage[ctr]._node._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	int ctr = lookupAndCreateIfMissing(key);
+	_storage[ctr]._node._value = val;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	int ctr = lookup(key);
+	if (ctr < 0)
+		return;
+
+	// Shift all following elements of the cluster back by one slot, until
+	// we hit an empty slot or an element which already is in its home slot.
+	uint cur = ctr;
+	uint next = (cur + 1) & _mask;
+	while (_storage[next]._dist > 1) {
+		_storage[cur]._node = _storage[next]._node;
+		_storage[cur]._dist = _storage[next]._dist - 1;
+		cur = next;
+		next = (next + 1) & _mask;
+	}
+
+	_storage[cur]._node.~Node();
+	_storage[cur]._dist = 0;
+	_size--;
+}
+
+}	// End of namespace Common
+
+#endif
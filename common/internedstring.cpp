@@ -0,0 +1,156 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#include "common/internedstring.h"
+#include "common/hash-str.h"
+
+namespace Common {
+
+struct InternedString::Entry {
+	String _str;
+	uint _hash;
+	const Entry *_lowercase;	///< the entry of the lowercase form, may be this very entry
+};
+
+typedef HashMap<String, InternedString::Entry *> InternedStringPool;
+
+static InternedStringPool *g_internedStringPool = 0;
+static const InternedString::Entry *g_emptyInternedString = 0;
+
+// The pool may only be used by the main thread, see InternedString. This
+// flag catches (some) violations of that rule.
+static bool g_internedStringPoolBusy = false;
+
+class InternedStringPoolGuard {
+public:
+	InternedStringPoolGuard() {
+		assert(!g_internedStringPoolBusy);
+		g_internedStringPoolBusy = true;
+	}
+	~InternedStringPoolGuard() { g_internedStringPoolBusy = false; }
+};
+
+static const InternedString::Entry *findEntry(const String &str) {
+	if (!g_internedStringPool)
+		return 0;
+	return g_internedStringPool->getVal(str, 0);
+}
+
+static const InternedString::Entry *addEntry(const String &str) {
+	const InternedString::Entry *entry = findEntry(str);
+	if (entry)
+		return entry;
+
+	if (!g_internedStringPool)
+		g_internedStringPool = new InternedStringPool();
+
+	InternedString::Entry *newEntry = new InternedString::Entry();
+	newEntry->_str = str;
+	newEntry->_hash = hashit(str);
+
+	String lowercase(str);
+	lowercase.toLowercase();
+	if (lowercase == str)
+		newEntry->_lowercase = newEntry;
+	else
+		newEntry->_lowercase = addEntry(lowercase);
+
+	(*g_internedStringPool)[str] = newEntry;
+	return newEntry;
+}
+
+static const InternedString::Entry *internEntry(const String &str) {
+	InternedStringPoolGuard guard;
+	return addEntry(str);
+}
+
+InternedString::InternedString() {
+	if (!g_emptyInternedString)
+		g_emptyInternedString = internEntry(String());
+	_entry = g_emptyInternedString;
+}
+
+InternedString::InternedString(const char *str)
+	: _entry(internEntry(str)) {
+}
+
+InternedString::InternedString(const String &str)
+	: _entry(internEntry(str)) {
+}
+
+const String &InternedString::str() const {
+	return _entry->_str;
+}
+
+bool InternedString::equalsIgnoreCase(const InternedString &x) const {
+	return _entry->_lowercase == x._entry->_lowercase;
+}
+
+InternedString InternedString::toLowercase() const {
+	return InternedString(_entry->_lowercase);
+}
+
+uint InternedString::hash() const {
+	return _entry->_hash;
+}
+
+uint InternedString::hashIgnoreCase() const {
+	return _entry->_lowercase->_hash;
+}
+
+bool InternedString::find(const String &str, InternedString &result) {
+	InternedStringPoolGuard guard;
+	const Entry *entry = findEntry(str);
+	if (!entry)
+		return false;
+	result._entry = entry;
+	return true;
+}
+
+bool InternedString::findIgnoreCase(const String &str, InternedString &result) {
+	String lowercase(str);
+	lowercase.toLowercase();
+	return find(lowercase, result);
+}
+
+uint InternedString::getPoolSize() {
+	return g_internedStringPool ? g_internedStringPool->size() : 0;
+}
+
+void InternedString::freePool() {
+	InternedStringPoolGuard guard;
+
+	if (!g_internedStringPool)
+		return;
+
+	for (InternedStringPool::iterator i = g_internedStringPool->begin(); i != g_internedStringPool->end(); ++i)
+		delete i->_value;
+
+	delete g_internedStringPool;
+	g_internedStringPool = 0;
+	g_emptyInternedString = 0;
+}
+
+}	// End of namespace Common
@@ -0,0 +1,133 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#ifndef COMMON_INTERNEDSTRING_H
+#define COMMON_INTERNEDSTRING_H
+
+#include "common/str.h"
+
+namespace Common {
+
+/**
+ * An immutable string, of which only one copy with any given content
+ * exists. Interned strings are thus cheap to copy and to compare (a
+ * single pointer comparison), and both their hash value and that of
+ * their lowercase form are computed only once. This makes them well
+ * suited as keys of hash maps which are queried often, see the
+ * InternedString_Hash and InternedString_IgnoreCase_Hash functors.
+ *
+ * The pool of interned strings only grows until it is freed with
+ * freePool() at shutdown, so only a bounded set of strings (like the
+ * names of the config domains) should be interned. Strings which are
+ * only needed temporarily, or which come from the file system, should
+ * not be interned; use find() or findIgnoreCase() to look up strings
+ * without adding them to the pool.
+ *
+ * The pool is not guarded by a mutex, so interned strings may only be
+ * created and looked up by the main thread. Concurrent use of the pool
+ * triggers an assertion.
+ */
+class InternedString {
+public:
+	struct Entry;
+
+	/** Construct an empty interned string. */
+	InternedString();
+
+	InternedString(const char *str);
+	InternedString(const String &str);
+
+	const String &str() const;
+	operator const String &() const { return str(); }
+
+	const char *c_str() const { return str().c_str(); }
+	uint size() const { return str().size(); }
+	bool empty() const { return str().empty(); }
+
+	bool operator==(const InternedString &x) const { return _entry == x._entry; }
+	bool operator!=(const InternedString &x) const { return _entry != x._entry; }
+
+	/** Compare two interned strings, ignoring case. */
+	bool equalsIgnoreCase(const InternedString &x) const;
+
+	/** Return the interned lowercase form of this string. */
+	InternedString toLowercase() const;
+
+	/** Return the (precomputed) case sensitive hash of this string. */
+	uint hash() const;
+
+	/** Return the (precomputed) hash of the lowercase form of this string. */
+	uint hashIgnoreCase() const;
+
+	/**
+	 * Look up the interned version of the given string, without
+	 * interning it if it does not exist yet.
+	 * @return true if the string was found
+	 */
+	static bool find(const String &str, InternedString &result);
+
+	/**
+	 * Look up the interned lowercase form of the given string, without
+	 * interning it. If it does not exist, no interned string equals the
+	 * given one ignoring case, so this is a quick way to determine that
+	 * a string is not contained in a map with interned keys.
+	 * @return true if the string was found
+	 */
+	static bool findIgnoreCase(const String &str, InternedString &result);
+
+	/** Return the number of strings interned so far. */
+	static uint getPoolSize();
+
+	/**
+	 * Free the pool and all interned strings. Called at shutdown; no
+	 * interned string may be used after this.
+	 */
+	static void freePool();
+
+private:
+	explicit InternedString(const Entry *entry) : _entry(entry) {}
+
+	const Entry *_entry;
+};
+
+struct InternedString_EqualTo {
+	bool operator()(const InternedString &x, const InternedString &y) const { return x == y; }
+};
+
+struct InternedString_Hash {
+	uint operator()(const InternedString &x) const { return x.hash(); }
+};
+
+struct InternedString_IgnoreCase_EqualTo {
+	bool operator()(const InternedString &x, const InternedString &y) const { return x.equalsIgnoreCase(y); }
+};
+
+struct InternedString_IgnoreCase_Hash {
+	uint operator()(const InternedString &x) const { return x.hashIgnoreCase(); }
+};
+
+}	// End of namespace Common
+
+#endif
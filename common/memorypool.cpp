@@ -49,6 +49,7 @@ MemoryPool::MemoryPool(size_t chunkSize)
 	_next = NULL;
 
 	_chunksPerPage = INITIAL_CHUNKS_PER_PAGE;
+	_usedChunks = 0;
 }
 
 MemoryPool::~MemoryPool() {
@@ -71,7 +72,12 @@ void MemoryPool::allocPage() {
 
 	page.start = ::malloc(page.numChunks * _chunkSize);
 	assert(page.start);
-	_pages.push_back(page);
+
+	// Keep the pages sorted by address, so findPage() can do a binary search
+	uint pos = _pages.size();
+	while (pos > 0 && _pages[pos - 1].start > page.start)
+		--pos;
+	_pages.insert_at(pos, page);
 
 
 	// Next time, we'll allocate a page twice as big as this one.
@@ -106,6 +112,7 @@ void *MemoryPool::allocChunk() {
 	assert(_next);
 	void *result = _next;
 	_next = *(void**)result;
+	++_usedChunks;
 	return result;
 }
 
@@ -113,6 +120,14 @@ void MemoryPool::freeChunk(void *ptr) {
 	// Add the chunk back to (the start of) the list of free chunks
 	*(void**)ptr = _next;
 	_next = ptr;
+	--_usedChunks;
+}
+
+size_t MemoryPool::getNumPageChunks() const {
+	size_t numChunks = 0;
+	for (size_t i = 0; i < _pages.size(); ++i)
+		numChunks += _pages[i].numChunks;
+	return numChunks;
 }
 
 // Technically not compliant C++ to compare unrelated pointers. In practice...
@@ -120,8 +135,23 @@ bool MemoryPool::isPointerInPage(void *ptr, const Page &page) {
 	return (ptr >= page.start) && (ptr < (char*)page.start + page.numChunks * _chunkSize);
 }
 
+int MemoryPool::findPage(void *ptr) {
+	// Binary search for the last page starting at or before ptr
+	int lo = 0, hi = (int)_pages.size() - 1;
+	while (lo <= hi) {
+		int mid = (lo + hi) / 2;
+		if (ptr < _pages[mid].start)
+			hi = mid - 1;
+		else
+			lo = mid + 1;
+	}
+
+	if (hi >= 0 && isPointerInPage(ptr, _pages[hi]))
+		return hi;
+	return -1;
+}
+
 void MemoryPool::freeUnusedPages() {
-	//std::sort(_pages.begin(), _pages.end());
 	Array<size_t> numberOfFreeChunksPerPage;
 	numberOfFreeChunksPerPage.resize(_pages.size());
 	for (size_t i = 0; i < numberOfFreeChunksPerPage.size(); ++i) {
@@ -131,28 +161,27 @@ void MemoryPool::freeUnusedPages() {
 	// Compute for each page how many chunks in it are still in use.
 	void *iterator = _next;
 	while (iterator) {
-		// TODO: This should be a binary search (requiring us to keep _pages sorted)
-		for (size_t i = 0; i < _pages.size(); ++i) {
-			if (isPointerInPage(iterator, _pages[i])) {
-				++numberOfFreeChunksPerPage[i];
-				break;
-			}
-		}
+		int page = findPage(iterator);
+		if (page >= 0)
+			++numberOfFreeChunksPerPage[page];
 		iterator = *(void**)iterator;
 	}
 
+	// Remove all chunks of pages which are not in use from the list of
+	// free chunks, in a single pass over the list.
+	void **iter2 = &_next;
+	while (*iter2) {
+		int page = findPage(*iter2);
+		if (page >= 0 && numberOfFreeChunksPerPage[page] == _pages[page].numChunks)
+			*iter2 = **(void***)iter2;
+		else
+			iter2 = *(void***)iter2;
+	}
+
 	// Free all pages which are not in use.
 	size_t freedPagesCount = 0;
 	for (size_t i = 0; i < _pages.size(); ++i)  {
 		if (numberOfFreeChunksPerPage[i] == _pages[i].numChunks) {
-			// Remove all chunks of this page from the list of free chunks
-			void **iter2 = &_next;
-			while (*iter2) {
-				if (isPointerInPage(*iter2, _pages[i]))
-					*iter2 = **(void***)iter2;
-				else
-					iter2 = *(void***)iter2;
-			}
 			::free(_pages[i].start);
 			++freedPagesCount;
 			_pages[i].start = NULL;
@@ -180,4 +209,122 @@ void MemoryPool::freeUnusedPages() {
 	}
 }
 
+
+#pragma mark -
+
+
+// The chunk sizes of all size classes. The steps get coarser for bigger
+// sizes, so that no more than a fifth of a chunk is ever wasted (except
+// for the smallest ones).
+static const uint16 s_sizeClassChunkSizes[SizeClassMemoryPool::kNumSizeClasses] = {
+	8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256
+};
+
+// Maps a request size, divided by kGranularity and rounded up, to its
+// size class.
+static const byte s_sizeClassForSize[SizeClassMemoryPool::kMaxChunkSize / SizeClassMemoryPool::kGranularity + 1] = {
+	0, 0, 1, 2, 3, 4, 5, 6, 7,				// 0 - 64
+	8, 8, 9, 9, 10, 10, 11, 11,				// 72 - 128
+	12, 12, 12, 12, 13, 13, 13, 13,			// 136 - 192
+	14, 14, 14, 14, 15, 15, 15, 15			// 200 - 256
+};
+
+SizeClassMemoryPool::SizeClassMemoryPool()
+	: _allocCount(0), _freeCount(0), _mallocCount(0) {
+	for (int i = 0; i < kNumSizeClasses; ++i)
+		_pools[i] = new MemoryPool(s_sizeClassChunkSizes[i]);
+}
+
+SizeClassMemoryPool::~SizeClassMemoryPool() {
+	for (int i = 0; i < kNumSizeClasses; ++i)
+		delete _pools[i];
+}
+
+int SizeClassMemoryPool::getSizeClass(size_t size) {
+	if (size > kMaxChunkSize)
+		return -1;
+	return s_sizeClassForSize[(size + kGranularity - 1) / kGranularity];
+}
+
+size_t SizeClassMemoryPool::getSizeClassChunkSize(size_t size) {
+	int sizeClass = getSizeClass(size);
+	return (sizeClass >= 0) ? s_sizeClassChunkSizes[sizeClass] : 0;
+}
+
+void *SizeClassMemoryPool::allocChunk(size_t size) {
+	++_allocCount;
+
+	int sizeClass = getSizeClass(size);
+	if (sizeClass < 0) {
+		++_mallocCount;
+		void *ptr = ::malloc(size);
+		assert(ptr);
+		return ptr;
+	}
+
+	MemoryPool *pool = _pools[sizeClass];
+	size_t numPages = pool->getNumPages();
+	void *ptr = pool->allocChunk();
+	if (pool->getNumPages() != numPages)
+		++_mallocCount;
+	return ptr;
+}
+
+void SizeClassMemoryPool::freeChunk(void *ptr, size_t size) {
+	++_freeCount;
+
+	int sizeClass = getSizeClass(size);
+	if (sizeClass < 0)
+		::free(ptr);
+	else
+		_pools[sizeClass]->freeChunk(ptr);
+}
+
+void SizeClassMemoryPool::freeUnusedPages() {
+	for (int i = 0; i < kNumSizeClasses; ++i)
+		_pools[i]->freeUnusedPages();
+}
+
+void SizeClassMemoryPool::getStats(Stats &stats) const {
+	stats.allocCount = _allocCount;
+	stats.freeCount = _freeCount;
+	stats.mallocCount = _mallocCount;
+	stats.usedChunks = 0;
+	stats.usedBytes = 0;
+	stats.reservedBytes = 0;
+
+	for (int i = 0; i < kNumSizeClasses; ++i) {
+		const MemoryPool *pool = _pools[i];
+		stats.usedChunks += pool->getUsedChunks();
+		stats.usedBytes += pool->getUsedChunks() * pool->getChunkSize();
+		stats.reservedBytes += pool->getNumPageChunks() * pool->getChunkSize();
+	}
+}
+
+
+#pragma mark -
+
+
+void *SharedMemoryPool::allocChunk(size_t size) {
+	StackLock lock(_mutex);
+	return _pool.allocChunk(size);
+}
+
+void SharedMemoryPool::freeChunk(void *ptr, size_t size) {
+	StackLock lock(_mutex);
+	_pool.freeChunk(ptr, size);
+}
+
+void SharedMemoryPool::freeUnusedPages() {
+	StackLock lock(_mutex);
+	_pool.freeUnusedPages();
+}
+
+void SharedMemoryPool::getStats(SizeClassMemoryPool::Stats &stats) {
+	StackLock lock(_mutex);
+	_pool.getStats(stats);
+}
+
 }	// End of namespace Common
+
+DECLARE_SINGLETON(Common::SharedMemoryPool);
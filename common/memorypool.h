@@ -28,6 +28,8 @@
 
 #include "common/scummsys.h"
 #include "common/array.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
 
 
 namespace Common {
@@ -53,13 +55,15 @@ protected:
 	};
 
 	const size_t	_chunkSize;
-	Array<Page>		_pages;
+	Array<Page>		_pages;	///< pages allocated via malloc, sorted by address
 	void			*_next;
 	size_t			_chunksPerPage;
+	size_t			_usedChunks;
 
 	void	allocPage();
 	void	addPageToPool(const Page &page);
 	bool	isPointerInPage(void *ptr, const Page &page);
+	int		findPage(void *ptr);
 
 public:
 	/**
@@ -97,6 +101,23 @@ public:
 	 * Return the chunk size used by this memory pool.
 	 */
 	size_t	getChunkSize() const { return _chunkSize; }
+
+	/**
+	 * Return the number of chunks currently handed out by this pool.
+	 */
+	size_t	getUsedChunks() const { return _usedChunks; }
+
+	/**
+	 * Return the number of pages this pool has obtained via malloc and
+	 * not yet released again.
+	 */
+	size_t	getNumPages() const { return _pages.size(); }
+
+	/**
+	 * Return the total number of chunks in all pages obtained via
+	 * malloc, whether in use or not.
+	 */
+	size_t	getNumPageChunks() const;
 };
 
 /**
@@ -144,6 +165,122 @@ public:
 	}
 };
 
+/**
+ * A memory pool serving requests of arbitrary size. Each request is
+ * rounded up to the next of a fixed set of chunk sizes ("size classes"),
+ * and served by a MemoryPool for that size. Requests too large for any
+ * size class are passed on to malloc.
+ *
+ * Contrary to MemoryPool, the caller has to pass the size of a chunk
+ * when freeing it again. This is exactly what a class specific
+ * operator delete receives, see PooledObject.
+ *
+ * This class is not thread safe; see SharedMemoryPool for that.
+ */
+class SizeClassMemoryPool {
+public:
+	/**
+	 * Allocation counters, to judge how well the pool works.
+	 */
+	struct Stats {
+		uint32 allocCount;		///< number of allocChunk() calls so far
+		uint32 freeCount;		///< number of freeChunk() calls so far
+		uint32 mallocCount;		///< requests passed on to malloc, plus pages allocated
+		size_t usedChunks;		///< chunks currently in use in all size classes
+		size_t usedBytes;		///< bytes currently in use in all size classes
+		size_t reservedBytes;	///< bytes in all pages of all size classes
+	};
+
+	enum {
+		kGranularity = 8,
+		kMaxChunkSize = 256,
+		kNumSizeClasses = 16
+	};
+
+	SizeClassMemoryPool();
+	~SizeClassMemoryPool();
+
+	/**
+	 * Allocate a chunk of at least the given size.
+	 */
+	void	*allocChunk(size_t size);
+
+	/**
+	 * Return a chunk to the pool. The size must be the same as was passed
+	 * to the allocChunk() call which returned the chunk.
+	 */
+	void	freeChunk(void *ptr, size_t size);
+
+	/**
+	 * Release all pages of all size classes which are not in use anymore.
+	 */
+	void	freeUnusedPages();
+
+	/**
+	 * Fill in the current allocation counters.
+	 */
+	void	getStats(Stats &stats) const;
+
+	/**
+	 * Return the chunk size of the size class serving requests of the
+	 * given size, or 0 if those are passed on to malloc.
+	 */
+	static size_t getSizeClassChunkSize(size_t size);
+
+private:
+	SizeClassMemoryPool(const SizeClassMemoryPool &);
+	SizeClassMemoryPool &operator=(const SizeClassMemoryPool &);
+
+	MemoryPool	*_pools[kNumSizeClasses];
+	uint32		_allocCount;
+	uint32		_freeCount;
+	uint32		_mallocCount;
+
+	static int	getSizeClass(size_t size);
+};
+
+/**
+ * A thread safe SizeClassMemoryPool shared by the whole application,
+ * for objects which are allocated in one thread and freed in another
+ * (e.g. audio channels, which the mixer thread disposes of).
+ *
+ * The instance is created on first use, which hence must not happen in
+ * several threads at once; and it requires g_system to be available.
+ */
+class SharedMemoryPool : public Singleton<SharedMemoryPool> {
+public:
+	void	*allocChunk(size_t size);
+	void	freeChunk(void *ptr, size_t size);
+	void	freeUnusedPages();
+	void	getStats(SizeClassMemoryPool::Stats &stats);
+
+private:
+	friend class Singleton<SingletonBaseType>;
+	SharedMemoryPool() {}
+
+	Mutex				_mutex;
+	SizeClassMemoryPool	_pool;
+};
+
+/**
+ * Base class for classes whose instances should be allocated from the
+ * SharedMemoryPool instead of the heap. Deriving from it replaces
+ * operator new and delete for the class and all its subclasses. Classes
+ * with subclasses must have a virtual destructor, so that the correct
+ * size is passed to operator delete.
+ */
+class PooledObject {
+public:
+	static void *operator new(size_t size) {
+		return SharedMemoryPool::instance().allocChunk(size);
+	}
+
+	static void operator delete(void *ptr, size_t size) {
+		if (ptr)
+			SharedMemoryPool::instance().freeChunk(ptr, size);
+	}
+};
+
 }	// End of namespace Common
 
 /**
@@ -4,6 +4,7 @@ MODULE_OBJS := \
 	archive.o \
 	config-file.o \
 	config-manager.o \
+	delta.o \
 	textconsole.o \
 	debug.o \
 	EventDispatcher.o \
@@ -11,6 +12,7 @@ MODULE_OBJS := \
 	file.o \
 	fs.o \
 	hashmap.o \
+	internedstring.o \
 	macresman.o \
 	memorypool.o \
 	md5.o \
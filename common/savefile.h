@@ -30,6 +30,7 @@
 #include "common/scummsys.h"
 #include "common/stream.h"
 #include "common/str.h"
+#include "common/hash-str.h"
 #include "common/error.h"
 
 namespace Common {
@@ -143,6 +144,58 @@ public:
 	 * @see Common::matchString()
 	 */
 	virtual StringList listSavefiles(const String &pattern) = 0;
+
+	/**
+	 * Savefile managers may hand the actual compression and writing of a
+	 * finalized OutSaveFile to a background task, so that engines are not
+	 * blocked while autosaving. This method blocks until all such pending
+	 * savefiles have been committed to their final location.
+	 *
+	 * Since OutSaveFile::err() cannot report errors which happen after
+	 * finalize() returned, these are reported here instead, and through
+	 * getError(). Engines which need to know whether a save succeeded can
+	 * call this, or poll isSavePending() first to avoid blocking.
+	 *
+	 * Managers which write synchronously need not overload this.
+	 *
+	 * @return true if all pending savefiles were written successfully, false otherwise.
+	 */
+	virtual bool flushPendingSaves() { return true; }
+
+	/**
+	 * Checks whether the given savefile is still being written in the background.
+	 * @param name the name of the savefile
+	 * @return true if the savefile has not been committed to disk yet.
+	 */
+	virtual bool isSavePending(const String &name) { return false; }
+
+	/**
+	 * Look up meta information (description, save date, play time, ...) of
+	 * a savefile, as previously stored via setSaveMetaInfo(). This allows
+	 * engines to list savefiles without opening and decompressing each of
+	 * them. Cached entries are dropped as soon as the savefile is rewritten,
+	 * removed or modified by other means.
+	 *
+	 * The cache is kept per target. The target is passed explicitly, since
+	 * the launcher queries savestates without an active config domain.
+	 *
+	 * @param target	the target the savefile belongs to
+	 * @param name		the name of the savefile
+	 * @param metaInfo	receives the cached meta information
+	 * @return true if up-to-date meta information was found, false otherwise.
+	 */
+	virtual bool getSaveMetaInfo(const String &target, const String &name, StringMap &metaInfo) { return false; }
+
+	/**
+	 * Store meta information of a savefile in the cache, for later retrieval
+	 * via getSaveMetaInfo(). Savefile managers without such a cache simply
+	 * ignore this.
+	 *
+	 * @param target	the target the savefile belongs to
+	 * @param name		the name of the savefile
+	 * @param metaInfo	the meta information to store
+	 */
+	virtual void setSaveMetaInfo(const String &target, const String &name, const StringMap &metaInfo) {}
 };
 
 } // End of namespace Common
@@ -150,8 +150,12 @@ void String::ensureCapacity(uint32 new_size, bool keep_old) {
 	} else {
 		// We need to allocate storage on the heap!
 
-		// Compute a suitable new capacity limit
-		newCapacity = MAX(curCapacity * 2, computeCapacity(new_size+1));
+		// Compute a suitable new capacity limit. If we only unshare the
+		// storage, there is no need to grow it.
+		if (isShared && new_size < curCapacity)
+			newCapacity = curCapacity;
+		else
+			newCapacity = MAX(curCapacity * 2, computeCapacity(new_size+1));
 
 		// Allocate new storage
 		newStorage = new char[newCapacity];
@@ -375,6 +379,11 @@ void String::clear() {
 	_storage[0] = 0;
 }
 
+void String::reserve(uint32 size) {
+	if (size > _size)
+		ensureCapacity(size, true);
+}
+
 void String::setChar(char c, uint32 p) {
 	assert(p <= _size);
 
@@ -561,20 +570,38 @@ int String::compareToIgnoreCase(const char *x) const {
 
 #pragma mark -
 
+// The result is assembled in a string of the final size right away, so
+// that at most a single allocation takes place. If one side is empty, the
+// other one is returned, which shares its storage and does not allocate.
+
 String operator+(const String &x, const String &y) {
-	String temp(x);
+	if (y.empty())
+		return x;
+	if (x.empty())
+		return y;
+
+	String temp;
+	temp.reserve(x.size() + y.size());
+	temp += x;
 	temp += y;
 	return temp;
 }
 
 String operator+(const char *x, const String &y) {
-	String temp(x);
+	String temp;
+	temp.reserve(strlen(x) + y.size());
+	temp += x;
 	temp += y;
 	return temp;
 }
 
 String operator+(const String &x, const char *y) {
-	String temp(x);
+	if (!*y)
+		return x;
+
+	String temp;
+	temp.reserve(x.size() + strlen(y));
+	temp += x;
 	temp += y;
 	return temp;
 }
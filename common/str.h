@@ -199,6 +199,12 @@ public:
 	/** Clears the string, making it empty. */
 	void clear();
 
+	/**
+	 * Make sure the string can grow to the given size without further
+	 * reallocations, e.g. before appending many pieces to it.
+	 */
+	void reserve(uint32 size);
+
 	/** Convert all characters in the string to lowercase. */
 	void toLowercase();
 
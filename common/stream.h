@@ -653,7 +653,9 @@ private:
 
 		byte *old_data = _data;
 
-		_capacity = new_len + 32;
+		// Grow geometrically, so that many small writes (as done by e.g.
+		// savegame code) do not reallocate and copy the buffer each time.
+		_capacity = (_capacity * 2 > new_len + 32) ? _capacity * 2 : new_len + 32;
 		_data = (byte *)malloc(_capacity);
 		_ptr = _data + _pos;
 
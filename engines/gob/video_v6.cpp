@@ -23,6 +23,7 @@
  *
  */
 
+#include "common/config-manager.h"
 #include "common/endian.h"
 #include "common/savefile.h"
 #include "graphics/dither.h"
@@ -68,11 +69,40 @@ void Video_v6::buildPalLUT() {
 
 	_palLUT->setPalette(_ditherPalette, Graphics::PaletteLUT::kPaletteYUV, 8, 0);
 
+	// The table is cached in a file named after the hash of the palette
+	Common::SaveFileManager *saveMan = g_system->getSavefileManager();
+	uint32 hash = _palLUT->getHash();
+	Common::String cacheName = Common::String::printf("%s.lut%08x", ConfMan.getActiveDomainName().c_str(), hash);
+
+	Common::InSaveFile *cacheIn = saveMan->openForLoading(cacheName);
+	if (cacheIn) {
+		bool loaded = _palLUT->load(*cacheIn);
+		delete cacheIn;
+
+		if (loaded && (_palLUT->getHash() == hash))
+			return;
+
+		warning("Video_v6::buildPalLUT(): Invalid palette table cache \"%s\"", cacheName.c_str());
+		_palLUT->setPalette(_ditherPalette, Graphics::PaletteLUT::kPaletteYUV, 8, 0);
+	}
+
 	sprintf(text, "Building palette table");
 	drawOSDText(text);
 
 	for (int i = 0; (i < 32) && !_vm->shouldQuit(); i++)
 		_palLUT->buildNext();
+
+	if (_vm->shouldQuit())
+		return;
+
+	Common::OutSaveFile *cacheOut = saveMan->openForSaving(cacheName);
+	if (cacheOut) {
+		if (!_palLUT->save(*cacheOut))
+			warning("Video_v6::buildPalLUT(): Can't write palette table cache \"%s\"", cacheName.c_str());
+
+		cacheOut->finalize();
+		delete cacheOut;
+	}
 }
 
 char Video_v6::spriteUncompressor(byte *sprBuf, int16 srcWidth, int16 srcHeight,
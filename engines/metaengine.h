@@ -34,8 +34,13 @@
 class Engine;
 class OSystem;
 
+namespace Audio {
+	class Mixer;
+}
+
 namespace Common {
 	class FSList;
+	class FSNode;
 	class String;
 }
 
@@ -139,6 +144,21 @@ public:
 		return SaveStateDescriptor();
 	}
 
+	/**
+	 * Decodes all frames of a video in one of the engine's own formats for
+	 * the --bench-video command line option, and prints the results with a
+	 * Graphics::VideoBenchmark.
+	 *
+	 * @param node	the video file
+	 * @param mixer	a mixer for the sound of the video, which is never played
+	 * @return kNoError if the video was decoded, kUnsupportedGameidError if
+	 *         the engine does not know the format of the video, and any
+	 *         other error if the video could not be decoded
+	 */
+	virtual Common::Error benchVideo(const Common::FSNode &node, Audio::Mixer *mixer) const {
+		return Common::kUnsupportedGameidError;
+	}
+
 	/** @name MetaEngineFeature flags */
 	//@{
 
@@ -29,10 +29,14 @@
 #include "common/config-manager.h"
 #include "common/file.h"
 #include "common/savefile.h"
+#include "common/fs.h"
 
 #include "mohawk/myst.h"
 #include "mohawk/riven.h"
 #include "mohawk/livingbooks.h"
+#include "mohawk/video/qt_player.h"
+
+#include "graphics/video/video_benchmark.h"
 
 // Define this to enable detection of other Broderbund titles which use Mohawk (besides Myst/Riven)
 #define DETECT_BRODERBUND_TITLES
@@ -995,6 +999,7 @@ public:
 	virtual SaveStateList listSaves(const char *target) const;
 	virtual int getMaximumSaveSlot() const { return 999; }
 	virtual void removeSaveState(const char *target, int slot) const;
+	virtual Common::Error benchVideo(const Common::FSNode &node, Audio::Mixer *mixer) const;
 };
 
 bool MohawkMetaEngine::hasFeature(MetaEngineFeature f) const {
@@ -1069,6 +1074,40 @@ bool MohawkMetaEngine::createInstance(OSystem *syst, Engine **engine, const ADGa
 	return (gd != 0);
 }
 
+Common::Error MohawkMetaEngine::benchVideo(const Common::FSNode &node, Audio::Mixer *mixer) const {
+	Common::String name = node.getName();
+	name.toLowercase();
+	if (!name.hasSuffix(".mov"))
+		return Common::kUnsupportedGameidError;
+
+	Common::SeekableReadStream *stream = node.createReadStream();
+	if (!stream)
+		return Common::kReadingFailed;
+
+	// The player takes over the stream
+	Mohawk::QTPlayer video(mixer);
+	if (!video.loadFile(stream))
+		return Common::kReadingFailed;
+
+	uint32 frameCount = video.getFrameCount();
+
+	Graphics::VideoBenchmark bench(node.getPath());
+	bench.start();
+	for (uint32 i = 0; i < frameCount; i++) {
+		Graphics::Surface *frame = video.getNextFrame();
+		if (frame)
+			bench.addFrame((byte *)frame->pixels, frame->pitch, frame->w * frame->bytesPerPixel, frame->h);
+	}
+	bench.stop();
+
+	// No codec for the video
+	if (frameCount > 0 && !bench.getFrames())
+		return Common::kReadingFailed;
+
+	bench.printResult(video.getWidth(), video.getHeight());
+	return Common::kNoError;
+}
+
 #if PLUGIN_ENABLED_DYNAMIC(MOHAWK)
 	REGISTER_PLUGIN_DYNAMIC(MOHAWK, PLUGIN_TYPE_ENGINE, MohawkMetaEngine);
 #else
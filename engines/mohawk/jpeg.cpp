@@ -24,7 +24,7 @@
  */
 
 #include "common/system.h"
-#include "graphics/conversion.h" // For YUV2RGB
+#include "graphics/conversion.h" // For convertYUV444ToRGB
 
 #include "mohawk/jpeg.h"
 
@@ -70,16 +70,9 @@ Graphics::Surface *JPEGDecoder::decodeImage(Common::SeekableReadStream* stream)
 
 	assert(destSurface);
 
-	for (uint16 i = 0; i < destSurface->h; i++) {
-		for (uint16 j = 0; j < destSurface->w; j++) {
-			byte r = 0, g = 0, b = 0;
-			Graphics::YUV2RGB(*((byte *)ySurface->getBasePtr(j, i)), *((byte *)uSurface->getBasePtr(j, i)), *((byte *)vSurface->getBasePtr(j, i)), r, g, b);
-			if (_pixelFormat.bytesPerPixel == 2)
-				*((uint16 *)destSurface->getBasePtr(j, i)) = _pixelFormat.RGBToColor(r, g, b);
-			else
-				*((uint32 *)destSurface->getBasePtr(j, i)) = _pixelFormat.RGBToColor(r, g, b);
-		}
-	}
+	Graphics::convertYUV444ToRGB((byte *)destSurface->pixels, destSurface->pitch, _pixelFormat,
+		(const byte *)ySurface->pixels, (const byte *)uSurface->pixels, (const byte *)vSurface->pixels,
+		ySurface->pitch, uSurface->pitch, destSurface->w, destSurface->h);
 
 	return destSurface;
 }
@@ -27,22 +27,18 @@
 
 #include "common/system.h"
 #include "graphics/conversion.h" // For YUV2RGB
+#include "graphics/surfacepool.h"
 
 // Code here partially based off of ffmpeg ;)
 
 namespace Mohawk {
 
-#define PUT_PIXEL(offset, lum, u, v) \
-	Graphics::CPYUV2RGB(lum, u, v, r, g, b); \
-	if (_pixelFormat.bytesPerPixel == 2) \
-		*((uint16 *)_curFrame.surface->pixels + offset) = _pixelFormat.RGBToColor(r, g, b); \
-	else \
-		*((uint32 *)_curFrame.surface->pixels + offset) = _pixelFormat.RGBToColor(r, g, b)
-
 CinepakDecoder::CinepakDecoder() : Graphics::Codec() {
 	_curFrame.surface = NULL;
 	_curFrame.strips = NULL;
 	_y = 0;
+	_chunkData = NULL;
+	_chunkDataSize = 0;
 	_pixelFormat = g_system->getScreenFormat();
 
 	// We're going to have to dither if we're running in 8bpp.
@@ -52,9 +48,9 @@ CinepakDecoder::CinepakDecoder() : Graphics::Codec() {
 }
 
 CinepakDecoder::~CinepakDecoder() {
-	if (_curFrame.surface)
-		_curFrame.surface->free();
+	SurfacePoolMan.release(_curFrame.surface);
 	delete[] _curFrame.strips;
+	delete[] _chunkData;
 }
 
 Graphics::Surface *CinepakDecoder::decodeImage(Common::SeekableReadStream *stream) {
@@ -79,8 +75,8 @@ Graphics::Surface *CinepakDecoder::decodeImage(Common::SeekableReadStream *strea
 #endif
 
 	if (!_curFrame.surface) {
-		_curFrame.surface = new Graphics::Surface();
-		_curFrame.surface->create(_curFrame.width, _curFrame.height, _pixelFormat.bytesPerPixel);
+		_curFrame.surface = SurfacePoolMan.acquire(_curFrame.width, _curFrame.height, _pixelFormat.bytesPerPixel);
+		memset(_curFrame.surface->pixels, 0, _curFrame.surface->pitch * _curFrame.surface->h);
 	}
 
 	// Reset the y variable.
@@ -120,23 +116,37 @@ Graphics::Surface *CinepakDecoder::decodeImage(Common::SeekableReadStream *strea
 
 			int32 startPos = stream->pos();
 
+			// Read the whole chunk at once, instead of reading it byte by
+			// byte through the stream.
+			chunkSize = MIN<uint32>(chunkSize, stream->size() - startPos);
+			if (chunkSize > _chunkDataSize) {
+				delete[] _chunkData;
+				_chunkData = new byte[chunkSize];
+				_chunkDataSize = chunkSize;
+			}
+
+			uint32 dataSize = stream->read(_chunkData, chunkSize);
+
 			switch (chunkID) {
 			case 0x20:
 			case 0x21:
 			case 0x24:
 			case 0x25:
-				loadCodebook(stream, i, 4, chunkID, chunkSize);
+				loadCodebook(_chunkData, dataSize, i, 4, chunkID);
 				break;
 			case 0x22:
 			case 0x23:
 			case 0x26:
 			case 0x27:
-				loadCodebook(stream, i, 1, chunkID, chunkSize);
+				loadCodebook(_chunkData, dataSize, i, 1, chunkID);
 				break;
 			case 0x30:
 			case 0x31:
 			case 0x32:
-				decodeVectors(stream, i, chunkID, chunkSize);
+				if (_pixelFormat.bytesPerPixel == 2)
+					decodeVectors<uint16>(_chunkData, dataSize, i, chunkID);
+				else
+					decodeVectors<uint32>(_chunkData, dataSize, i, chunkID);
 				break;
 			default:
 				warning("Unknown Cinepak chunk ID %02x", chunkID);
@@ -153,32 +163,34 @@ Graphics::Surface *CinepakDecoder::decodeImage(Common::SeekableReadStream *strea
 	return _curFrame.surface;
 }
 
-void CinepakDecoder::loadCodebook(Common::SeekableReadStream *stream, uint16 strip, byte codebookType, byte chunkID, uint32 chunkSize) {
+void CinepakDecoder::loadCodebook(const byte *data, uint32 size, uint16 strip, byte codebookType, byte chunkID) {
 	CinepakCodebook *codebook = (codebookType == 1) ? _curFrame.strips[strip].v1_codebook : _curFrame.strips[strip].v4_codebook;
 
-	int32 startPos = stream->pos();
+	const byte *end = data + size;
 	uint32 flag = 0, mask = 0;
+	byte r, g, b;
 
 	for (uint16 i = 0; i < 256; i++) {
 		if ((chunkID & 0x01) && !(mask >>= 1)) {
-			if ((stream->pos() - startPos + 4) > (int32)chunkSize)
+			if (end - data < 4)
 				break;
 
-			flag  = stream->readUint32BE();
+			flag  = READ_BE_UINT32(data);
 			mask  = 0x80000000;
+			data += 4;
 		}
 
 		if (!(chunkID & 0x01) || (flag & mask)) {
 			byte n = (chunkID & 0x04) ? 4 : 6;
-			if ((stream->pos() - startPos + n) > (int32)chunkSize)
+			if (end - data < n)
 				break;
 
 			for (byte j = 0; j < 4; j++)
-				codebook[i].y[j] = stream->readByte();
+				codebook[i].y[j] = *data++;
 
 			if (n == 6) {
-				codebook[i].u  = stream->readByte() + 128;
-				codebook[i].v  = stream->readByte() + 128;
+				codebook[i].u  = *data++ + 128;
+				codebook[i].v  = *data++ + 128;
 			} else {
 				/* this codebook type indicates either greyscale or
 				 * palettized video; if palettized, U & V components will
@@ -187,98 +199,102 @@ void CinepakDecoder::loadCodebook(Common::SeekableReadStream *stream, uint16 str
 				codebook[i].u  = 128;
 				codebook[i].v  = 128;
 			}
+
+			// Convert the entry right away, so that decodeVectors() only
+			// has to copy the colors.
+			for (byte j = 0; j < 4; j++) {
+				Graphics::CPYUV2RGB(codebook[i].y[j], codebook[i].u, codebook[i].v, r, g, b);
+				codebook[i].colors[j] = _pixelFormat.RGBToColor(r, g, b);
+			}
 		}
 	}
 }
 
-void CinepakDecoder::decodeVectors(Common::SeekableReadStream *stream, uint16 strip, byte chunkID, uint32 chunkSize) {
+/**
+ * Draw a 4x4 block with a V1 codebook entry, i.e. with each color
+ * covering 2x2 pixels.
+ */
+template<typename PixelInt>
+static inline void putV1Block(PixelInt *dst, uint pitch, const CinepakCodebook &codebook) {
+	PixelInt row[4];
+
+	row[0] = row[1] = codebook.colors[0];
+	row[2] = row[3] = codebook.colors[1];
+	memcpy(dst, row, sizeof(row));
+	memcpy(dst + pitch, row, sizeof(row));
+	dst += pitch * 2;
+
+	row[0] = row[1] = codebook.colors[2];
+	row[2] = row[3] = codebook.colors[3];
+	memcpy(dst, row, sizeof(row));
+	memcpy(dst + pitch, row, sizeof(row));
+}
+
+/**
+ * Draw two lines of a 4x4 block with two V4 codebook entries, each
+ * covering 2x2 pixels.
+ */
+template<typename PixelInt>
+static inline void putV4Lines(PixelInt *dst, uint pitch, const CinepakCodebook &left, const CinepakCodebook &right) {
+	PixelInt row[4];
+
+	row[0] = left.colors[0];
+	row[1] = left.colors[1];
+	row[2] = right.colors[0];
+	row[3] = right.colors[1];
+	memcpy(dst, row, sizeof(row));
+
+	row[0] = left.colors[2];
+	row[1] = left.colors[3];
+	row[2] = right.colors[2];
+	row[3] = right.colors[3];
+	memcpy(dst + pitch, row, sizeof(row));
+}
+
+template<typename PixelInt>
+void CinepakDecoder::decodeVectors(const byte *data, uint32 size, uint16 strip, byte chunkID) {
+	const CinepakStrip &curStrip = _curFrame.strips[strip];
+	const byte *end = data + size;
 	uint32 flag = 0, mask = 0;
-	uint32 iy[4];
-	int32 startPos = stream->pos();
-	byte r = 0, g = 0, b = 0;
+	uint pitch = _curFrame.surface->pitch / sizeof(PixelInt);
 
-	for (uint16 y = _curFrame.strips[strip].rect.top; y < _curFrame.strips[strip].rect.bottom; y += 4) {
-		iy[0] = _curFrame.strips[strip].rect.left + y * _curFrame.width;
-		iy[1] = iy[0] + _curFrame.width;
-		iy[2] = iy[1] + _curFrame.width;
-		iy[3] = iy[2] + _curFrame.width;
+	for (uint16 y = curStrip.rect.top; y < curStrip.rect.bottom; y += 4) {
+		PixelInt *dst = (PixelInt *)_curFrame.surface->getBasePtr(curStrip.rect.left, y);
 
-		for (uint16 x = _curFrame.strips[strip].rect.left; x < _curFrame.strips[strip].rect.right; x += 4) {
+		for (uint16 x = curStrip.rect.left; x < curStrip.rect.right; x += 4, dst += 4) {
 			if ((chunkID & 0x01) && !(mask >>= 1)) {
-				if ((stream->pos() - startPos + 4) > (int32)chunkSize)
+				if (end - data < 4)
 					return;
 
-				flag  = stream->readUint32BE();
+				flag  = READ_BE_UINT32(data);
 				mask  = 0x80000000;
+				data += 4;
 			}
 
 			if (!(chunkID & 0x01) || (flag & mask)) {
 				if (!(chunkID & 0x02) && !(mask >>= 1)) {
-					if ((stream->pos() - startPos + 4) > (int32)chunkSize)
+					if (end - data < 4)
 						return;
 
-					flag  = stream->readUint32BE();
+					flag  = READ_BE_UINT32(data);
 					mask  = 0x80000000;
+					data += 4;
 				}
 
 				if ((chunkID & 0x02) || (~flag & mask)) {
-					if ((stream->pos() - startPos + 1) > (int32)chunkSize)
+					if (end - data < 1)
 						return;
 
-					// Get the codebook
-					CinepakCodebook codebook = _curFrame.strips[strip].v1_codebook[stream->readByte()];
-
-					PUT_PIXEL(iy[0] + 0, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[0] + 1, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 0, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 1, codebook.y[0], codebook.u, codebook.v);
-
-					PUT_PIXEL(iy[0] + 2, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[0] + 3, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 2, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 3, codebook.y[1], codebook.u, codebook.v);
-
-					PUT_PIXEL(iy[2] + 0, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[2] + 1, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 0, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 1, codebook.y[2], codebook.u, codebook.v);
-
-					PUT_PIXEL(iy[2] + 2, codebook.y[3], codebook.u, codebook.v);
-					PUT_PIXEL(iy[2] + 3, codebook.y[3], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 2, codebook.y[3], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 3, codebook.y[3], codebook.u, codebook.v);
+					putV1Block(dst, pitch, curStrip.v1_codebook[*data++]);
 				} else if (flag & mask) {
-					if ((stream->pos() - startPos + 4) > (int32)chunkSize)
+					if (end - data < 4)
 						return;
 
-					CinepakCodebook codebook = _curFrame.strips[strip].v4_codebook[stream->readByte()];
-					PUT_PIXEL(iy[0] + 0, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[0] + 1, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 0, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 1, codebook.y[3], codebook.u, codebook.v);
-
-					codebook = _curFrame.strips[strip].v4_codebook[stream->readByte()];
-					PUT_PIXEL(iy[0] + 2, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[0] + 3, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 2, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 3, codebook.y[3], codebook.u, codebook.v);
-
-					codebook = _curFrame.strips[strip].v4_codebook[stream->readByte()];
-					PUT_PIXEL(iy[2] + 0, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[2] + 1, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 0, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 1, codebook.y[3], codebook.u, codebook.v);
-
-					codebook = _curFrame.strips[strip].v4_codebook[stream->readByte()];
-					PUT_PIXEL(iy[2] + 2, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[2] + 3, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 2, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 3, codebook.y[3], codebook.u, codebook.v);
+					putV4Lines(dst,             pitch, curStrip.v4_codebook[data[0]], curStrip.v4_codebook[data[1]]);
+					putV4Lines(dst + pitch * 2, pitch, curStrip.v4_codebook[data[2]], curStrip.v4_codebook[data[3]]);
+					data += 4;
 				}
 			}
-
-			for (byte i = 0; i < 4; i++)
-				iy[i] += 4;
 		}
 	}
 }
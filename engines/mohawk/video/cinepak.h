@@ -39,6 +39,9 @@ namespace Mohawk {
 struct CinepakCodebook {
 	byte y[4];
 	byte u, v;
+
+	// The colors of the four luma values, in the output pixel format
+	uint32 colors[4];
 };
 
 struct CinepakStrip {
@@ -71,8 +74,13 @@ private:
 	int32 _y;
 	Graphics::PixelFormat _pixelFormat;
 
-	void loadCodebook(Common::SeekableReadStream *stream, uint16 strip, byte codebookType, byte chunkID, uint32 chunkSize);
-	void decodeVectors(Common::SeekableReadStream *stream, uint16 strip, byte chunkID, uint32 chunkSize);
+	// The data of the current chunk
+	byte *_chunkData;
+	uint32 _chunkDataSize;
+
+	void loadCodebook(const byte *data, uint32 size, uint16 strip, byte codebookType, byte chunkID);
+	template<typename PixelInt>
+	void decodeVectors(const byte *data, uint32 size, uint16 strip, byte chunkID);
 };
 
 }
@@ -30,6 +30,16 @@
 
 #include "common/system.h"
 
+#include "sound/decoders/raw.h"
+
+#if defined(__SSE2__)
+#define MOHAWK_QDM2_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define MOHAWK_QDM2_NEON
+#include <arm_neon.h>
+#endif
+
 namespace Mohawk {
 
 // Fix compilation for non C99-compliant compilers, like MSVC
@@ -204,6 +214,12 @@ float *ff_cos_tabs[] = {
 };
 
 void initCosineTables(int index) {
+	// The tables are shared by all FFTs, only build them once
+	static bool initialized[ARRAYSIZE(ff_cos_tabs)];
+	if (initialized[index])
+		return;
+	initialized[index] = true;
+
 	int m = 1 << index;
 	double freq = 2 * PI / m;
 	float *tab = ff_cos_tabs[index];
@@ -494,15 +510,26 @@ void mdctCalcC(FFTContext *s, float *out, const float *input) {
 	}
 }
 
+void fftEnd(FFTContext *s) {
+	free(s->revtab);
+	free(s->exptab);
+	free(s->tmpBuf);
+	s->revtab = NULL;
+	s->exptab = NULL;
+	s->tmpBuf = NULL;
+}
+
 int fftInit(FFTContext *s, int nbits, int inverse) {
 	int i, j, m, n;
 	float alpha, c1, s1, s2;
 
 	if (nbits < 2 || nbits > 16)
-		goto fail;
+		return -1;
 
 	s->nbits = nbits;
 	n = 1 << nbits;
+	s->revtab = NULL;
+	s->exptab = NULL;
 	s->tmpBuf = NULL;
 
 	s->exptab = (FFTComplex *)malloc((n / 2) * sizeof(FFTComplex));
@@ -558,9 +585,7 @@ int fftInit(FFTContext *s, int nbits, int inverse) {
 	return 0;
 
  fail:
-	free(&s->revtab);
-	free(&s->exptab);
-	free(&s->tmpBuf);
+	fftEnd(s);
 	return -1;
 }
 
@@ -593,6 +618,10 @@ int rdftInit(RDFTContext *s, int nbits, RDFTransformType trans) {
 	return 0;
 }
 
+void rdftEnd(RDFTContext *s) {
+	fftEnd(&s->fft);
+}
+
 /** Map one real FFT into two parallel real even and odd FFTs. Then interleave
  * the two real FFTs into one complex FFT. Unmangle the results.
  * ref: http://www.engineeringproductivitytools.com/stuff/T0001/PT10.HTM
@@ -1294,6 +1323,43 @@ void initVlcSparse(VLC *vlc, int nb_bits, int nb_codes,
 		error("QDM2 needed %d had %d", vlc->table_size, vlc->table_allocated);
 }
 
+bool QDM2Stream::_tablesInitialized = false;
+
+VLC QDM2Stream::_vlcTabLevel;
+VLC QDM2Stream::_vlcTabDiff;
+VLC QDM2Stream::_vlcTabRun;
+VLC QDM2Stream::_fftLevelExpAltVlc;
+VLC QDM2Stream::_fftLevelExpVlc;
+VLC QDM2Stream::_fftStereoExpVlc;
+VLC QDM2Stream::_fftStereoPhaseVlc;
+VLC QDM2Stream::_vlcTabToneLevelIdxHi1;
+VLC QDM2Stream::_vlcTabToneLevelIdxMid;
+VLC QDM2Stream::_vlcTabToneLevelIdxHi2;
+VLC QDM2Stream::_vlcTabType30;
+VLC QDM2Stream::_vlcTabType34;
+VLC QDM2Stream::_vlcTabFftToneOffset[5];
+
+uint16 QDM2Stream::_softclipTable[HARDCLIP_THRESHOLD - SOFTCLIP_THRESHOLD + 1];
+float QDM2Stream::_noiseTable[4096];
+byte QDM2Stream::_randomDequantIndex[256][5];
+byte QDM2Stream::_randomDequantType24[128][3];
+float QDM2Stream::_noiseSamples[128];
+int16 QDM2Stream::ff_mpa_synth_window[512];
+
+void QDM2Stream::initTables(void) {
+	// Streams are only created by the main thread, so this needs no locking
+	if (_tablesInitialized)
+		return;
+
+	initVlc();
+	ff_mpa_synth_init(ff_mpa_synth_window);
+	softclipTableInit();
+	rndTableInit();
+	initNoiseSamples();
+
+	_tablesInitialized = true;
+}
+
 void QDM2Stream::softclipTableInit(void) {
 	uint16 i;
 	double dfl = SOFTCLIP_THRESHOLD - 32767;
@@ -1361,128 +1427,124 @@ static const uint16 qdm2_vlc_offs[18] = {
 void QDM2Stream::initVlc(void) {
 	static int16 qdm2_table[3838][2];
 
-	if (!_vlcsInitialized) {
-		_vlcTabLevel.table = &qdm2_table[qdm2_vlc_offs[0]];
-		_vlcTabLevel.table_allocated = qdm2_vlc_offs[1] - qdm2_vlc_offs[0];
-		_vlcTabLevel.table_size = 0;
-		initVlcSparse(&_vlcTabLevel, 8, 24,
-			vlc_tab_level_huffbits, 1, 1,
-			vlc_tab_level_huffcodes, 2, 2, NULL, 0, 0);
-
-		_vlcTabDiff.table = &qdm2_table[qdm2_vlc_offs[1]];
-		_vlcTabDiff.table_allocated = qdm2_vlc_offs[2] - qdm2_vlc_offs[1];
-		_vlcTabDiff.table_size = 0;
-		initVlcSparse(&_vlcTabDiff, 8, 37,
-			vlc_tab_diff_huffbits, 1, 1,
-			vlc_tab_diff_huffcodes, 2, 2, NULL, 0, 0);
-
-		_vlcTabRun.table = &qdm2_table[qdm2_vlc_offs[2]];
-		_vlcTabRun.table_allocated = qdm2_vlc_offs[3] - qdm2_vlc_offs[2];
-		_vlcTabRun.table_size = 0;
-		initVlcSparse(&_vlcTabRun, 5, 6,
-			vlc_tab_run_huffbits, 1, 1,
-			vlc_tab_run_huffcodes, 1, 1, NULL, 0, 0);
-
-		_fftLevelExpAltVlc.table = &qdm2_table[qdm2_vlc_offs[3]];
-		_fftLevelExpAltVlc.table_allocated = qdm2_vlc_offs[4] - qdm2_vlc_offs[3];
-		_fftLevelExpAltVlc.table_size = 0;
-		initVlcSparse(&_fftLevelExpAltVlc, 8, 28,
-			fft_level_exp_alt_huffbits, 1, 1,
-			fft_level_exp_alt_huffcodes, 2, 2, NULL, 0, 0);
-
-		_fftLevelExpVlc.table = &qdm2_table[qdm2_vlc_offs[4]];
-		_fftLevelExpVlc.table_allocated = qdm2_vlc_offs[5] - qdm2_vlc_offs[4];
-		_fftLevelExpVlc.table_size = 0;
-		initVlcSparse(&_fftLevelExpVlc, 8, 20,
-			fft_level_exp_huffbits, 1, 1,
-			fft_level_exp_huffcodes, 2, 2, NULL, 0, 0);
-
-		_fftStereoExpVlc.table = &qdm2_table[qdm2_vlc_offs[5]];
-		_fftStereoExpVlc.table_allocated = qdm2_vlc_offs[6] - qdm2_vlc_offs[5];
-		_fftStereoExpVlc.table_size = 0;
-		initVlcSparse(&_fftStereoExpVlc, 6, 7,
-			fft_stereo_exp_huffbits, 1, 1,
-			fft_stereo_exp_huffcodes, 1, 1, NULL, 0, 0);
-
-		_fftStereoPhaseVlc.table = &qdm2_table[qdm2_vlc_offs[6]];
-		_fftStereoPhaseVlc.table_allocated = qdm2_vlc_offs[7] - qdm2_vlc_offs[6];
-		_fftStereoPhaseVlc.table_size = 0;
-		initVlcSparse(&_fftStereoPhaseVlc, 6, 9,
-			fft_stereo_phase_huffbits, 1, 1,
-			fft_stereo_phase_huffcodes, 1, 1, NULL, 0, 0);
-
-		_vlcTabToneLevelIdxHi1.table = &qdm2_table[qdm2_vlc_offs[7]];
-		_vlcTabToneLevelIdxHi1.table_allocated = qdm2_vlc_offs[8] - qdm2_vlc_offs[7];
-		_vlcTabToneLevelIdxHi1.table_size = 0;
-		initVlcSparse(&_vlcTabToneLevelIdxHi1, 8, 20,
-			vlc_tab_tone_level_idx_hi1_huffbits, 1, 1,
-			vlc_tab_tone_level_idx_hi1_huffcodes, 2, 2, NULL, 0, 0);
-
-		_vlcTabToneLevelIdxMid.table = &qdm2_table[qdm2_vlc_offs[8]];
-		_vlcTabToneLevelIdxMid.table_allocated = qdm2_vlc_offs[9] - qdm2_vlc_offs[8];
-		_vlcTabToneLevelIdxMid.table_size = 0;
-		initVlcSparse(&_vlcTabToneLevelIdxMid, 8, 24,
-			vlc_tab_tone_level_idx_mid_huffbits, 1, 1,
-			vlc_tab_tone_level_idx_mid_huffcodes, 2, 2, NULL, 0, 0);
-
-		_vlcTabToneLevelIdxHi2.table = &qdm2_table[qdm2_vlc_offs[9]];
-		_vlcTabToneLevelIdxHi2.table_allocated = qdm2_vlc_offs[10] - qdm2_vlc_offs[9];
-		_vlcTabToneLevelIdxHi2.table_size = 0;
-		initVlcSparse(&_vlcTabToneLevelIdxHi2, 8, 24,
-			vlc_tab_tone_level_idx_hi2_huffbits, 1, 1,
-			vlc_tab_tone_level_idx_hi2_huffcodes, 2, 2, NULL, 0, 0);
-
-		_vlcTabType30.table = &qdm2_table[qdm2_vlc_offs[10]];
-		_vlcTabType30.table_allocated = qdm2_vlc_offs[11] - qdm2_vlc_offs[10];
-		_vlcTabType30.table_size = 0;
-		initVlcSparse(&_vlcTabType30, 6, 9,
-			vlc_tab_type30_huffbits, 1, 1,
-			vlc_tab_type30_huffcodes, 1, 1, NULL, 0, 0);
-
-		_vlcTabType34.table = &qdm2_table[qdm2_vlc_offs[11]];
-		_vlcTabType34.table_allocated = qdm2_vlc_offs[12] - qdm2_vlc_offs[11];
-		_vlcTabType34.table_size = 0;
-		initVlcSparse(&_vlcTabType34, 5, 10,
-			vlc_tab_type34_huffbits, 1, 1,
-			vlc_tab_type34_huffcodes, 1, 1, NULL, 0, 0);
-
-		_vlcTabFftToneOffset[0].table = &qdm2_table[qdm2_vlc_offs[12]];
-		_vlcTabFftToneOffset[0].table_allocated = qdm2_vlc_offs[13] - qdm2_vlc_offs[12];
-		_vlcTabFftToneOffset[0].table_size = 0;
-		initVlcSparse(&_vlcTabFftToneOffset[0], 8, 23,
-			vlc_tab_fft_tone_offset_0_huffbits, 1, 1,
-			vlc_tab_fft_tone_offset_0_huffcodes, 2, 2, NULL, 0, 0);
-
-		_vlcTabFftToneOffset[1].table = &qdm2_table[qdm2_vlc_offs[13]];
-		_vlcTabFftToneOffset[1].table_allocated = qdm2_vlc_offs[14] - qdm2_vlc_offs[13];
-		_vlcTabFftToneOffset[1].table_size = 0;
-		initVlcSparse(&_vlcTabFftToneOffset[1], 8, 28,
-			vlc_tab_fft_tone_offset_1_huffbits, 1, 1,
-			vlc_tab_fft_tone_offset_1_huffcodes, 2, 2, NULL, 0, 0);
-
-		_vlcTabFftToneOffset[2].table = &qdm2_table[qdm2_vlc_offs[14]];
-		_vlcTabFftToneOffset[2].table_allocated = qdm2_vlc_offs[15] - qdm2_vlc_offs[14];
-		_vlcTabFftToneOffset[2].table_size = 0;
-		initVlcSparse(&_vlcTabFftToneOffset[2], 8, 32,
-			vlc_tab_fft_tone_offset_2_huffbits, 1, 1,
-			vlc_tab_fft_tone_offset_2_huffcodes, 2, 2, NULL, 0, 0);
-
-		_vlcTabFftToneOffset[3].table = &qdm2_table[qdm2_vlc_offs[15]];
-		_vlcTabFftToneOffset[3].table_allocated = qdm2_vlc_offs[16] - qdm2_vlc_offs[15];
-		_vlcTabFftToneOffset[3].table_size = 0;
-		initVlcSparse(&_vlcTabFftToneOffset[3], 8, 35,
-			vlc_tab_fft_tone_offset_3_huffbits, 1, 1,
-			vlc_tab_fft_tone_offset_3_huffcodes, 2, 2, NULL, 0, 0);
-
-		_vlcTabFftToneOffset[4].table = &qdm2_table[qdm2_vlc_offs[16]];
-		_vlcTabFftToneOffset[4].table_allocated = qdm2_vlc_offs[17] - qdm2_vlc_offs[16];
-		_vlcTabFftToneOffset[4].table_size = 0;
-		initVlcSparse(&_vlcTabFftToneOffset[4], 8, 38,
-			vlc_tab_fft_tone_offset_4_huffbits, 1, 1,
-			vlc_tab_fft_tone_offset_4_huffcodes, 2, 2, NULL, 0, 0);
-
-		_vlcsInitialized = true;
-	}
+	_vlcTabLevel.table = &qdm2_table[qdm2_vlc_offs[0]];
+	_vlcTabLevel.table_allocated = qdm2_vlc_offs[1] - qdm2_vlc_offs[0];
+	_vlcTabLevel.table_size = 0;
+	initVlcSparse(&_vlcTabLevel, 8, 24,
+		vlc_tab_level_huffbits, 1, 1,
+		vlc_tab_level_huffcodes, 2, 2, NULL, 0, 0);
+
+	_vlcTabDiff.table = &qdm2_table[qdm2_vlc_offs[1]];
+	_vlcTabDiff.table_allocated = qdm2_vlc_offs[2] - qdm2_vlc_offs[1];
+	_vlcTabDiff.table_size = 0;
+	initVlcSparse(&_vlcTabDiff, 8, 37,
+		vlc_tab_diff_huffbits, 1, 1,
+		vlc_tab_diff_huffcodes, 2, 2, NULL, 0, 0);
+
+	_vlcTabRun.table = &qdm2_table[qdm2_vlc_offs[2]];
+	_vlcTabRun.table_allocated = qdm2_vlc_offs[3] - qdm2_vlc_offs[2];
+	_vlcTabRun.table_size = 0;
+	initVlcSparse(&_vlcTabRun, 5, 6,
+		vlc_tab_run_huffbits, 1, 1,
+		vlc_tab_run_huffcodes, 1, 1, NULL, 0, 0);
+
+	_fftLevelExpAltVlc.table = &qdm2_table[qdm2_vlc_offs[3]];
+	_fftLevelExpAltVlc.table_allocated = qdm2_vlc_offs[4] - qdm2_vlc_offs[3];
+	_fftLevelExpAltVlc.table_size = 0;
+	initVlcSparse(&_fftLevelExpAltVlc, 8, 28,
+		fft_level_exp_alt_huffbits, 1, 1,
+		fft_level_exp_alt_huffcodes, 2, 2, NULL, 0, 0);
+
+	_fftLevelExpVlc.table = &qdm2_table[qdm2_vlc_offs[4]];
+	_fftLevelExpVlc.table_allocated = qdm2_vlc_offs[5] - qdm2_vlc_offs[4];
+	_fftLevelExpVlc.table_size = 0;
+	initVlcSparse(&_fftLevelExpVlc, 8, 20,
+		fft_level_exp_huffbits, 1, 1,
+		fft_level_exp_huffcodes, 2, 2, NULL, 0, 0);
+
+	_fftStereoExpVlc.table = &qdm2_table[qdm2_vlc_offs[5]];
+	_fftStereoExpVlc.table_allocated = qdm2_vlc_offs[6] - qdm2_vlc_offs[5];
+	_fftStereoExpVlc.table_size = 0;
+	initVlcSparse(&_fftStereoExpVlc, 6, 7,
+		fft_stereo_exp_huffbits, 1, 1,
+		fft_stereo_exp_huffcodes, 1, 1, NULL, 0, 0);
+
+	_fftStereoPhaseVlc.table = &qdm2_table[qdm2_vlc_offs[6]];
+	_fftStereoPhaseVlc.table_allocated = qdm2_vlc_offs[7] - qdm2_vlc_offs[6];
+	_fftStereoPhaseVlc.table_size = 0;
+	initVlcSparse(&_fftStereoPhaseVlc, 6, 9,
+		fft_stereo_phase_huffbits, 1, 1,
+		fft_stereo_phase_huffcodes, 1, 1, NULL, 0, 0);
+
+	_vlcTabToneLevelIdxHi1.table = &qdm2_table[qdm2_vlc_offs[7]];
+	_vlcTabToneLevelIdxHi1.table_allocated = qdm2_vlc_offs[8] - qdm2_vlc_offs[7];
+	_vlcTabToneLevelIdxHi1.table_size = 0;
+	initVlcSparse(&_vlcTabToneLevelIdxHi1, 8, 20,
+		vlc_tab_tone_level_idx_hi1_huffbits, 1, 1,
+		vlc_tab_tone_level_idx_hi1_huffcodes, 2, 2, NULL, 0, 0);
+
+	_vlcTabToneLevelIdxMid.table = &qdm2_table[qdm2_vlc_offs[8]];
+	_vlcTabToneLevelIdxMid.table_allocated = qdm2_vlc_offs[9] - qdm2_vlc_offs[8];
+	_vlcTabToneLevelIdxMid.table_size = 0;
+	initVlcSparse(&_vlcTabToneLevelIdxMid, 8, 24,
+		vlc_tab_tone_level_idx_mid_huffbits, 1, 1,
+		vlc_tab_tone_level_idx_mid_huffcodes, 2, 2, NULL, 0, 0);
+
+	_vlcTabToneLevelIdxHi2.table = &qdm2_table[qdm2_vlc_offs[9]];
+	_vlcTabToneLevelIdxHi2.table_allocated = qdm2_vlc_offs[10] - qdm2_vlc_offs[9];
+	_vlcTabToneLevelIdxHi2.table_size = 0;
+	initVlcSparse(&_vlcTabToneLevelIdxHi2, 8, 24,
+		vlc_tab_tone_level_idx_hi2_huffbits, 1, 1,
+		vlc_tab_tone_level_idx_hi2_huffcodes, 2, 2, NULL, 0, 0);
+
+	_vlcTabType30.table = &qdm2_table[qdm2_vlc_offs[10]];
+	_vlcTabType30.table_allocated = qdm2_vlc_offs[11] - qdm2_vlc_offs[10];
+	_vlcTabType30.table_size = 0;
+	initVlcSparse(&_vlcTabType30, 6, 9,
+		vlc_tab_type30_huffbits, 1, 1,
+		vlc_tab_type30_huffcodes, 1, 1, NULL, 0, 0);
+
+	_vlcTabType34.table = &qdm2_table[qdm2_vlc_offs[11]];
+	_vlcTabType34.table_allocated = qdm2_vlc_offs[12] - qdm2_vlc_offs[11];
+	_vlcTabType34.table_size = 0;
+	initVlcSparse(&_vlcTabType34, 5, 10,
+		vlc_tab_type34_huffbits, 1, 1,
+		vlc_tab_type34_huffcodes, 1, 1, NULL, 0, 0);
+
+	_vlcTabFftToneOffset[0].table = &qdm2_table[qdm2_vlc_offs[12]];
+	_vlcTabFftToneOffset[0].table_allocated = qdm2_vlc_offs[13] - qdm2_vlc_offs[12];
+	_vlcTabFftToneOffset[0].table_size = 0;
+	initVlcSparse(&_vlcTabFftToneOffset[0], 8, 23,
+		vlc_tab_fft_tone_offset_0_huffbits, 1, 1,
+		vlc_tab_fft_tone_offset_0_huffcodes, 2, 2, NULL, 0, 0);
+
+	_vlcTabFftToneOffset[1].table = &qdm2_table[qdm2_vlc_offs[13]];
+	_vlcTabFftToneOffset[1].table_allocated = qdm2_vlc_offs[14] - qdm2_vlc_offs[13];
+	_vlcTabFftToneOffset[1].table_size = 0;
+	initVlcSparse(&_vlcTabFftToneOffset[1], 8, 28,
+		vlc_tab_fft_tone_offset_1_huffbits, 1, 1,
+		vlc_tab_fft_tone_offset_1_huffcodes, 2, 2, NULL, 0, 0);
+
+	_vlcTabFftToneOffset[2].table = &qdm2_table[qdm2_vlc_offs[14]];
+	_vlcTabFftToneOffset[2].table_allocated = qdm2_vlc_offs[15] - qdm2_vlc_offs[14];
+	_vlcTabFftToneOffset[2].table_size = 0;
+	initVlcSparse(&_vlcTabFftToneOffset[2], 8, 32,
+		vlc_tab_fft_tone_offset_2_huffbits, 1, 1,
+		vlc_tab_fft_tone_offset_2_huffcodes, 2, 2, NULL, 0, 0);
+
+	_vlcTabFftToneOffset[3].table = &qdm2_table[qdm2_vlc_offs[15]];
+	_vlcTabFftToneOffset[3].table_allocated = qdm2_vlc_offs[16] - qdm2_vlc_offs[15];
+	_vlcTabFftToneOffset[3].table_size = 0;
+	initVlcSparse(&_vlcTabFftToneOffset[3], 8, 35,
+		vlc_tab_fft_tone_offset_3_huffbits, 1, 1,
+		vlc_tab_fft_tone_offset_3_huffcodes, 2, 2, NULL, 0, 0);
+
+	_vlcTabFftToneOffset[4].table = &qdm2_table[qdm2_vlc_offs[16]];
+	_vlcTabFftToneOffset[4].table_allocated = qdm2_vlc_offs[17] - qdm2_vlc_offs[16];
+	_vlcTabFftToneOffset[4].table_size = 0;
+	initVlcSparse(&_vlcTabFftToneOffset[4], 8, 38,
+		vlc_tab_fft_tone_offset_4_huffbits, 1, 1,
+		vlc_tab_fft_tone_offset_4_huffcodes, 2, 2, NULL, 0, 0);
 }
 
 QDM2Stream::QDM2Stream(Common::SeekableReadStream *stream, Common::SeekableReadStream *extraData) {
@@ -1524,7 +1586,9 @@ QDM2Stream::QDM2Stream(Common::SeekableReadStream *stream, Common::SeekableReadS
 	memset(_synthBufOffset, 0, sizeof(_synthBufOffset));
 	memset(_sbSamples, 0, sizeof(_sbSamples));
 	memset(_outputBuffer, 0, sizeof(_outputBuffer));
-	_vlcsInitialized = false;
+	_outputSamplesPos = 0;
+	_outputSamplesCount = 0;
+	_endOfStream = false;
 	_superblocktype_2_3 = 0;
 	_hasErrors = false;
 
@@ -1670,18 +1734,21 @@ QDM2Stream::QDM2Stream(Common::SeekableReadStream *stream, Common::SeekableReadS
 	if (_fftOrder < 7 || _fftOrder > 9)
 		error("QDM2Stream::QDM2Stream() Unsupported fft_order: %d", _fftOrder);
 
+	// _outputSamples holds one frame, _outputBuffer two
+	if (_sFrameSize * _channels > ARRAYSIZE(_outputSamples))
+		error("QDM2Stream::QDM2Stream() Unsupported frame size: %d", _sFrameSize * _channels);
+
 	rdftInit(&_rdftCtx, _fftOrder, IRDFT);
 
-	initVlc();
-	ff_mpa_synth_init(ff_mpa_synth_window);
-	softclipTableInit();
-	rndTableInit();
-	initNoiseSamples();
+	initTables();
 
-	_compressedData = new uint8[_packetSize];
+	// The bit reader reads up to four bytes past the end of the packet
+	_compressedData = new uint8[_packetSize + FF_INPUT_BUFFER_PADDING_SIZE];
+	memset(_compressedData + _packetSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
 }
 
 QDM2Stream::~QDM2Stream() {
+	rdftEnd(&_rdftCtx);
 	delete[] _compressedData;
 	delete _stream;
 }
@@ -1818,11 +1885,53 @@ void QDM2Stream::build_sb_samples_from_noise(int sb) {
 	if (!_channels)
 		return;
 
+	// Same as SB_DITHERING_NOISE, with the table lookups hoisted out of
+	// the loop. The noise index stays below 3840 + 2 * 128 < 4096.
+	const float attenuation = sb_noise_attenuation[sb];
+
 	for (ch = 0; ch < _channels; ch++) {
-		for (j = 0; j < 64; j++) {
-			_sbSamples[ch][j * 2][sb] = (int32)(SB_DITHERING_NOISE(sb, _noiseIdx) * _toneLevel[ch][sb][j] + .5);
-			_sbSamples[ch][j * 2 + 1][sb] = (int32)(SB_DITHERING_NOISE(sb, _noiseIdx) * _toneLevel[ch][sb][j] + .5);
+		const float *noise = &_noiseTable[_noiseIdx];
+		const float *toneLevel = _toneLevel[ch][sb];
+
+		j = 0;
+
+		// Two samples share each tone level. The rounding is done in double
+		// precision like the scalar loop below, so that the output is the same.
+#if defined(MOHAWK_QDM2_SSE2)
+		const __m128 att = _mm_set1_ps(attenuation);
+		const __m128d half = _mm_set1_pd(.5);
+		for (; j + 4 <= 128; j += 4) {
+			const __m128 level = _mm_setr_ps(toneLevel[j / 2], toneLevel[j / 2], toneLevel[j / 2 + 1], toneLevel[j / 2 + 1]);
+			const __m128 v = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(&noise[j]), att), level);
+			int32 out[4];
+			_mm_storel_epi64((__m128i *)&out[0], _mm_cvttpd_epi32(_mm_add_pd(_mm_cvtps_pd(v), half)));
+			_mm_storel_epi64((__m128i *)&out[2], _mm_cvttpd_epi32(_mm_add_pd(_mm_cvtps_pd(_mm_movehl_ps(v, v)), half)));
+			_sbSamples[ch][j][sb] = out[0];
+			_sbSamples[ch][j + 1][sb] = out[1];
+			_sbSamples[ch][j + 2][sb] = out[2];
+			_sbSamples[ch][j + 3][sb] = out[3];
+		}
+#elif defined(MOHAWK_QDM2_NEON) && defined(__aarch64__)
+		const float32x4_t att = vdupq_n_f32(attenuation);
+		const float64x2_t half = vdupq_n_f64(.5);
+		for (; j + 4 <= 128; j += 4) {
+			const float32x4_t level = vcombine_f32(vdup_n_f32(toneLevel[j / 2]), vdup_n_f32(toneLevel[j / 2 + 1]));
+			const float32x4_t v = vmulq_f32(vmulq_f32(vld1q_f32(&noise[j]), att), level);
+			const int64x2_t lo = vcvtq_s64_f64(vaddq_f64(vcvt_f64_f32(vget_low_f32(v)), half));
+			const int64x2_t hi = vcvtq_s64_f64(vaddq_f64(vcvt_high_f64_f32(v), half));
+			int32 out[4];
+			vst1q_s32(out, vcombine_s32(vmovn_s64(lo), vmovn_s64(hi)));
+			_sbSamples[ch][j][sb] = out[0];
+			_sbSamples[ch][j + 1][sb] = out[1];
+			_sbSamples[ch][j + 2][sb] = out[2];
+			_sbSamples[ch][j + 3][sb] = out[3];
 		}
+#endif
+
+		for (; j < 128; j++)
+			_sbSamples[ch][j][sb] = (int32)(noise[j] * attenuation * toneLevel[j / 2] + .5);
+
+		_noiseIdx += 128;
 	}
 }
 
@@ -2903,11 +3012,29 @@ void QDM2Stream::qdm2_calculate_fft(int channel) {
 	//debug(1, "QDM2Stream::qdm2_calculate_fft _fft.complex[channel][0].re: %lf", _fft.complex[channel][0].re);
 	//debug(1, "QDM2Stream::qdm2_calculate_fft _fft.complex[channel][0].im: %lf", _fft.complex[channel][0].im);
 
-	rdftCalc(&_rdftCtx, (float *)_fft.complex[channel]);
+	float *samples = (float *)_fft.complex[channel];
+	rdftCalc(&_rdftCtx, samples);
 
 	// add samples to output buffer
-	for (i = 0; i < ((_fftFrameSize + 15) & ~15); i++)
-		_outputBuffer[_channels * i + channel] += ((float *) _fft.complex[channel])[i] * gain;
+	const int count = (_fftFrameSize + 15) & ~15;
+
+	if (_channels == 1) {
+		i = 0;
+#if defined(MOHAWK_QDM2_SSE2)
+		const __m128 g = _mm_set1_ps(gain);
+		for (; i + 4 <= count; i += 4)
+			_mm_storeu_ps(&_outputBuffer[i], _mm_add_ps(_mm_loadu_ps(&_outputBuffer[i]), _mm_mul_ps(_mm_loadu_ps(&samples[i]), g)));
+#elif defined(MOHAWK_QDM2_NEON)
+		const float32x4_t g = vdupq_n_f32(gain);
+		for (; i + 4 <= count; i += 4)
+			vst1q_f32(&_outputBuffer[i], vaddq_f32(vld1q_f32(&_outputBuffer[i]), vmulq_f32(vld1q_f32(&samples[i]), g)));
+#endif
+		for (; i < count; i++)
+			_outputBuffer[i] += samples[i] * gain;
+	} else {
+		for (i = 0; i < count; i++)
+			_outputBuffer[_channels * i + channel] += samples[i] * gain;
+	}
 }
 
 /**
@@ -3026,7 +3153,6 @@ int QDM2Stream::qdm2_decodeFrame(Common::SeekableReadStream *in) {
 */
 
 	for (i = 0; i < frame_size; i++) {
-		//debug(1, "QDM2Stream::qdm2_decodeFrame i: %d", i);
 		int value = (int)_outputBuffer[i];
 
 		if (value > SOFTCLIP_THRESHOLD)
@@ -3034,30 +3160,67 @@ int QDM2Stream::qdm2_decodeFrame(Common::SeekableReadStream *in) {
 		else if (value < -SOFTCLIP_THRESHOLD)
 			value = (value < -HARDCLIP_THRESHOLD) ? -32767 : -_softclipTable[-value - SOFTCLIP_THRESHOLD];
 
-		_outputSamples.push_back(value);
+		_outputSamples[i] = value;
 	}
+
+	_outputSamplesPos = 0;
+	_outputSamplesCount = frame_size;
 	return frame_size;
 }
 
 int QDM2Stream::readBuffer(int16 *buffer, const int numSamples) {
 	debug(1, "QDM2Stream::readBuffer numSamples: %d", numSamples);
-	int32 decodedSamples = _outputSamples.size();
-	int32 i;
+	int samples = 0;
+
+	// Only decode as many frames as needed, and copy the samples frame by frame
+	while (samples < numSamples) {
+		if (_outputSamplesPos == _outputSamplesCount) {
+			if (_endOfStream || qdm2_decodeFrame(_stream) == 0) {
+				_endOfStream = true; // Out Of Decode Frames...
+				break;
+			}
+		}
 
-	//while((int)_outputSamples.size() < numSamples) {
-	while(!_stream->eos() && _stream->pos() != _stream->size()) {
-		i = qdm2_decodeFrame(_stream);
-		if(i == 0)
-			break; // Out Of Decode Frames...
-		decodedSamples += i;
+		int count = MIN(numSamples - samples, _outputSamplesCount - _outputSamplesPos);
+		memcpy(buffer + samples, _outputSamples + _outputSamplesPos, count * sizeof(int16));
+		_outputSamplesPos += count;
+		samples += count;
 	}
-	if(decodedSamples > numSamples)
-		decodedSamples = numSamples;
 
-	for(i = 0; i < decodedSamples; i++)
-		buffer[i] = _outputSamples.remove_at(0);
+	return samples;
+}
+
+Audio::AudioStream *makeDecodedQDM2Stream(Common::SeekableReadStream *stream, Common::SeekableReadStream *extraData) {
+	QDM2Stream *qdm2 = new QDM2Stream(stream, extraData);
+	int rate = qdm2->getRate();
+	bool stereo = qdm2->isStereo();
+
+	int size = 0;
+	int capacity = 16384;
+	int16 *data = (int16 *)malloc(capacity * sizeof(int16));
+
+	for (;;) {
+		if (size == capacity) {
+			capacity *= 2;
+			data = (int16 *)realloc(data, capacity * sizeof(int16));
+		}
+
+		int samples = qdm2->readBuffer(data + size, capacity - size);
+		if (samples == 0)
+			break;
+		size += samples;
+	}
+
+	delete qdm2;
+
+	byte flags = Audio::FLAG_16BITS;
+	if (stereo)
+		flags |= Audio::FLAG_STEREO;
+#ifdef SCUMM_LITTLE_ENDIAN
+	flags |= Audio::FLAG_LITTLE_ENDIAN;
+#endif
 
-	return decodedSamples;
+	return Audio::makeRawStream((byte *)data, size * sizeof(int16), rate, flags);
 }
 
 } // End of namespace Mohawk
@@ -144,13 +144,16 @@ struct RDFTContext {
 	FFTContext fft;
 };
 
+/**
+ * Decodes a QDM2 stream frame by frame, as the samples are read.
+ */
 class QDM2Stream : public Audio::AudioStream {
 public:
 	QDM2Stream(Common::SeekableReadStream *stream, Common::SeekableReadStream *extraData);
 	~QDM2Stream();
 
 	bool isStereo() const { return _channels == 2; }
-	bool endOfData() const { return ((_stream->pos() == _stream->size()) && (_outputSamples.size() == 0)); }
+	bool endOfData() const { return _outputSamplesPos == _outputSamplesCount && (_endOfStream || _stream->pos() == _stream->size()); }
 	int getRate() const { return _sampleRate; }
 	int readBuffer(int16 *buffer, const int numSamples);
 
@@ -198,10 +201,13 @@ private:
 	// I/O data
 	uint8 *_compressedData;
 	float _outputBuffer[1024];
-	Common::Array<int16> _outputSamples;
+	int16 _outputSamples[512]; // the samples of the last decoded frame
+	int _outputSamplesPos;
+	int _outputSamplesCount;
+	bool _endOfStream;
 
 	// Synthesis filter
-	int16 ff_mpa_synth_window[512];
+	static int16 ff_mpa_synth_window[512];
 	int16 _synthBuf[MPA_MAX_CHANNELS][512*2];
 	int _synthBufOffset[MPA_MAX_CHANNELS];
 	int32 _sbSamples[MPA_MAX_CHANNELS][128][32];
@@ -227,32 +233,36 @@ private:
 
 	byte _emptyBuffer[FF_INPUT_BUFFER_PADDING_SIZE];
 
-	VLC _vlcTabLevel;
-	VLC _vlcTabDiff;
-	VLC _vlcTabRun;
-	VLC _fftLevelExpAltVlc;
-	VLC _fftLevelExpVlc;
-	VLC _fftStereoExpVlc;
-	VLC _fftStereoPhaseVlc;
-	VLC _vlcTabToneLevelIdxHi1;
-	VLC _vlcTabToneLevelIdxMid;
-	VLC _vlcTabToneLevelIdxHi2;
-	VLC _vlcTabType30;
-	VLC _vlcTabType34;
-	VLC _vlcTabFftToneOffset[5];
-	bool _vlcsInitialized;
-	void initVlc(void);
-
-	uint16 _softclipTable[HARDCLIP_THRESHOLD - SOFTCLIP_THRESHOLD + 1];
-	void softclipTableInit(void);
-
-	float _noiseTable[4096];
-	byte _randomDequantIndex[256][5];
-	byte _randomDequantType24[128][3];
-	void rndTableInit(void);
-
-	float _noiseSamples[128];
-	void initNoiseSamples(void);
+	// The tables below do not depend on the stream, and are shared by all
+	// streams. They are initialized by the first stream created.
+	static bool _tablesInitialized;
+	static void initTables(void);
+
+	static VLC _vlcTabLevel;
+	static VLC _vlcTabDiff;
+	static VLC _vlcTabRun;
+	static VLC _fftLevelExpAltVlc;
+	static VLC _fftLevelExpVlc;
+	static VLC _fftStereoExpVlc;
+	static VLC _fftStereoPhaseVlc;
+	static VLC _vlcTabToneLevelIdxHi1;
+	static VLC _vlcTabToneLevelIdxMid;
+	static VLC _vlcTabToneLevelIdxHi2;
+	static VLC _vlcTabType30;
+	static VLC _vlcTabType34;
+	static VLC _vlcTabFftToneOffset[5];
+	static void initVlc(void);
+
+	static uint16 _softclipTable[HARDCLIP_THRESHOLD - SOFTCLIP_THRESHOLD + 1];
+	static void softclipTableInit(void);
+
+	static float _noiseTable[4096];
+	static byte _randomDequantIndex[256][5];
+	static byte _randomDequantType24[128][3];
+	static void rndTableInit(void);
+
+	static float _noiseSamples[128];
+	static void initNoiseSamples(void);
 
 	RDFTContext _rdftCtx;
 
@@ -283,6 +293,15 @@ private:
 	int qdm2_decodeFrame(Common::SeekableReadStream *in);
 };
 
+/**
+ * Decode a QDM2 stream completely, and return the decoded samples as a
+ * raw audio stream. This takes the decoding out of the mixer callback.
+ *
+ * @param stream	the QDM2 stream, which is deleted afterwards
+ * @param extraData	the codec header of the stream
+ */
+Audio::AudioStream *makeDecodedQDM2Stream(Common::SeekableReadStream *stream, Common::SeekableReadStream *extraData);
+
 } // End of namespace Mohawk
 
 #endif
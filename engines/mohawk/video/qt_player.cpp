@@ -56,7 +56,7 @@ namespace Mohawk {
 // QTPlayer
 ////////////////////////////////////////////
 
-QTPlayer::QTPlayer() {
+QTPlayer::QTPlayer(Audio::Mixer *mixer) : _mixer(mixer) {
 	_audStream = NULL;
 	_beginOffset = 0;
 	_videoCodec = NULL;
@@ -191,19 +191,19 @@ void QTPlayer::startAudio() {
 	if (!_audStream) // No audio/audio not supported
 		return;
 
-	g_system->getMixer()->playInputStream(Audio::Mixer::kPlainSoundType, &_audHandle, _audStream);
+	_mixer->playInputStream(Audio::Mixer::kPlainSoundType, &_audHandle, _audStream);
 }
 
 void QTPlayer::pauseAudio() {
-	g_system->getMixer()->pauseHandle(_audHandle, true);
+	_mixer->pauseHandle(_audHandle, true);
 }
 
 void QTPlayer::resumeAudio() {
-	g_system->getMixer()->pauseHandle(_audHandle, false);
+	_mixer->pauseHandle(_audHandle, false);
 }
 
 void QTPlayer::stopAudio() {
-	g_system->getMixer()->stopHandle(_audHandle);
+	_mixer->stopHandle(_audHandle);
 	_audStream = NULL; // the mixer automatically frees the stream
 }
 
@@ -1173,8 +1173,10 @@ Audio::AudioStream *QTPlayer::createAudioStream(Common::SeekableReadStream *stre
 		// Riven uses this codec (as do some Myst ME videos)
 		return Audio::makeADPCMStream(stream, DisposeAfterUse::YES, stream->size(), Audio::kADPCMApple, _streams[_audioStreamIndex]->sample_rate, _streams[_audioStreamIndex]->channels, 34);
 	} else if (_streams[_audioStreamIndex]->codec_tag == MKID_BE('QDM2')) {
-		// Several Myst ME videos use this codec
-		return new QDM2Stream(stream, _streams[_audioStreamIndex]->extradata);
+		// Several Myst ME videos use this codec. The chunk is decoded right
+		// away, while the previously queued chunk plays, so that the mixer
+		// callback only has to copy the samples.
+		return makeDecodedQDM2Stream(stream, _streams[_audioStreamIndex]->extradata);
 	}
 
 	error("Unsupported audio codec");
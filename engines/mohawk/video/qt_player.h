@@ -54,7 +54,7 @@ enum ScaleMode {
 
 class QTPlayer {
 public:
-	QTPlayer();
+	QTPlayer(Audio::Mixer *mixer);
 	virtual ~QTPlayer();
 
 	/**
@@ -245,6 +245,7 @@ protected:
 	Common::SeekableReadStream *getNextFramePacket();
 	uint32 getFrameDuration();
 
+	Audio::Mixer *_mixer;
 	Audio::QueuingAudioStream *_audStream;
 	int8 _videoStreamIndex;
 	int8 _audioStreamIndex;
@@ -33,6 +33,7 @@
 #include "common/system.h"
 #include "graphics/colormasks.h"
 #include "graphics/surface.h"
+#include "graphics/surfacepool.h"
 
 namespace Mohawk {
 
@@ -47,8 +48,8 @@ QTRLEDecoder::QTRLEDecoder(uint16 width, uint16 height, byte bitsPerPixel) : Gra
 
 	debug(2, "QTRLE corrected width: %d", width);
 
-	_surface = new Graphics::Surface();
-	_surface->create(width, height, _bitsPerPixel <= 8 ? 1 : _pixelFormat.bytesPerPixel);
+	_surface = SurfacePoolMan.acquire(width, height, _bitsPerPixel <= 8 ? 1 : _pixelFormat.bytesPerPixel);
+	memset(_surface->pixels, 0, _surface->pitch * _surface->h);
 }
 
 #define CHECK_STREAM_PTR(n) \
@@ -414,7 +415,7 @@ Graphics::Surface *QTRLEDecoder::decodeImage(Common::SeekableReadStream *stream)
 }
 
 QTRLEDecoder::~QTRLEDecoder() {
-	_surface->free();
+	SurfacePoolMan.release(_surface);
 }
 
 } // End of namespace Mohawk
@@ -29,6 +29,7 @@
 
 #include "common/system.h"
 #include "graphics/colormasks.h"
+#include "graphics/surfacepool.h"
 
 namespace Mohawk {
 
@@ -42,8 +43,12 @@ RPZADecoder::RPZADecoder(uint16 width, uint16 height) : Graphics::Codec() {
 
 	debug(2, "RPZA corrected width: %d", width);
 
-	_surface = new Graphics::Surface();
-	_surface->create(width, height, _pixelFormat.bytesPerPixel);
+	_surface = SurfacePoolMan.acquire(width, height, _pixelFormat.bytesPerPixel);
+	memset(_surface->pixels, 0, _surface->pitch * _surface->h);
+}
+
+RPZADecoder::~RPZADecoder() {
+	SurfacePoolMan.release(_surface);
 }
 
 #define ADVANCE_BLOCK() \
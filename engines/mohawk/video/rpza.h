@@ -34,7 +34,7 @@ namespace Mohawk {
 class RPZADecoder : public Graphics::Codec {
 public:
 	RPZADecoder(uint16 width, uint16 height);
-	~RPZADecoder() { delete _surface; }
+	~RPZADecoder();
 
 	Graphics::Surface *decodeImage(Common::SeekableReadStream *stream);
 
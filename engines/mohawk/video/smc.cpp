@@ -27,6 +27,8 @@
 
 #include "mohawk/video/smc.h"
 
+#include "graphics/surfacepool.h"
+
 namespace Mohawk {
 
 #define GET_BLOCK_COUNT() \
@@ -47,8 +49,12 @@ namespace Mohawk {
 }
 
 SMCDecoder::SMCDecoder(uint16 width, uint16 height) {
-	_surface = new Graphics::Surface();
-	_surface->create(width, height, 1);
+	_surface = SurfacePoolMan.acquire(width, height, 1);
+	memset(_surface->pixels, 0, _surface->pitch * _surface->h);
+}
+
+SMCDecoder::~SMCDecoder() {
+	SurfacePoolMan.release(_surface);
 }
 
 Graphics::Surface *SMCDecoder::decodeImage(Common::SeekableReadStream *stream) {
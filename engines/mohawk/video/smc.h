@@ -40,7 +40,7 @@ enum {
 class SMCDecoder : public Graphics::Codec {
 public:
 	SMCDecoder(uint16 width, uint16 height);
-	~SMCDecoder() { delete _surface; }
+	~SMCDecoder();
 
 	Graphics::Surface *decodeImage(Common::SeekableReadStream *stream);
 
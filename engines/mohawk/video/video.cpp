@@ -29,6 +29,8 @@
 
 #include "common/events.h"
 
+#include "graphics/surfacepool.h"
+
 namespace Mohawk {
 
 VideoManager::VideoManager(MohawkEngine* vm) : _vm(vm) {
@@ -172,12 +174,11 @@ bool VideoManager::updateBackgroundMovies() {
 			if (frame && _videoStreams[i].enabled) {
 				// Convert from 8bpp to the current screen format if necessary
 				if (frame->bytesPerPixel == 1) {
-					Graphics::Surface *newFrame = new Graphics::Surface();
 					Graphics::PixelFormat pixelFormat = _vm->_system->getScreenFormat();
 					byte *palette = _videoStreams[i]->getPalette();
 					assert(palette);
 
-					newFrame->create(frame->w, frame->h, pixelFormat.bytesPerPixel);
+					Graphics::Surface *newFrame = SurfacePoolMan.acquire(frame->w, frame->h, pixelFormat.bytesPerPixel);
 
 					for (uint16 j = 0; j < frame->h; j++) {
 						for (uint16 k = 0; k < frame->w; k++) {
@@ -201,15 +202,14 @@ bool VideoManager::updateBackgroundMovies() {
 				if (_videoStreams[i]->getScaleMode() == kScaleHalf || _videoStreams[i]->getScaleMode() == kScaleQuarter) {
 					byte scaleFactor = (_videoStreams[i]->getScaleMode() == kScaleHalf) ? 2 : 4;
 
-					Graphics::Surface scaledSurf;
-					scaledSurf.create(_videoStreams[i]->getWidth() / scaleFactor, _videoStreams[i]->getHeight() / scaleFactor, frame->bytesPerPixel);
+					Graphics::Surface *scaledSurf = SurfacePoolMan.acquire(_videoStreams[i]->getWidth() / scaleFactor, _videoStreams[i]->getHeight() / scaleFactor, frame->bytesPerPixel);
 
-					for (uint32 j = 0; j < scaledSurf.h; j++)
-						for (uint32 k = 0; k < scaledSurf.w; k++)
-							memcpy(scaledSurf.getBasePtr(k, j), frame->getBasePtr(k * scaleFactor, j * scaleFactor), frame->bytesPerPixel);
+					for (uint32 j = 0; j < scaledSurf->h; j++)
+						for (uint32 k = 0; k < scaledSurf->w; k++)
+							memcpy(scaledSurf->getBasePtr(k, j), frame->getBasePtr(k * scaleFactor, j * scaleFactor), frame->bytesPerPixel);
 
-					_vm->_system->copyRectToScreen((byte*)scaledSurf.pixels, scaledSurf.pitch, _videoStreams[i].x, _videoStreams[i].y, scaledSurf.w, scaledSurf.h);
-					scaledSurf.free();
+					_vm->_system->copyRectToScreen((byte*)scaledSurf->pixels, scaledSurf->pitch, _videoStreams[i].x, _videoStreams[i].y, scaledSurf->w, scaledSurf->h);
+					SurfacePoolMan.release(scaledSurf);
 				} else {
 					// Clip the width/height to make sure we stay on the screen (Myst does this a few times)
 					uint16 width = MIN<int32>(_videoStreams[i]->getWidth(), _vm->_system->getWidth() - _videoStreams[i].x);
@@ -221,10 +221,8 @@ bool VideoManager::updateBackgroundMovies() {
 				updateScreen = true;
 
 				// Delete the frame if we're using the buffer from the 8bpp conversion
-				if (deleteFrame) {
-					frame->free();
-					delete frame;
-				}
+				if (deleteFrame)
+					SurfacePoolMan.release(frame);
 			}
 		}
 
@@ -338,7 +336,7 @@ VideoHandle VideoManager::createVideoHandle(uint16 id, uint16 x, uint16 y, bool
 
 	// Otherwise, create a new entry
 	VideoEntry entry;
-	entry.video = new QTPlayer();
+	entry.video = new QTPlayer(_vm->_mixer);
 	entry.x = x;
 	entry.y = y;
 	entry.filename = "";
@@ -369,7 +367,7 @@ VideoHandle VideoManager::createVideoHandle(Common::String filename, uint16 x, u
 
 	// Otherwise, create a new entry
 	VideoEntry entry;
-	entry.video = new QTPlayer();
+	entry.video = new QTPlayer(_vm->_mixer);
 	entry.x = x;
 	entry.y = y;
 	entry.filename = filename;
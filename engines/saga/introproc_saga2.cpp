@@ -33,6 +33,7 @@
 
 #include "sound/mixer.h"
 #include "graphics/surface.h"
+#include "graphics/video/async_decoder.h"
 #include "graphics/video/smk_decoder.h"
 
 namespace Saga {
@@ -40,7 +41,10 @@ namespace Saga {
 int Scene::DinoStartProc() {
 	_vm->_gfx->showCursor(false);
 
-	Graphics::SmackerDecoder *smkDecoder = new Graphics::SmackerDecoder(_vm->_mixer);
+	// The videos are decoded ahead in the background, so that their frames
+	// are ready in time even on slow machines
+
+	Graphics::AsyncVideoDecoder *smkDecoder = new Graphics::AsyncVideoDecoder(new Graphics::SmackerDecoder(_vm->_mixer));
 	Graphics::VideoPlayer *player = new Graphics::VideoPlayer(smkDecoder);
 	if (smkDecoder->loadFile("testvid.smk"))
 		player->playVideo();        // Play introduction
@@ -57,7 +61,7 @@ int Scene::DinoStartProc() {
 int Scene::FTA2StartProc() {
 	_vm->_gfx->showCursor(false);
 
-	Graphics::SmackerDecoder *smkDecoder = new Graphics::SmackerDecoder(_vm->_mixer);
+	Graphics::AsyncVideoDecoder *smkDecoder = new Graphics::AsyncVideoDecoder(new Graphics::SmackerDecoder(_vm->_mixer));
 	Graphics::VideoPlayer *player = new Graphics::VideoPlayer(smkDecoder);
 	if (smkDecoder->loadFile("trimark.smk"))
 		player->playVideo();      // Show Ignite logo
@@ -100,7 +104,7 @@ int Scene::FTA2EndProc(FTA2Endings whichEnding) {
 	_vm->_gfx->showCursor(false);
 
 	// Play ending
-	Graphics::SmackerDecoder *smkDecoder = new Graphics::SmackerDecoder(_vm->_mixer);
+	Graphics::AsyncVideoDecoder *smkDecoder = new Graphics::AsyncVideoDecoder(new Graphics::SmackerDecoder(_vm->_mixer));
 	Graphics::VideoPlayer *player = new Graphics::VideoPlayer(smkDecoder);
 	if (smkDecoder->loadFile(videoName)) {
 		player->playVideo();
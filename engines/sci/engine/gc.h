@@ -27,7 +27,7 @@
 #ifndef SCI_ENGINE_GC_H
 #define SCI_ENGINE_GC_H
 
-#include "common/hashmap.h"
+#include "common/flathashmap.h"
 #include "sci/engine/vm_types.h"
 #include "sci/engine/state.h"
 
@@ -46,9 +46,11 @@ struct reg_t_Hash {
 };
 
 /*
- * The reg_t_hash_map is actually really a hashset
+ * The reg_t_hash_map is actually really a hashset. It is filled and probed
+ * heavily during garbage collection, so we use the flat variant which
+ * avoids a node allocation per entry.
  */
-typedef Common::HashMap<reg_t, bool, reg_t_Hash, reg_t_EqualTo> reg_t_hash_map;
+typedef Common::FlatHashMap<reg_t, bool, reg_t_Hash, reg_t_EqualTo> reg_t_hash_map;
 
 /**
  * Finds all used references and normalises them to their memory addresses
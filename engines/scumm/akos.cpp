@@ -341,6 +341,9 @@ void AkosRenderer::setCostume(int costume, int shadow) {
 	const byte *akos = _vm->getResourceAddress(rtCostume, costume);
 	assert(akos);
 
+	_celCostume = costume;
+	_celBase = akos;
+
 	akhd = (const AkosHeader *) _vm->findResourceData(MKID_BE('AKHD'), akos);
 	akof = (const AkosOffset *) _vm->findResourceData(MKID_BE('AKOF'), akos);
 	akci = _vm->findResourceData(MKID_BE('AKCI'), akos);
@@ -541,12 +544,40 @@ byte AkosRenderer::drawLimb(const Actor *a, int limb) {
 	return result;
 }
 
+inline void AkosRenderer::codec1_putPixel(byte *dst, uint16 color) {
+	uint16 pcolor = _palette[color];
+
+	if (_shadow_mode == 1) {
+		if (pcolor == 13)
+			pcolor = _shadow_table[*dst];
+	} else if (_shadow_mode == 2) {
+		error("codec1_spec2"); // TODO
+	} else if (_shadow_mode == 3) {
+		if (_vm->_game.features & GF_16BIT_COLOR) {
+			uint16 srcColor = (pcolor >> 1) & 0x7DEF;
+			uint16 dstColor = (READ_UINT16(dst) >> 1) & 0x7DEF;
+			pcolor = srcColor + dstColor;
+		} else if (_vm->_game.heversion >= 90) {
+			pcolor = (pcolor << 8) + *dst;
+			pcolor = xmap[pcolor];
+		} else if (pcolor < 8) {
+			pcolor = (pcolor << 8) + *dst;
+			pcolor = _shadow_table[pcolor];
+		}
+	}
+	if (_vm->_bytesPerPixel == 2) {
+		WRITE_UINT16(dst, pcolor);
+	} else {
+		*dst = pcolor;
+	}
+}
+
 void AkosRenderer::codec1_genericDecode(Codec1 &v1) {
 	const byte *mask, *src;
 	byte *dst;
 	byte len, maskbit;
 	int y;
-	uint16 color, height, pcolor;
+	uint16 color, height;
 	const byte *scaleytab;
 	bool masked;
 	bool skip_column = false;
@@ -582,32 +613,8 @@ void AkosRenderer::codec1_genericDecode(Codec1 &v1) {
 				} else {
 					masked = (y < v1.boundsRect.top || y >= v1.boundsRect.bottom) || (v1.x < 0 || v1.x >= v1.boundsRect.right) || (*mask & maskbit);
 
-					if (color && !masked && !skip_column) {
-						pcolor = _palette[color];
-						if (_shadow_mode == 1) {
-							if (pcolor == 13)
-								pcolor = _shadow_table[*dst];
-						} else if (_shadow_mode == 2) {
-							error("codec1_spec2"); // TODO
-						} else if (_shadow_mode == 3) {
-							if (_vm->_game.features & GF_16BIT_COLOR) {
-								uint16 srcColor = (pcolor >> 1) & 0x7DEF;
-								uint16 dstColor = (READ_UINT16(dst) >> 1) & 0x7DEF;
-								pcolor = srcColor + dstColor;
-							} else if (_vm->_game.heversion >= 90) {
-								pcolor = (pcolor << 8) + *dst;
-								pcolor = xmap[pcolor];
-							} else if (pcolor < 8) {
-								pcolor = (pcolor << 8) + *dst;
-								pcolor = _shadow_table[pcolor];
-							}
-						}
-						if (_vm->_bytesPerPixel == 2) {
-							WRITE_UINT16(dst, pcolor);
-						} else {
-							*dst = pcolor;
-						}
-					}
+					if (color && !masked && !skip_column)
+						codec1_putPixel(dst, color);
 				}
 				dst += _out.pitch;
 				mask += _numStrips;
@@ -639,6 +646,66 @@ void AkosRenderer::codec1_genericDecode(Codec1 &v1) {
 	} while (1);
 }
 
+/**
+ * Variant of codec1_genericDecode which draws a cel decoded by the frame
+ * cache. Which rows survive scaling, and which of them lie within the
+ * bounds, is the same for every column, so that is only worked out once.
+ */
+void AkosRenderer::codec1_blitCached(Codec1 &v1) {
+	const byte *src = v1.pixels;
+	const byte *mask;
+	byte *dst;
+	byte maskbit;
+	int numRows, first, last, i;
+	bool skip_column = false;
+
+	_celRows.resize(_height);
+	numRows = 0;
+	for (i = 0; i < _height; i++) {
+		if (_scaleY == 255 || v1.scaletable[v1.scaleYindex + i] < _scaleY)
+			_celRows[numRows++] = i;
+	}
+
+	first = MAX(0, v1.boundsRect.top - v1.y);
+	last = MIN(numRows, v1.boundsRect.bottom - v1.y);
+
+	do {
+		if (_actorHitMode) {
+			i = _actorHitY - v1.y;
+			if (v1.x == _actorHitX && i >= 0 && i < numRows && src[_celRows[i]]) {
+				_actorHitResult = true;
+				return;
+			}
+		} else if (!skip_column && first < last && v1.x >= 0 && v1.x < v1.boundsRect.right) {
+			maskbit = revBitMask(v1.x & 7);
+			mask = _vm->getMaskBuffer(v1.x - (_vm->_virtscr[kMainVirtScreen].xstart & 7), v1.y + first, _zbuf);
+			dst = v1.destptr + first * _out.pitch;
+
+			for (i = first; i < last; i++) {
+				const byte color = src[_celRows[i]];
+				if (color && !(*mask & maskbit))
+					codec1_putPixel(dst, color);
+				dst += _out.pitch;
+				mask += _numStrips;
+			}
+		}
+		src += _height;
+
+		if (!--v1.skip_width)
+			return;
+
+		if (_scaleX == 255 || v1.scaletable[v1.scaleXindex] < _scaleX) {
+			v1.x += v1.scaleXstep;
+			if (v1.x < 0 || v1.x >= v1.boundsRect.right)
+				return;
+			v1.destptr += v1.scaleXstep * _vm->_bytesPerPixel;
+			skip_column = false;
+		} else
+			skip_column = true;
+		v1.scaleXindex += v1.scaleXstep;
+	} while (1);
+}
+
 // This is exact duplicate of smallCostumeScaleTable[] in costume.cpp
 // See FIXME below for explanation
 const byte smallCostumeScaleTableAKOS[256] = {
@@ -796,6 +863,7 @@ byte AkosRenderer::codec1(int xmoveCur, int ymoveCur) {
 	// So I had to put copy of it back here as it was before 1.227 revision
 	// of this file.
 	v1.scaletable = (_vm->_game.heversion >= 61) ? smallCostumeScaleTableAKOS : bigCostumeScaleTable;
+	v1.pixels = 0;
 	if (_vm->VAR_CUSTOMSCALETABLE != 0xFF && _vm->_res->isResourceLoaded(rtString, _vm->VAR(_vm->VAR_CUSTOMSCALETABLE))) {
 		v1.scaletable = _vm->getStringAddressVar(_vm->VAR_CUSTOMSCALETABLE);
 	}
@@ -942,6 +1010,7 @@ byte AkosRenderer::codec1(int xmoveCur, int ymoveCur) {
 		return 0;
 
 	v1.replen = 0;
+	v1.pixels = codec1_getCel(v1);
 
 	if (_mirror) {
 		if (!use_scaling)
@@ -998,7 +1067,10 @@ byte AkosRenderer::codec1(int xmoveCur, int ymoveCur) {
 
 	v1.destptr = (byte *)_out.pixels + v1.y * _out.pitch + v1.x * _vm->_bytesPerPixel;
 
-	codec1_genericDecode(v1);
+	if (v1.pixels)
+		codec1_blitCached(v1);
+	else
+		codec1_genericDecode(v1);
 
 	return drawFlag;
 }
@@ -1157,16 +1229,22 @@ void AkosRenderer::akos16Decompress(byte *dest, int32 pitch, const byte *src, in
 	int maskpitch;
 	byte *maskptr;
 	const byte maskbit = revBitMask(maskLeft & 7);
+	const byte *cel = akos16GetCel();
+	int i;
 
 	if (dir < 0) {
 		dest -= (t_width - 1);
 		tmp_buf += (t_width - 1);
 	}
 
-	akos16SetupBitReader(src);
+	if (cel) {
+		cel += numskip_before;
+	} else {
+		akos16SetupBitReader(src);
 
-	if (numskip_before != 0) {
-		akos16SkipData(numskip_before);
+		if (numskip_before != 0) {
+			akos16SkipData(numskip_before);
+		}
 	}
 
 	maskpitch = _numStrips;
@@ -1176,12 +1254,22 @@ void AkosRenderer::akos16Decompress(byte *dest, int32 pitch, const byte *src, in
 	assert(t_height > 0);
 	assert(t_width > 0);
 	while (t_height--) {
-		akos16DecodeLine(tmp_buf, t_width, dir);
+		if (cel) {
+			if (dir < 0) {
+				for (i = 0; i < t_width; i++)
+					tmp_buf[-i] = cel[i];
+			} else {
+				memcpy(tmp_buf, cel, t_width);
+			}
+			cel += t_width + numskip_after;
+		} else {
+			akos16DecodeLine(tmp_buf, t_width, dir);
+		}
 		bompApplyMask(_akos16.buffer, maskptr, maskbit, t_width, transparency);
 		bool HE7Check = (_vm->_game.heversion == 70);
 		bompApplyShadow(_shadow_mode, _shadow_table, _akos16.buffer, dest, t_width, transparency, HE7Check);
 
-		if (numskip_after != 0)	{
+		if (!cel && numskip_after != 0)	{
 			akos16SkipData(numskip_after);
 		}
 		dest += pitch;
@@ -1189,6 +1277,27 @@ void AkosRenderer::akos16Decompress(byte *dest, int32 pitch, const byte *src, in
 	}
 }
 
+/**
+ * Return the current cel (at _srcptr) decoded into _width * _height color
+ * indices, row by row, or 0 if the frame cache can't be used.
+ */
+const byte *AkosRenderer::akos16GetCel() {
+	if (!_frameCache.isEnabled() || !_celBase || _width <= 0 || _height <= 0)
+		return 0;
+
+	const uint32 size = _width * _height;
+	const byte *pixels = _frameCache.lookup(_celCostume, _celBase, _srcptr, size);
+	if (!pixels) {
+		byte *dst = _frameCache.insert(_celCostume, _celBase, _srcptr, size);
+		if (dst) {
+			akos16SetupBitReader(_srcptr);
+			akos16DecodeLine(dst, size, 1);
+		}
+		pixels = dst;
+	}
+	return pixels;
+}
+
 byte AkosRenderer::codec16(int xmoveCur, int ymoveCur) {
 	assert(_vm->_bytesPerPixel == 1);
 
@@ -26,6 +26,7 @@
 #ifndef SCUMM_AKOS_H
 #define SCUMM_AKOS_H
 
+#include "common/array.h"
 #include "scumm/base-costume.h"
 
 namespace Scumm {
@@ -88,6 +89,9 @@ protected:
 		byte buffer[336];
 	} _akos16;
 
+	// Rows of a cached cel which survive scaling, see codec1_blitCached
+	Common::Array<uint16> _celRows;
+
 public:
 	AkosRenderer(ScummEngine *scumm) : BaseCostumeRenderer(scumm) {
 		_useBompPalette = false;
@@ -116,6 +120,8 @@ protected:
 
 	byte codec1(int xmoveCur, int ymoveCur);
 	void codec1_genericDecode(Codec1 &v1);
+	void codec1_blitCached(Codec1 &v1);
+	void codec1_putPixel(byte *dst, uint16 color);
 	byte codec5(int xmoveCur, int ymoveCur);
 	byte codec16(int xmoveCur, int ymoveCur);
 	byte codec32(int xmoveCur, int ymoveCur);
@@ -123,6 +129,7 @@ protected:
 	void akos16SkipData(int32 numskip);
 	void akos16DecodeLine(byte *buf, int32 numbytes, int32 dir);
 	void akos16Decompress(byte *dest, int32 pitch, const byte *src, int32 t_width, int32 t_height, int32 dir, int32 numskip_before, int32 numskip_after, byte transparency, int maskLeft, int maskTop, int zBuf);
+	const byte *akos16GetCel();
 
 	void markRectAsDirty(Common::Rect rect);
 };
@@ -62,6 +62,11 @@ byte BaseCostumeRenderer::drawCostume(const VirtScreen &vs, int numStrips, const
 void BaseCostumeRenderer::codec1_ignorePakCols(Codec1 &v1, int num) {
 	num *= _height;
 
+	if (v1.pixels) {
+		v1.pixels += num;
+		return;
+	}
+
 	do {
 		v1.replen = *_srcptr++;
 		v1.repcolor = v1.replen >> v1.shr;
@@ -77,6 +82,163 @@ void BaseCostumeRenderer::codec1_ignorePakCols(Codec1 &v1, int num) {
 	} while (1);
 }
 
+/**
+ * Return the current cel (at _srcptr) decoded into _width * _height color
+ * indices, column by column. Returns 0 if the frame cache can't be used, in
+ * which case the caller has to fall back to decoding the RLE data itself.
+ */
+const byte *BaseCostumeRenderer::codec1_getCel(const Codec1 &v1) {
+	if (!_frameCache.isEnabled() || !_celBase || _width <= 0 || _height <= 0)
+		return 0;
+
+	const uint32 size = _width * _height;
+	const byte *pixels = _frameCache.lookup(_celCostume, _celBase, _srcptr, size);
+	if (!pixels) {
+		byte *dst = _frameCache.insert(_celCostume, _celBase, _srcptr, size);
+		if (dst)
+			codec1_decodeCel(v1, dst);
+		pixels = dst;
+	}
+	return pixels;
+}
+
+void BaseCostumeRenderer::codec1_decodeCel(const Codec1 &v1, byte *dst) {
+	const byte *src = _srcptr;
+	const byte *end = dst + _width * _height;
+	byte color;
+	int len;
+
+	while (dst < end) {
+		len = *src++;
+		color = len >> v1.shr;
+		len &= v1.mask;
+		// A length of zero is followed by a length byte; a zero in there
+		// in turn stands for 256 (the renderers count down a byte).
+		if (!len) {
+			len = *src++;
+			if (!len)
+				len = 256;
+		}
+
+		if (len > end - dst)
+			len = end - dst;
+		memset(dst, color, len);
+		dst += len;
+	}
+}
+
+#pragma mark -
+#pragma mark --- CostumeFrameCache ---
+#pragma mark -
+
+CostumeFrameCache::CostumeFrameCache(uint32 maxBytes)
+	: _head(0), _tail(0), _usedBytes(0), _maxBytes(maxBytes), _enabled(true) {
+	resetStats();
+}
+
+CostumeFrameCache::~CostumeFrameCache() {
+	clear();
+}
+
+const byte *CostumeFrameCache::lookup(int costume, const byte *base, const byte *cel, uint32 size) {
+	if (!_enabled)
+		return 0;
+
+	Key key;
+	key.costume = costume;
+	key.offset = cel - base;
+
+	EntryMap::iterator i = _entries.find(key);
+	if (i != _entries.end()) {
+		Entry *entry = i->_value;
+
+		// If the costume resource was expired and loaded again in the
+		// meantime, don't trust what was decoded from the old copy.
+		if (entry->base == base && entry->size == size) {
+			if (entry != _head) {
+				unlink(entry);
+				link(entry);
+			}
+			_stats.hits++;
+			return entry->pixels;
+		}
+		remove(entry);
+	}
+
+	_stats.misses++;
+	return 0;
+}
+
+byte *CostumeFrameCache::insert(int costume, const byte *base, const byte *cel, uint32 size) {
+	// Don't let a single huge cel flush everything else
+	if (!_enabled || size > _maxBytes / 4)
+		return 0;
+
+	while (_tail && _usedBytes + size > _maxBytes) {
+		remove(_tail);
+		_stats.evictions++;
+	}
+
+	Entry *entry = new Entry;
+	entry->key.costume = costume;
+	entry->key.offset = cel - base;
+	entry->base = base;
+	entry->size = size;
+	entry->pixels = (byte *)malloc(size);
+	link(entry);
+
+	_entries[entry->key] = entry;
+	_usedBytes += size;
+
+	return entry->pixels;
+}
+
+void CostumeFrameCache::clear() {
+	while (_head)
+		remove(_head);
+}
+
+void CostumeFrameCache::setEnabled(bool enabled) {
+	_enabled = enabled;
+	if (!enabled)
+		clear();
+}
+
+void CostumeFrameCache::resetStats() {
+	_stats.hits = 0;
+	_stats.misses = 0;
+	_stats.evictions = 0;
+}
+
+void CostumeFrameCache::link(Entry *entry) {
+	entry->prev = 0;
+	entry->next = _head;
+	if (_head)
+		_head->prev = entry;
+	else
+		_tail = entry;
+	_head = entry;
+}
+
+void CostumeFrameCache::unlink(Entry *entry) {
+	if (entry->prev)
+		entry->prev->next = entry->next;
+	else
+		_head = entry->next;
+	if (entry->next)
+		entry->next->prev = entry->prev;
+	else
+		_tail = entry->prev;
+}
+
+void CostumeFrameCache::remove(Entry *entry) {
+	unlink(entry);
+	_entries.erase(entry->key);
+	_usedBytes -= entry->size;
+	free(entry->pixels);
+	delete entry;
+}
+
 bool ScummEngine::isCostumeInUse(int cost) const {
 	int i;
 	Actor *a;
@@ -27,6 +27,7 @@
 #define SCUMM_BASE_COSTUME_H
 
 #include "common/scummsys.h"
+#include "common/hashmap.h"
 #include "scumm/actor.h"		// for CostumeData
 
 namespace Scumm {
@@ -66,6 +67,107 @@ public:
 };
 
 
+/**
+ * Cache of decoded costume cels.
+ *
+ * Costume cels are stored RLE or bit packed, and used to be decoded from
+ * scratch whenever an actor was drawn, even if it still showed the same
+ * frame. This cache keeps the decoded color indices of recently drawn cels,
+ * one byte per pixel in the order of the packed data, so that redrawing
+ * them boils down to a masked blit.
+ *
+ * Cels are identified by their costume and their offset in the costume
+ * resource. Palette remapping, scaling and shadows are still applied while
+ * blitting: shadows depend on the destination, and the scale of a walking
+ * actor changes with almost every step, so keying on them would mostly
+ * produce misses. The least recently used cels are dropped once the cache
+ * exceeds its memory limit.
+ */
+class CostumeFrameCache {
+public:
+	enum {
+		kDefaultMaxBytes = 2 * 1024 * 1024
+	};
+
+	struct Stats {
+		uint32 hits;
+		uint32 misses;
+		uint32 evictions;
+	};
+
+	CostumeFrameCache(uint32 maxBytes = kDefaultMaxBytes);
+	~CostumeFrameCache();
+
+	/**
+	 * Look up a decoded cel.
+	 *
+	 * @param costume	the costume resource number
+	 * @param base		start of the costume data the offset of the cel is relative to
+	 * @param cel		start of the packed cel data
+	 * @param size		size of the decoded cel in bytes
+	 * @return the decoded cel, or 0 if it is not cached
+	 */
+	const byte *lookup(int costume, const byte *base, const byte *cel, uint32 size);
+
+	/**
+	 * Reserve space for a cel which missed the cache. The caller is
+	 * responsible for decoding the cel into the returned buffer.
+	 * @return the buffer, or 0 if the cache is disabled or the cel too large
+	 */
+	byte *insert(int costume, const byte *base, const byte *cel, uint32 size);
+
+	/** Drop all cached cels. */
+	void clear();
+
+	bool isEnabled() const { return _enabled; }
+	void setEnabled(bool enabled);
+
+	const Stats &getStats() const { return _stats; }
+	void resetStats();
+
+	uint32 getNumCels() const { return _entries.size(); }
+	uint32 getUsedBytes() const { return _usedBytes; }
+	uint32 getMaxBytes() const { return _maxBytes; }
+
+private:
+	struct Key {
+		int costume;
+		uint32 offset;
+
+		bool operator==(const Key &key) const {
+			return costume == key.costume && offset == key.offset;
+		}
+	};
+
+	struct Key_Hash {
+		uint operator()(const Key &key) const {
+			return (uint)key.costume * 0x9E3779B1 ^ key.offset;
+		}
+	};
+
+	struct Entry {
+		Key key;
+		const byte *base;
+		uint32 size;
+		byte *pixels;
+		Entry *prev, *next;		// LRU list, most recently used first
+	};
+
+	typedef Common::HashMap<Key, Entry *, Key_Hash> EntryMap;
+
+	EntryMap _entries;
+	Entry *_head, *_tail;
+	uint32 _usedBytes;
+	uint32 _maxBytes;
+	bool _enabled;
+	Stats _stats;
+
+	void link(Entry *entry);
+	void unlink(Entry *entry);
+	void remove(Entry *entry);
+};
+
+
 /**
  * Base class for both ClassicCostumeRenderer and AkosRenderer.
  */
@@ -108,6 +210,11 @@ protected:
 	// width and height of cel to decode
 	int _width, _height;
 
+	// Decoded cels, and the costume they are currently taken from
+	CostumeFrameCache _frameCache;
+	int _celCostume;
+	const byte *_celBase;
+
 public:
 	struct Codec1 {
 		// Parameters for the original ("V1") costume codec.
@@ -125,6 +232,8 @@ public:
 		// These ones aren't accessed from ARM code.
 		Common::Rect boundsRect;
 		int scaleXindex, scaleYindex;
+		// Decoded cel from the frame cache, or 0 to decode the RLE data
+		const byte *pixels;
 	};
 
 	BaseCostumeRenderer(ScummEngine *scumm) {
@@ -144,9 +253,13 @@ public:
 		_width = _height = 0;
 		_skipLimbs = 0;
 		_paletteNum = 0;
+		_celCostume = 0;
+		_celBase = 0;
 	}
 	virtual ~BaseCostumeRenderer() {}
 
+	CostumeFrameCache &getFrameCache() { return _frameCache; }
+
 	virtual void setPalette(uint16 *palette) = 0;
 	virtual void setFacing(const Actor *a) = 0;
 	virtual void setCostume(int costume, int shadow) = 0;
@@ -158,6 +271,8 @@ protected:
 	virtual byte drawLimb(const Actor *a, int limb) = 0;
 
 	void codec1_ignorePakCols(Codec1 &v1, int num);
+	const byte *codec1_getCel(const Codec1 &v1);
+	void codec1_decodeCel(const Codec1 &v1, byte *dst);
 };
 
 } // End of namespace Scumm
@@ -89,6 +89,7 @@ struct Box {				/* Internal walkbox file format */
 
 
 static void getGates(const BoxCoords &box1, const BoxCoords &box2, Common::Point gateA[2], Common::Point gateB[2]);
+static BoxEdge findBoxEdge(BoxCoords box1, BoxCoords box2);
 
 static bool compareSlope(const Common::Point &p1, const Common::Point &p2, const Common::Point &p3) {
 	return (p2.y - p1.y) * (p3.x - p1.x) <= (p3.y - p1.y) * (p2.x - p1.x);
@@ -171,8 +172,8 @@ byte ScummEngine::getMaskFromBox(int box) {
 	if (_game.version <= 3 && box == 255)
 		return 1;
 
-	Box *ptr = getBoxBaseAddr(box);
-	if (!ptr)
+	const BoxInfo *info = getBoxInfo(box);
+	if (!info)
 		return 0;
 
 	// WORKAROUND for bug #847827: This is a bug in the data files, as it also
@@ -180,14 +181,7 @@ byte ScummEngine::getMaskFromBox(int box) {
 	if (_game.id == GID_INDY4 && _currentRoom == 225 && _roomResource == 94 && box == 8)
 		return 0;
 
-	if (_game.version == 8)
-		return (byte) FROM_LE_32(ptr->v8.mask);
-	else if (_game.version == 0)
-		return ptr->c64.mask;
-	else if (_game.version <= 2)
-		return ptr->v2.mask;
-	else
-		return ptr->old.mask;
+	return info->mask;
 }
 
 void ScummEngine::setBoxFlags(int box, int val) {
@@ -207,21 +201,15 @@ void ScummEngine::setBoxFlags(int box, int val) {
 			ptr->v2.flags = val;
 		else
 			ptr->old.flags = val;
+		invalidateBoxCache();
 	}
 }
 
 byte ScummEngine::getBoxFlags(int box) {
-	Box *ptr = getBoxBaseAddr(box);
-	if (!ptr)
+	const BoxInfo *info = getBoxInfo(box);
+	if (!info)
 		return 0;
-	if (_game.version == 8)
-		return (byte) FROM_LE_32(ptr->v8.flags);
-	else if (_game.version == 0)
-		return 0;
-	else if (_game.version <= 2)
-		return ptr->v2.flags;
-	else
-		return ptr->old.flags;
+	return info->flags;
 }
 
 void ScummEngine::setBoxScale(int box, int scale) {
@@ -233,34 +221,26 @@ void ScummEngine::setBoxScale(int box, int scale) {
 		error("This should not ever be called");
 	else
 		ptr->old.scale = TO_LE_16(scale);
+	invalidateBoxCache();
 }
 
 void ScummEngine::setBoxScaleSlot(int box, int slot) {
 	Box *ptr = getBoxBaseAddr(box);
 	assert(ptr);
 	ptr->v8.scaleSlot = TO_LE_32(slot);
+	invalidateBoxCache();
 }
 
 int ScummEngine::getScale(int box, int x, int y) {
 	if (_game.version <= 3)
 		return 255;
 
-	Box *ptr = getBoxBaseAddr(box);
-	if (!ptr)
+	const BoxInfo *info = getBoxInfo(box);
+	if (!info)
 		return 255;
 
-	int slot = 0;
-	int scale;
-
-	if (_game.version == 8) {
-		// COMI has a separate field for the scale slot...
-		slot = FROM_LE_32(ptr->v8.scaleSlot);
-		scale = FROM_LE_32(ptr->v8.scale);
-	} else {
-		scale = READ_LE_UINT16(&ptr->old.scale);
-		if (scale & 0x8000)
-			slot = (scale & 0x7FFF) + 1;
-	}
+	int slot = info->scaleSlot;
+	int scale = info->scale;
 
 	// Was a scale slot specified? If so, we compute the effective scale
 	// from it, ignoring the box scale.
@@ -310,13 +290,10 @@ int ScummEngine::getScaleFromSlot(int slot, int x, int y) {
 int ScummEngine::getBoxScale(int box) {
 	if (_game.version <= 3)
 		return 255;
-	Box *ptr = getBoxBaseAddr(box);
-	if (!ptr)
+	const BoxInfo *info = getBoxInfo(box);
+	if (!info)
 		return 255;
-	if (_game.version == 8)
-		return FROM_LE_32(ptr->v8.scale);
-	else
-		return READ_LE_UINT16(&ptr->old.scale);
+	return info->scale;
 }
 
 /**
@@ -441,26 +418,36 @@ void ScummEngine::setScaleSlot(int slot, int x1, int y1, int scale1, int x2, int
 }
 
 byte ScummEngine::getNumBoxes() {
-	byte *ptr = getResourceAddress(rtMatrix, 2);
-	if (!ptr)
-		return 0;
-	if (_game.version == 8)
-		return (byte)READ_LE_UINT32(ptr);
-	else if (_game.version >= 5)
-		return (byte)READ_LE_UINT16(ptr);
-	else
-		return ptr[0];
+	if (!_boxCache->valid)
+		buildBoxCache();
+	return _boxCache->numBoxes;
 }
 
 Box *ScummEngine::getBoxBaseAddr(int box) {
 	byte *ptr = getResourceAddress(rtMatrix, 2);
-	if (!ptr || box == 255)
+	if (!ptr)
 		return NULL;
 
+	box = adjustBoxNum(box, ptr[0]);
+	if (box < 0)
+		return NULL;
+
+	return getBoxBaseAddr(ptr, box);
+}
+
+/**
+ * Map a box number as passed in by scripts or the walk code to an index
+ * into the box table, applying the workarounds listed below. Returns -1 if
+ * there is no such box.
+ */
+int ScummEngine::adjustBoxNum(int box, int numOfBoxes) {
+	if (box == 255)
+		return -1;
+
 	// WORKAROUND: The NES version of Maniac Mansion attempts to set flags for boxes 2-4
 	// when there are only three boxes (0-2) when walking out to the garage.
-	if ((_game.id == GID_MANIAC) && (_game.platform == Common::kPlatformNES) && (box >= ptr[0]))
-		return NULL;
+	if ((_game.id == GID_MANIAC) && (_game.platform == Common::kPlatformNES) && (box >= numOfBoxes))
+		return -1;
 
 	// WORKAROUND: In "pass to adventure", the loom demo, when bobbin enters
 	// the tent to the elders, box = 2, but ptr[0] = 2 -> errors out.
@@ -476,10 +463,14 @@ Box *ScummEngine::getBoxBaseAddr(int box) {
 	// Note that this may cause different behavior than the original game
 	// engine exhibited! To faithfully reproduce the behavior of the original
 	// engine, we would have to know the data coming *after* the walkbox table.
-	if (_game.version <= 4 && ptr[0] == box)
+	if (_game.version <= 4 && numOfBoxes == box)
 		box--;
 
-	assertRange(0, box, ptr[0] - 1, "box");
+	assertRange(0, box, numOfBoxes - 1, "box");
+	return box;
+}
+
+Box *ScummEngine::getBoxBaseAddr(byte *ptr, int box) {
 	if (_game.version == 0)
 		return (Box *)(ptr + box * SIZEOF_BOX_C64 + 1);
 	else if (_game.version <= 2)
@@ -573,10 +564,58 @@ bool ScummEngine::checkXYInBoxBounds(int boxnum, int x, int y) {
 	return true;
 }
 
+void ScummEngine::invalidateBoxCache() {
+	_boxCache->invalidate();
+}
+
+/**
+ * Decode all boxes of the current room into the box cache. This is done
+ * lazily, on the first box access after invalidateBoxCache() was called.
+ */
+void ScummEngine::buildBoxCache() {
+	BoxCache &cache = *_boxCache;
+
+	cache.invalidate();
+	cache.valid = true;
+
+	byte *ptr = getResourceAddress(rtMatrix, 2);
+	if (!ptr)
+		return;
+
+	cache.present = true;
+	if (_game.version == 8)
+		cache.numBoxes = (byte)READ_LE_UINT32(ptr);
+	else if (_game.version >= 5)
+		cache.numBoxes = (byte)READ_LE_UINT16(ptr);
+	else
+		cache.numBoxes = ptr[0];
+
+	cache.boxes.resize(cache.numBoxes);
+	for (int i = 0; i < cache.numBoxes; i++)
+		decodeBox(getBoxBaseAddr(ptr, i), cache.boxes[i]);
+}
+
+const BoxInfo *ScummEngine::getBoxInfo(int box) {
+	if (!_boxCache->valid)
+		buildBoxCache();
+	if (!_boxCache->present)
+		return NULL;
+
+	box = adjustBoxNum(box, _boxCache->numBoxes);
+	if (box < 0)
+		return NULL;
+
+	return &_boxCache->boxes[box];
+}
+
 BoxCoords ScummEngine::getBoxCoordinates(int boxnum) {
-	BoxCoords tmp, *box = &tmp;
-	Box *bp = getBoxBaseAddr(boxnum);
-	assert(bp);
+	const BoxInfo *info = getBoxInfo(boxnum);
+	assert(info);
+	return info->coords;
+}
+
+void ScummEngine::decodeBox(const Box *bp, BoxInfo &info) {
+	BoxCoords *box = &info.coords;
 
 	if (_game.version == 8) {
 		box->ul.x = (short)FROM_LE_32(bp->v8.ulx);
@@ -644,7 +683,32 @@ BoxCoords ScummEngine::getBoxCoordinates(int boxnum) {
 		box->lr.x = (int16)READ_LE_UINT16(&bp->old.lrx);
 		box->lr.y = (int16)READ_LE_UINT16(&bp->old.lry);
 	}
-	return *box;
+
+	if (_game.version == 8) {
+		info.flags = (byte)FROM_LE_32(bp->v8.flags);
+		info.mask = (byte)FROM_LE_32(bp->v8.mask);
+	} else if (_game.version == 0) {
+		info.flags = 0;
+		info.mask = bp->c64.mask;
+	} else if (_game.version <= 2) {
+		info.flags = bp->v2.flags;
+		info.mask = bp->v2.mask;
+	} else {
+		info.flags = bp->old.flags;
+		info.mask = bp->old.mask;
+	}
+
+	info.scale = 255;
+	info.scaleSlot = 0;
+	if (_game.version == 8) {
+		// COMI has a separate field for the scale slot...
+		info.scale = FROM_LE_32(bp->v8.scale);
+		info.scaleSlot = FROM_LE_32(bp->v8.scaleSlot);
+	} else if (_game.version >= 4) {
+		info.scale = READ_LE_UINT16(&bp->old.scale);
+		if (info.scale & 0x8000)
+			info.scaleSlot = (info.scale & 0x7FFF) + 1;
+	}
 }
 
 int getClosestPtOnBox(const BoxCoords &box, int x, int y, int16& outX, int16& outY) {
@@ -703,10 +767,7 @@ byte *ScummEngine::getBoxMatrixBaseAddr() {
  * If there is no connection -1 is return.
  */
 int ScummEngine::getNextBox(byte from, byte to) {
-	const byte *boxm;
-	byte i;
 	const int numOfBoxes = getNumBoxes();
-	int dest = -1;
 
 	if (from == to)
 		return to;
@@ -720,6 +781,24 @@ int ScummEngine::getNextBox(byte from, byte to) {
 	assert(from < numOfBoxes);
 	assert(to < numOfBoxes);
 
+	// The answer only depends on the box matrix, so remember it until the
+	// matrix (or the room) changes.
+	const uint16 key = BoxCache::pairKey(from, to);
+	Common::FlatHashMap<uint16, int>::const_iterator it = _boxCache->nextBox.find(key);
+	if (it != _boxCache->nextBox.end())
+		return it->_value;
+
+	const int dest = calcNextBox(from, to);
+	_boxCache->nextBox[key] = dest;
+	return dest;
+}
+
+int ScummEngine::calcNextBox(byte from, byte to) {
+	const byte *boxm;
+	byte i;
+	const int numOfBoxes = getNumBoxes();
+	int dest = -1;
+
 	boxm = getBoxMatrixBaseAddr();
 
 	if (_game.version == 0) {
@@ -790,12 +869,112 @@ int ScummEngine::getNextBox(byte from, byte to) {
  */
 bool Actor::findPathTowards(byte box1nr, byte box2nr, byte box3nr, Common::Point &foundPath) {
 	assert(_vm->_game.version >= 3);
-	BoxCoords box1 = _vm->getBoxCoordinates(box1nr);
-	BoxCoords box2 = _vm->getBoxCoordinates(box2nr);
+	const BoxEdge edge = _vm->getBoxEdge(box1nr, box2nr);
+	int q, pos;
+
+	if (edge.type == BoxEdge::kVertical) {
+		pos = _pos.y;
+		if (box2nr == box3nr) {
+			int diffX = _walkdata.dest.x - _pos.x;
+			int diffY = _walkdata.dest.y - _pos.y;
+			int boxDiffX = edge.coord - _pos.x;
+
+			if (diffX != 0) {
+				int t;
+
+				diffY *= boxDiffX;
+				t = diffY / diffX;
+				if (t == 0 && (diffY <= 0 || diffX <= 0)
+						&& (diffY >= 0 || diffX >= 0))
+					t = -1;
+				pos = _pos.y + t;
+			}
+		}
+
+		q = pos;
+		if (q < edge.min2)
+			q = edge.min2;
+		if (q > edge.max2)
+			q = edge.max2;
+		if (q < edge.min1)
+			q = edge.min1;
+		if (q > edge.max1)
+			q = edge.max1;
+		if (q == pos && box2nr == box3nr)
+			return true;
+		foundPath.y = q;
+		foundPath.x = edge.coord;
+		return false;
+	}
+
+	if (edge.type == BoxEdge::kHorizontal) {
+		if (box2nr == box3nr) {
+			int diffX = _walkdata.dest.x - _pos.x;
+			int diffY = _walkdata.dest.y - _pos.y;
+			int boxDiffY = edge.coord - _pos.y;
+
+			pos = _pos.x;
+			if (diffY != 0) {
+				pos += diffX * boxDiffY / diffY;
+			}
+		} else {
+			pos = _pos.x;
+		}
+
+		q = pos;
+		if (q < edge.min2)
+			q = edge.min2;
+		if (q > edge.max2)
+			q = edge.max2;
+		if (q < edge.min1)
+			q = edge.min1;
+		if (q > edge.max1)
+			q = edge.max1;
+		if (q == pos && box2nr == box3nr)
+			return true;
+		foundPath.x = q;
+		foundPath.y = edge.coord;
+		return false;
+	}
+
+	return false;
+}
+
+/**
+ * Return the edge along which box1 and box2 touch, if any. The result is
+ * cached, since actors walking from one box into the next one ask for it
+ * on every step.
+ */
+BoxEdge ScummEngine::getBoxEdge(byte box1nr, byte box2nr) {
+	const BoxCoords box1 = getBoxCoordinates(box1nr);
+	const BoxCoords box2 = getBoxCoordinates(box2nr);
+
+	const uint16 key = BoxCache::pairKey(box1nr, box2nr);
+	Common::FlatHashMap<uint16, BoxEdge>::const_iterator it = _boxCache->edges.find(key);
+	if (it != _boxCache->edges.end())
+		return it->_value;
+
+	const BoxEdge edge = findBoxEdge(box1, box2);
+	_boxCache->edges[key] = edge;
+	return edge;
+}
+
+/**
+ * Search for sides of the two boxes which lie on a common vertical or
+ * horizontal line and overlap. In order to keep the code simple, we only
+ * match the upper sides; then, we "rotate" the box coordinates four times
+ * each, for a total of 16 comparisons.
+ */
+static BoxEdge findBoxEdge(BoxCoords box1, BoxCoords box2) {
+	BoxEdge edge;
 	Common::Point tmp;
 	int i, j;
 	int flag;
-	int q, pos;
+
+	edge.type = BoxEdge::kNone;
+	edge.coord = 0;
+	edge.min1 = edge.max1 = 0;
+	edge.min2 = edge.max2 = 0;
 
 	for (i = 0; i < 4; i++) {
 		for (j = 0; j < 4; j++) {
@@ -819,38 +998,13 @@ bool Actor::findPathTowards(byte box1nr, byte box2nr, byte box3nr, Common::Point
 					if (flag & 2)
 						SWAP(box2.ul.y, box2.ur.y);
 				} else {
-					pos = _pos.y;
-					if (box2nr == box3nr) {
-						int diffX = _walkdata.dest.x - _pos.x;
-						int diffY = _walkdata.dest.y - _pos.y;
-						int boxDiffX = box1.ul.x - _pos.x;
-
-						if (diffX != 0) {
-							int t;
-
-							diffY *= boxDiffX;
-							t = diffY / diffX;
-							if (t == 0 && (diffY <= 0 || diffX <= 0)
-									&& (diffY >= 0 || diffX >= 0))
-								t = -1;
-							pos = _pos.y + t;
-						}
-					}
-
-					q = pos;
-					if (q < box2.ul.y)
-						q = box2.ul.y;
-					if (q > box2.ur.y)
-						q = box2.ur.y;
-					if (q < box1.ul.y)
-						q = box1.ul.y;
-					if (q > box1.ur.y)
-						q = box1.ur.y;
-					if (q == pos && box2nr == box3nr)
-						return true;
-					foundPath.y = q;
-					foundPath.x = box1.ul.x;
-					return false;
+					edge.type = BoxEdge::kVertical;
+					edge.coord = box1.ul.x;
+					edge.min1 = box1.ul.y;
+					edge.max1 = box1.ur.y;
+					edge.min2 = box2.ul.y;
+					edge.max2 = box2.ur.y;
+					return edge;
 				}
 			}
 
@@ -874,34 +1028,13 @@ bool Actor::findPathTowards(byte box1nr, byte box2nr, byte box3nr, Common::Point
 					if (flag & 2)
 						SWAP(box2.ul.x, box2.ur.x);
 				} else {
-
-					if (box2nr == box3nr) {
-						int diffX = _walkdata.dest.x - _pos.x;
-						int diffY = _walkdata.dest.y - _pos.y;
-						int boxDiffY = box1.ul.y - _pos.y;
-
-						pos = _pos.x;
-						if (diffY != 0) {
-							pos += diffX * boxDiffY / diffY;
-						}
-					} else {
-						pos = _pos.x;
-					}
-
-					q = pos;
-					if (q < box2.ul.x)
-						q = box2.ul.x;
-					if (q > box2.ur.x)
-						q = box2.ur.x;
-					if (q < box1.ul.x)
-						q = box1.ul.x;
-					if (q > box1.ur.x)
-						q = box1.ur.x;
-					if (q == pos && box2nr == box3nr)
-						return true;
-					foundPath.x = q;
-					foundPath.y = box1.ul.y;
-					return false;
+					edge.type = BoxEdge::kHorizontal;
+					edge.coord = box1.ul.y;
+					edge.min1 = box1.ul.x;
+					edge.max1 = box1.ur.x;
+					edge.min2 = box2.ul.x;
+					edge.max2 = box2.ur.x;
+					return edge;
 				}
 			}
 			tmp = box1.ul;
@@ -916,7 +1049,7 @@ bool Actor::findPathTowards(byte box1nr, byte box2nr, byte box3nr, Common::Point
 		box2.lr = box2.ll;
 		box2.ll = tmp;
 	}
-	return false;
+	return edge;
 }
 
 #if BOX_DEBUG
@@ -1053,6 +1186,8 @@ void ScummEngine::createBoxMatrix() {
 	}
 	addToMatrix(0xFF);
 
+	// The box matrix changed, so all cached paths are void now
+	_boxCache->nextBox.clear();
 
 #if BOX_DEBUG
 	printf("Itinerary matrix:\n");
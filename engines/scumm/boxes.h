@@ -26,6 +26,8 @@
 #ifndef SCUMM_BOXES_H
 #define SCUMM_BOXES_H
 
+#include "common/array.h"
+#include "common/flathashmap.h"
 #include "common/rect.h"
 
 namespace Scumm {
@@ -52,6 +54,69 @@ struct BoxCoords {			/* Box coordinates */
 	Common::Point lr;
 };
 
+/**
+ * The edge two neighbouring boxes share, as found by
+ * ScummEngine::getBoxEdge(). The edge lies on the vertical line x = coord
+ * resp. the horizontal line y = coord; min1/max1 and min2/max2 give its
+ * extent on the first and second box.
+ */
+struct BoxEdge {
+	enum Type {
+		kNone,
+		kVertical,
+		kHorizontal
+	};
+
+	byte type;
+	int16 coord;
+	int16 min1, max1;
+	int16 min2, max2;
+};
+
+/** A single decoded walkbox, see BoxCache. */
+struct BoxInfo {
+	BoxCoords coords;
+	byte flags;
+	byte mask;
+	int scale;
+	int scaleSlot;
+};
+
+/**
+ * Decoded walkbox data of the current room.
+ *
+ * The boxes are decoded from the rtMatrix resource the first time they are
+ * needed after a room change (or after setBoxFlags() and friends modified
+ * them), so that the walk code doesn't have to re-read and byte swap the
+ * box data for every access. In addition the results of getNextBox() and
+ * getBoxEdge() are remembered per pair of boxes, since all actors walking
+ * through a room tend to ask the same questions over and over again.
+ */
+struct BoxCache {
+	bool valid;		///< false if the cache has to be rebuilt
+	bool present;	///< false if the room has no boxes at all
+	byte numBoxes;
+	Common::Array<BoxInfo> boxes;
+
+	Common::FlatHashMap<uint16, int> nextBox;
+	Common::FlatHashMap<uint16, BoxEdge> edges;
+
+	BoxCache() : valid(false), present(false), numBoxes(0) {}
+
+	void invalidate() {
+		valid = false;
+		present = false;
+		numBoxes = 0;
+		boxes.clear();
+		nextBox.clear();
+		edges.clear();
+	}
+
+	static uint16 pairKey(byte box1, byte box2) {
+		return (box1 << 8) | box2;
+	}
+};
+
 int getClosestPtOnBox(const BoxCoords &box, int x, int y, int16& outX, int16& outY);
 
 } // End of namespace Scumm
@@ -91,6 +91,7 @@ byte ClassicCostumeRenderer::mainRoutine(int xmoveCur, int ymoveCur) {
 	const bool pcEngCost = (_vm->_game.id == GID_LOOM && _vm->_game.platform == Common::kPlatformPCEngine);
 
 	v1.scaletable = smallCostumeScaleTable;
+	v1.pixels = 0;
 
 	if (_loaded._numColors == 32) {
 		v1.mask = 7;
@@ -234,6 +235,10 @@ byte ClassicCostumeRenderer::mainRoutine(int xmoveCur, int ymoveCur) {
 
 	v1.replen = 0;
 
+	// The other codecs don't use the frame cache (yet)
+	if (!newAmiCost && !pcEngCost && _loaded._format != 0x57)
+		v1.pixels = codec1_getCel(v1);
+
 	if (_mirror) {
 		if (!use_scaling)
 			skip = -v1.x;
@@ -309,6 +314,8 @@ byte ClassicCostumeRenderer::mainRoutine(int xmoveCur, int ymoveCur) {
 		proc3_ami(v1);
 	else if (pcEngCost)
 		procPCEngine(v1);
+	else if (v1.pixels)
+		proc3_cached(v1);
 	else
 		proc3(v1);
 
@@ -425,12 +432,25 @@ extern "C" int ClassicProc3RendererShadowARM(int _scaleY,
                                         int _scaleIndexY);
 #endif
 
+inline void ClassicCostumeRenderer::proc3_putPixel(byte *dst, uint color) {
+	uint pcolor;
+
+	if (_shadow_mode & 0x20) {
+		pcolor = _shadow_table[*dst];
+	} else {
+		pcolor = _palette[color];
+		if (pcolor == 13 && _shadow_table)
+			pcolor = _shadow_table[*dst];
+	}
+	*dst = pcolor;
+}
+
 void ClassicCostumeRenderer::proc3(Codec1 &v1) {
 	const byte *mask, *src;
 	byte *dst;
 	byte len, maskbit;
 	int y;
-	uint color, height, pcolor;
+	uint color, height;
 	byte scaleIndexY;
 	bool masked;
 
@@ -479,16 +499,8 @@ void ClassicCostumeRenderer::proc3(Codec1 &v1) {
 			if (_scaleY == 255 || v1.scaletable[scaleIndexY++] < _scaleY) {
 				masked = (y < 0 || y >= _out.h) || (v1.x < 0 || v1.x >= _out.w) || (v1.mask_ptr && (mask[0] & maskbit));
 
-				if (color && !masked) {
-					if (_shadow_mode & 0x20) {
-						pcolor = _shadow_table[*dst];
-					} else {
-						pcolor = _palette[color];
-						if (pcolor == 13 && _shadow_table)
-							pcolor = _shadow_table[*dst];
-					}
-					*dst = pcolor;
-				}
+				if (color && !masked)
+					proc3_putPixel(dst, color);
 				dst += _out.pitch;
 				mask += _numStrips;
 				y++;
@@ -517,6 +529,62 @@ void ClassicCostumeRenderer::proc3(Codec1 &v1) {
 	} while (1);
 }
 
+/**
+ * Variant of proc3 which draws a cel decoded by the frame cache. Which rows
+ * survive scaling, and which of them are on screen, is the same for every
+ * column, so that is only worked out once.
+ */
+void ClassicCostumeRenderer::proc3_cached(Codec1 &v1) {
+	const byte *src = v1.pixels;
+	const byte *mask;
+	byte *dst;
+	byte maskbit, scaleIndexY;
+	byte rows[256];
+	int numRows, first, last, i;
+
+	// mainRoutine bails out for cels of 256 rows and more
+	assert(_height < 256);
+
+	numRows = 0;
+	scaleIndexY = _scaleIndexY;
+	for (i = 0; i < _height; i++) {
+		if (_scaleY == 255 || v1.scaletable[scaleIndexY++] < _scaleY)
+			rows[numRows++] = i;
+	}
+
+	first = MAX(0, -v1.y);
+	last = MIN(numRows, _out.h - v1.y);
+
+	do {
+		if (first < last && v1.x >= 0 && v1.x < _out.w) {
+			maskbit = revBitMask(v1.x & 7);
+			dst = v1.destptr + first * _out.pitch;
+			mask = v1.mask_ptr ? v1.mask_ptr + v1.x / 8 + first * _numStrips : 0;
+
+			for (i = first; i < last; i++) {
+				const byte color = src[rows[i]];
+				if (color && !(mask && (*mask & maskbit)))
+					proc3_putPixel(dst, color);
+				dst += _out.pitch;
+				if (mask)
+					mask += _numStrips;
+			}
+		}
+		src += _height;
+
+		if (!--v1.skip_width)
+			return;
+
+		if (_scaleX == 255 || v1.scaletable[_scaleIndexX] < _scaleX) {
+			v1.x += v1.scaleXstep;
+			if (v1.x < 0 || v1.x >= _out.w)
+				return;
+			v1.destptr += v1.scaleXstep;
+		}
+		_scaleIndexX += v1.scaleXstep;
+	} while (1);
+}
+
 void ClassicCostumeRenderer::proc3_ami(Codec1 &v1) {
 	const byte *mask, *src;
 	byte *dst;
@@ -1040,6 +1108,8 @@ void ClassicCostumeRenderer::setFacing(const Actor *a) {
 
 void ClassicCostumeRenderer::setCostume(int costume, int shadow) {
 	_loaded.loadCostume(costume);
+	_celCostume = costume;
+	_celBase = _loaded._baseptr;
 }
 
 byte ClassicCostumeLoader::increaseAnims(Actor *a) {
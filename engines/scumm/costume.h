@@ -106,6 +106,8 @@ protected:
 	byte drawLimb(const Actor *a, int limb);
 
 	void proc3(Codec1 &v1);
+	void proc3_cached(Codec1 &v1);
+	void proc3_putPixel(byte *dst, uint color);
 	void proc3_ami(Codec1 &v1);
 
 	void procC64(Codec1 &v1, int actor);
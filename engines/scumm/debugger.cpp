@@ -31,11 +31,13 @@
 #include "common/util.h"
 
 #include "scumm/actor.h"
+#include "scumm/base-costume.h"
 #include "scumm/boxes.h"
 #include "scumm/debugger.h"
 #include "scumm/imuse/imuse.h"
 #include "scumm/object.h"
 #include "scumm/player_v2.h"
+#include "scumm/profiler.h"
 #include "scumm/scumm.h"
 #include "scumm/sound.h"
 
@@ -85,6 +87,8 @@ ScummDebugger::ScummDebugger(ScummEngine *s)
 	DCmd_Register("scr",       WRAP_METHOD(ScummDebugger, Cmd_Script));
 	DCmd_Register("scripts",   WRAP_METHOD(ScummDebugger, Cmd_PrintScript));
 	DCmd_Register("importres", WRAP_METHOD(ScummDebugger, Cmd_ImportRes));
+	DCmd_Register("costumecache", WRAP_METHOD(ScummDebugger, Cmd_CostumeCache));
+	DCmd_Register("profile",   WRAP_METHOD(ScummDebugger, Cmd_Profile));
 
 	if (_vm->_game.id == GID_LOOM)
 		DCmd_Register("drafts",  WRAP_METHOD(ScummDebugger, Cmd_PrintDraft));
@@ -328,6 +332,92 @@ bool ScummDebugger::Cmd_ImportRes(int argc, const char** argv) {
 	return true;
 }
 
+bool ScummDebugger::Cmd_CostumeCache(int argc, const char **argv) {
+	if (!_vm->_costumeRenderer) {
+		DebugPrintf("No costume renderer is active.\n");
+		return true;
+	}
+
+	CostumeFrameCache &cache = _vm->_costumeRenderer->getFrameCache();
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "on")) {
+			cache.setEnabled(true);
+		} else if (!strcmp(argv[1], "off")) {
+			cache.setEnabled(false);
+		} else if (!strcmp(argv[1], "clear")) {
+			cache.clear();
+			cache.resetStats();
+		} else {
+			DebugPrintf("Syntax: costumecache [on|off|clear]\n");
+			return true;
+		}
+	}
+
+	const CostumeFrameCache::Stats &stats = cache.getStats();
+	const uint32 lookups = stats.hits + stats.misses;
+
+	DebugPrintf("Costume frame cache is %s\n", cache.isEnabled() ? "on" : "off");
+	DebugPrintf("  %d cels, %d of %d KB used\n", cache.getNumCels(), cache.getUsedBytes() / 1024, cache.getMaxBytes() / 1024);
+	DebugPrintf("  %d hits, %d misses, %d evictions\n", stats.hits, stats.misses, stats.evictions);
+	if (lookups)
+		DebugPrintf("  Hit rate %d%%\n", stats.hits * 100 / lookups);
+	return true;
+}
+
+bool ScummDebugger::Cmd_Profile(int argc, const char **argv) {
+	if (argc > 1 && !strcmp(argv[1], "on")) {
+		if (!_vm->_scriptProfiler)
+			_vm->_scriptProfiler = new ScriptProfiler();
+		if (argc > 2)
+			_vm->_scriptProfiler->setDumpFile(argv[2]);
+		DebugPrintf("Script profiling is on\n");
+		return true;
+	}
+
+	if (argc > 1 && !strcmp(argv[1], "off")) {
+		delete _vm->_scriptProfiler;
+		_vm->_scriptProfiler = NULL;
+		DebugPrintf("Script profiling is off\n");
+		return true;
+	}
+
+	if (argc > 1 && strcmp(argv[1], "clear") && strcmp(argv[1], "dump") && strcmp(argv[1], "show")) {
+		DebugPrintf("Syntax: profile on [file] - start profiling, write the profile to file on exit\n");
+		DebugPrintf("        profile off - stop profiling, discarding the profile\n");
+		DebugPrintf("        profile clear - reset the profile\n");
+		DebugPrintf("        profile dump <file> - write the full profile to file\n");
+		DebugPrintf("        profile show [count] - print the top scripts and opcodes\n");
+		return true;
+	}
+
+	if (!_vm->_scriptProfiler) {
+		DebugPrintf("Script profiling is off, use 'profile on' to start it\n");
+		return true;
+	}
+
+	if (argc > 1 && !strcmp(argv[1], "clear")) {
+		_vm->_scriptProfiler->clear();
+		DebugPrintf("Script profile cleared\n");
+	} else if (argc > 1 && !strcmp(argv[1], "dump")) {
+		if (argc < 3) {
+			DebugPrintf("Syntax: profile dump <file>\n");
+		} else if (_vm->_scriptProfiler->dump(_vm, argv[2])) {
+			DebugPrintf("Script profile written to '%s'\n", argv[2]);
+		} else {
+			DebugPrintf("Could not write '%s'\n", argv[2]);
+		}
+	} else {
+		Common::StringList lines;
+		const int count = (argc > 2) ? atoi(argv[2]) : 15;
+
+		_vm->_scriptProfiler->report(_vm, lines, count);
+		for (uint i = 0; i < lines.size(); i++)
+			DebugPrintf("%s\n", lines[i].c_str());
+	}
+	return true;
+}
+
 bool ScummDebugger::Cmd_PrintScript(int argc, const char **argv) {
 	int i;
 	ScriptSlot *ss = _vm->vm.slot;
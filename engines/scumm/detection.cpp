@@ -38,6 +38,7 @@
 #include "scumm/he/intern_he.h"
 #include "scumm/scumm_v0.h"
 #include "scumm/scumm_v8.h"
+#include "scumm/smush/smush_bench.h"
 
 #include "engines/metaengine.h"
 
@@ -708,6 +709,10 @@ public:
 	virtual int getMaximumSaveSlot() const;
 	virtual void removeSaveState(const char *target, int slot) const;
 	virtual SaveStateDescriptor querySaveMetaInfos(const char *target, int slot) const;
+
+#ifdef ENABLE_SCUMM_7_8
+	virtual Common::Error benchVideo(const Common::FSNode &node, Audio::Mixer *mixer) const;
+#endif
 };
 
 bool ScummMetaEngine::hasFeature(MetaEngineFeature f) const {
@@ -1029,8 +1034,58 @@ const char *ScummMetaEngine::getOriginalCopyright() const {
 	       "Humongous SCUMM Games (C) Humongous";
 }
 
-namespace Scumm {
-	extern bool getSavegameName(Common::InSaveFile *in, Common::String &desc, int heversion);
+/**
+ * Fills in description, save date, save time and play time of a savestate.
+ * The savefile manager caches this information in its meta information
+ * index, so the savefile itself only needs to be examined if it changed.
+ */
+static bool querySaveStateInfo(const char *target, int slot, SaveStateDescriptor &desc) {
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	Common::String filename = ScummEngine::makeSavegameName(target, slot, false);
+	Common::StringMap metaInfo;
+
+	desc = SaveStateDescriptor(slot, "");
+
+	if (saveFileMan->getSaveMetaInfo(target, filename, metaInfo)) {
+		for (Common::StringMap::const_iterator i = metaInfo.begin(); i != metaInfo.end(); ++i)
+			desc.setVal(i->_key, i->_value);
+		return true;
+	}
+
+	Common::InSaveFile *in = saveFileMan->openForLoading(filename);
+	if (!in)
+		return false;
+
+	// Read the description and the infos in one go, so that the savefile
+	// is only opened and decompressed once
+	InfoStuff infos;
+	bool hasInfos = ScummEngine::loadDescriptionAndInfos(in, desc.description(), &infos);
+	delete in;
+
+	if (hasInfos) {
+		int day = (infos.date >> 24) & 0xFF;
+		int month = (infos.date >> 16) & 0xFF;
+		int year = infos.date & 0xFFFF;
+
+		desc.setSaveDate(year, month, day);
+
+		int hour = (infos.time >> 8) & 0xFF;
+		int minutes = infos.time & 0xFF;
+
+		desc.setSaveTime(hour, minutes);
+
+		minutes = infos.playtime / 60;
+		hour = minutes / 60;
+		minutes %= 60;
+
+		desc.setPlayTime(hour, minutes);
+	}
+
+	metaInfo = desc;
+	metaInfo.erase("save_slot");
+	saveFileMan->setSaveMetaInfo(target, filename, metaInfo);
+
+	return true;
 }
 
 int ScummMetaEngine::getMaximumSaveSlot() const { return 99; }
@@ -1038,7 +1093,6 @@ int ScummMetaEngine::getMaximumSaveSlot() const { return 99; }
 SaveStateList ScummMetaEngine::listSaves(const char *target) const {
 	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
 	Common::StringList filenames;
-	Common::String saveDesc;
 	Common::String pattern = target;
 	pattern += ".s??";
 
@@ -1051,12 +1105,9 @@ SaveStateList ScummMetaEngine::listSaves(const char *target) const {
 		int slotNum = atoi(file->c_str() + file->size() - 2);
 
 		if (slotNum >= 0 && slotNum <= 99) {
-			Common::InSaveFile *in = saveFileMan->openForLoading(*file);
-			if (in) {
-				Scumm::getSavegameName(in, saveDesc, 0);	// FIXME: heversion?!?
-				saveList.push_back(SaveStateDescriptor(slotNum, saveDesc));
-				delete in;
-			}
+			SaveStateDescriptor desc;
+			if (querySaveStateInfo(target, slotNum, desc))
+				saveList.push_back(desc);
 		}
 	}
 
@@ -1066,50 +1117,30 @@ SaveStateList ScummMetaEngine::listSaves(const char *target) const {
 void ScummMetaEngine::removeSaveState(const char *target, int slot) const {
 	Common::String filename = ScummEngine::makeSavegameName(target, slot, false);
 	g_system->getSavefileManager()->removeSavefile(filename);
+	g_system->getSavefileManager()->removeSavefile(ScummEngine::makeDeltaBaseName(filename));
 }
 
 SaveStateDescriptor ScummMetaEngine::querySaveMetaInfos(const char *target, int slot) const {
-	Common::String filename = ScummEngine::makeSavegameName(target, slot, false);
-	Common::InSaveFile *in = g_system->getSavefileManager()->openForLoading(filename);
-
-	if (!in)
+	SaveStateDescriptor desc;
+	if (!querySaveStateInfo(target, slot, desc))
 		return SaveStateDescriptor();
 
-	Common::String saveDesc;
-	Scumm::getSavegameName(in, saveDesc, 0);	// FIXME: heversion?!?
-	delete in;
-
-	// TODO: Cleanup
+	// The thumbnail is not part of the index, it is only loaded for the
+	// savestate the user actually selected.
 	Graphics::Surface *thumbnail = ScummEngine::loadThumbnailFromSlot(target, slot);
 
-	SaveStateDescriptor desc(slot, saveDesc);
 	desc.setDeletableFlag(true);
 	desc.setThumbnail(thumbnail);
 
-	InfoStuff infos;
-	memset(&infos, 0, sizeof(infos));
-	if (ScummEngine::loadInfosFromSlot(target, slot, &infos)) {
-		int day = (infos.date >> 24) & 0xFF;
-		int month = (infos.date >> 16) & 0xFF;
-		int year = infos.date & 0xFFFF;
-
-		desc.setSaveDate(year, month, day);
-
-		int hour = (infos.time >> 8) & 0xFF;
-		int minutes = infos.time & 0xFF;
-
-		desc.setSaveTime(hour, minutes);
-
-		minutes = infos.playtime / 60;
-		hour = minutes / 60;
-		minutes %= 60;
-
-		desc.setPlayTime(hour, minutes);
-	}
-
 	return desc;
 }
 
+#ifdef ENABLE_SCUMM_7_8
+Common::Error ScummMetaEngine::benchVideo(const Common::FSNode &node, Audio::Mixer *mixer) const {
+	return Scumm::benchSmushVideo(node);
+}
+#endif
+
 #if PLUGIN_ENABLED_DYNAMIC(SCUMM)
 	REGISTER_PLUGIN_DYNAMIC(SCUMM, PLUGIN_TYPE_ENGINE, ScummMetaEngine);
 #else
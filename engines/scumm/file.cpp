@@ -35,13 +35,67 @@ namespace Scumm {
 #pragma mark --- ScummFile ---
 #pragma mark -
 
-ScummFile::ScummFile() : _encbyte(0), _subFileStart(0), _subFileLen(0) {
+/**
+ * XOR a block of memory with the given byte, a machine word at a time.
+ */
+static void xorBlock(byte *p, uint32 len, byte value) {
+	while (len > 0 && ((size_t)p & 3)) {
+		*p++ ^= value;
+		len--;
+	}
+
+	const uint32 value32 = value * 0x01010101;
+	uint32 *p32 = (uint32 *)p;
+	for (; len >= 4; len -= 4)
+		*p32++ ^= value32;
+
+	p = (byte *)p32;
+	while (len-- > 0)
+		*p++ ^= value;
+}
+
+ScummFile::ScummFile() : _encbyte(0), _subFileStart(0), _subFileLen(0), _myEos(false),
+	_buf(0), _bufStart(0), _bufLen(0), _bufPos(0) {
+}
+
+ScummFile::~ScummFile() {
+	free(_buf);
 }
 
 void ScummFile::setEnc(byte value) {
+	// The data remaining in the read-ahead buffer was decrypted with the
+	// old value, so convert it to the new one.
+	if (_bufPos < _bufLen && _encbyte != value)
+		xorBlock(_buf + _bufPos, _bufLen - _bufPos, _encbyte ^ value);
 	_encbyte = value;
 }
 
+void ScummFile::resetReadAhead() {
+	_bufStart = File::pos();
+	_bufLen = 0;
+	_bufPos = 0;
+}
+
+uint32 ScummFile::fillReadAhead() {
+	if (!_buf) {
+		_buf = (byte *)malloc(kReadAheadSize);
+		assert(_buf);
+	}
+
+	_bufStart += _bufLen;
+	_bufPos = 0;
+
+	// Don't read past the end of the subfile
+	uint32 len = kReadAheadSize;
+	if (_subFileLen && _subFileStart + _subFileLen - _bufStart < (int32)len)
+		len = _subFileStart + _subFileLen - _bufStart;
+
+	_bufLen = File::read(_buf, len);
+	if (_encbyte)
+		xorBlock(_buf, _bufLen, _encbyte);
+	return _bufLen;
+}
+
 void ScummFile::setSubfileRange(int32 start, int32 len) {
 	// TODO: Add sanity checks
 	const int32 fileSize = File::size();
@@ -60,6 +114,7 @@ void ScummFile::resetSubfile() {
 
 bool ScummFile::open(const Common::String &filename) {
 	if (File::open(filename)) {
+		resetReadAhead();
 		resetSubfile();
 		return true;
 	} else {
@@ -67,6 +122,11 @@ bool ScummFile::open(const Common::String &filename) {
 	}
 }
 
+void ScummFile::close() {
+	File::close();
+	_bufStart = _bufLen = _bufPos = 0;
+}
+
 bool ScummFile::openSubFile(const Common::String &filename) {
 	assert(isOpen());
 
@@ -126,11 +186,11 @@ bool ScummFile::openSubFile(const Common::String &filename) {
 
 
 bool ScummFile::eos() const {
-	return _subFileLen ? _myEos : File::eos();
+	return _myEos;
 }
 
 int32 ScummFile::pos() const {
-	return File::pos() - _subFileStart;
+	return _bufStart + _bufPos - _subFileStart;
 }
 
 int32 ScummFile::size() const {
@@ -138,30 +198,41 @@ int32 ScummFile::size() const {
 }
 
 bool ScummFile::seek(int32 offs, int whence) {
+	switch (whence) {
+	case SEEK_END:
+		offs += _subFileLen ? _subFileStart + _subFileLen : File::size();
+		break;
+	case SEEK_SET:
+		offs += _subFileStart;
+		break;
+	case SEEK_CUR:
+		offs += _bufStart + _bufPos;
+		break;
+	}
+
 	if (_subFileLen) {
 		// Constrain the seek to the subfile
-		switch (whence) {
-		case SEEK_END:
-			offs = _subFileStart + _subFileLen + offs;
-			break;
-		case SEEK_SET:
-			offs += _subFileStart;
-			break;
-		case SEEK_CUR:
-			offs += File::pos();
-			break;
-		}
 		assert((int32)_subFileStart <= offs && offs <= (int32)(_subFileStart + _subFileLen));
-		whence = SEEK_SET;
 	}
-	bool ret = File::seek(offs, whence);
+
+	// Seeks within the read-ahead buffer don't need to touch the file
+	if (_bufStart <= offs && offs <= _bufStart + (int32)_bufLen) {
+		_bufPos = offs - _bufStart;
+		_myEos = false;
+		return true;
+	}
+
+	bool ret = File::seek(offs, SEEK_SET);
 	if (ret)
 		_myEos = false;
+	resetReadAhead();
 	return ret;
 }
 
 uint32 ScummFile::read(void *dataPtr, uint32 dataSize) {
-	uint32 realLen;
+	byte *dst = (byte *)dataPtr;
+	uint32 realLen = 0;
+	uint32 len;
 
 	if (_subFileLen) {
 		// Limit the amount we read by the subfile boundaries.
@@ -174,19 +245,35 @@ uint32 ScummFile::read(void *dataPtr, uint32 dataSize) {
 		}
 	}
 
-	realLen = File::read(dataPtr, dataSize);
-
+	// First hand out what is left in the read-ahead buffer
+	len = MIN(dataSize, _bufLen - _bufPos);
+	if (len > 0) {
+		memcpy(dst, _buf + _bufPos, len);
+		_bufPos += len;
+		realLen += len;
+	}
 
-	// If an encryption byte was specified, XOR the data we just read by it.
-	// This simple kind of "encryption" was used by some of the older SCUMM
-	// games.
-	if (_encbyte) {
-		byte *p = (byte *)dataPtr;
-		byte *end = p + realLen;
-		while (p < end)
-			*p++ ^= _encbyte;
+	if (realLen < dataSize) {
+		if (dataSize - realLen >= kReadAheadSize) {
+			// Big reads go to the file directly. If an encryption byte was
+			// specified, XOR the data we just read by it. This simple kind
+			// of "encryption" was used by some of the older SCUMM games.
+			len = File::read(dst + realLen, dataSize - realLen);
+			if (_encbyte)
+				xorBlock(dst + realLen, len, _encbyte);
+			realLen += len;
+			resetReadAhead();
+		} else if (fillReadAhead() > 0) {
+			len = MIN(dataSize - realLen, _bufLen);
+			memcpy(dst + realLen, _buf, len);
+			_bufPos = len;
+			realLen += len;
+		}
 	}
 
+	if (realLen < dataSize)
+		_myEos = true;
+
 	return realLen;
 }
 
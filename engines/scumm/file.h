@@ -50,22 +50,41 @@ public:
 #endif
 };
 
+/**
+ * The data files of the SCUMM games are read in many tiny pieces, so
+ * ScummFile reads ahead in larger blocks, which are then decrypted as a
+ * whole. The underlying file is always positioned at the end of the
+ * read-ahead buffer, i.e. at _bufStart + _bufLen.
+ */
 class ScummFile : public BaseScummFile {
 private:
+	enum {
+		kReadAheadSize = 16 * 1024
+	};
+
 	byte _encbyte;
 	int32	_subFileStart;
 	int32	_subFileLen;
-	bool	_myEos; // Have we read past the end of the subfile?
+	bool	_myEos; // Have we read past the end of the (sub)file?
+
+	byte	*_buf;		// read-ahead buffer, holding already decrypted data
+	int32	_bufStart;	// file offset of the buffer start
+	uint32	_bufLen;	// number of valid bytes in the buffer
+	uint32	_bufPos;	// current read position in the buffer
 
 	void setSubfileRange(int32 start, int32 len);
 	void resetSubfile();
+	void resetReadAhead();
+	uint32 fillReadAhead();
 
 public:
 	ScummFile();
+	~ScummFile();
 	void setEnc(byte value);
 
 	bool open(const Common::String &filename);
 	bool openSubFile(const Common::String &filename);
+	void close();
 
 	void clearErr() { _myEos = false; BaseScummFile::clearErr(); }
 
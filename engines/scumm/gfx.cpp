@@ -35,6 +35,12 @@
 #include "scumm/he/wiz_he.h"
 #include "scumm/util.h"
 
+#if !defined(USE_ARM_GFX_ASM) && defined(__SSE2__)
+#include <emmintrin.h>
+#elif !defined(USE_ARM_GFX_ASM) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#include <arm_neon.h>
+#endif
+
 #ifdef USE_ARM_GFX_ASM
 extern "C" void asmDrawStripToScreen(int height, int width, void const* text, void const* src, byte* dst,
 	int vsPitch, int vmScreenWidth, int textSurfacePitch);
@@ -47,6 +53,7 @@ static void blit(byte *dst, int dstPitch, const byte *src, int srcPitch, int w,
 static void fill(byte *dst, int dstPitch, uint16 color, int w, int h, uint8 bitDepth);
 #ifndef USE_ARM_GFX_ASM
 static void copy8Col(byte *dst, int dstPitch, const byte *src, int height, uint8 bitDepth);
+static void compositeText(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch, int w, int h);
 #endif
 static void clear8Col(byte *dst, int dstPitch, int height, uint8 bitDepth);
 
@@ -665,36 +672,8 @@ void ScummEngine::drawStripToScreen(VirtScreen *vs, int x, int width, int top, i
 				textPtr += _textSurface.pitch - width * m;
 			}
 		} else {
-			// We blit four pixels at a time, for improved performance.
-			const uint32 *src32 = (const uint32 *)src;
-			uint32 *dst32 = (uint32 *)_compositeBuf;
-
-			vsPitch >>= 2;
-
-			const uint32 *text32 = (const uint32 *)text;
-			const int textPitch = (_textSurface.pitch - width * m) >> 2;
-			for (int h = height * m; h > 0; --h) {
-				for (int w = width * m; w > 0; w -= 4) {
-					uint32 temp = *text32++;
-
-					// Generate a byte mask for those text pixels (bytes) with
-					// value CHARSET_MASK_TRANSPARENCY. In the end, each byte
-					// in mask will be either equal to 0x00 or 0xFF.
-					// Doing it this way avoids branches and bytewise operations,
-					// at the cost of readability ;).
-					uint32 mask = temp ^ CHARSET_MASK_TRANSPARENCY_32;
-					mask = (((mask & 0x7f7f7f7f) + 0x7f7f7f7f) | mask) & 0x80808080;
-					mask = ((mask >> 7) + 0x7f7f7f7f) ^ 0x80808080;
-
-					// The following line is equivalent to this code:
-					//   *dst32++ = (*src32++ & mask) | (temp & ~mask);
-					// However, some compilers can generate somewhat better
-					// machine code for this equivalent statement:
-					*dst32++ = ((temp ^ *src32++) & mask) ^ temp;
-				}
-				src32 += vsPitch;
-				text32 += textPitch;
-			}
+			compositeText(_compositeBuf, (const byte *)src, width * m + vsPitch,
+				(const byte *)text, _textSurface.pitch, width * m, height * m);
 		}
 #endif
 		src = _compositeBuf;
@@ -1182,6 +1161,62 @@ static void copy8Col(byte *dst, int dstPitch, const byte *src, int height, uint8
 	} while (--height);
 }
 
+/**
+ * Compose the text surface over the game graphics: Every pixel of the
+ * (8 bit) text which isn't CHARSET_MASK_TRANSPARENCY replaces the game
+ * graphics pixel. The width has to be a multiple of 4.
+ */
+static void compositeText(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch, int w, int h) {
+#if defined(__SSE2__)
+	const __m128i transparency = _mm_set1_epi8((char)CHARSET_MASK_TRANSPARENCY);
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+	const uint8x16_t transparency = vdupq_n_u8(CHARSET_MASK_TRANSPARENCY);
+#endif
+
+	do {
+		int x = 0;
+
+		// Sixteen pixels at a time if there is SIMD support
+#if defined(__SSE2__)
+		for (; x + 16 <= w; x += 16) {
+			const __m128i t = _mm_loadu_si128((const __m128i *)(text + x));
+			const __m128i mask = _mm_cmpeq_epi8(t, transparency);
+			const __m128i s = _mm_loadu_si128((const __m128i *)(src + x));
+			_mm_storeu_si128((__m128i *)(dst + x), _mm_or_si128(_mm_and_si128(mask, s), _mm_andnot_si128(mask, t)));
+		}
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+		for (; x + 16 <= w; x += 16) {
+			const uint8x16_t t = vld1q_u8(text + x);
+			vst1q_u8(dst + x, vbslq_u8(vceqq_u8(t, transparency), vld1q_u8(src + x), t));
+		}
+#endif
+
+		// Otherwise, or for the rest, four pixels at a time
+		for (; x < w; x += 4) {
+			uint32 temp = *(const uint32 *)(text + x);
+
+			// Generate a byte mask for those text pixels (bytes) with
+			// value CHARSET_MASK_TRANSPARENCY. In the end, each byte
+			// in mask will be either equal to 0x00 or 0xFF.
+			// Doing it this way avoids branches and bytewise operations,
+			// at the cost of readability ;).
+			uint32 mask = temp ^ CHARSET_MASK_TRANSPARENCY_32;
+			mask = (((mask & 0x7f7f7f7f) + 0x7f7f7f7f) | mask) & 0x80808080;
+			mask = ((mask >> 7) + 0x7f7f7f7f) ^ 0x80808080;
+
+			// The following line is equivalent to this code:
+			//   dst = (src & mask) | (temp & ~mask);
+			// However, some compilers can generate somewhat better
+			// machine code for this equivalent statement:
+			*(uint32 *)(dst + x) = ((temp ^ *(const uint32 *)(src + x)) & mask) ^ temp;
+		}
+
+		dst += w;
+		src += srcPitch;
+		text += textPitch;
+	} while (--h);
+}
+
 #endif /* USE_ARM_GFX_ASM */
 
 static void clear8Col(byte *dst, int dstPitch, int height, uint8 bitDepth) {
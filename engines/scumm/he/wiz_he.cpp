@@ -834,6 +834,83 @@ void Wiz::write8BitColor(uint8 *dstPtr, const uint8 *dataPtr, int dstType, const
 	}
 }
 
+/**
+ * Write a run of 'count' pixels of the color at src, starting at dst and
+ * advancing by dstInc. Equivalent to calling write8BitColor for each pixel,
+ * but the color lookups are only done once.
+ */
+template <int type>
+void Wiz::write8BitSolidRun(uint8 *dstPtr, const uint8 *dataPtr, int count, int dstInc, int dstType, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth) {
+	if (bitDepth == 2) {
+		if (type == kWizXMap) {
+			const uint16 srcColor = (READ_LE_UINT16(palPtr + *dataPtr * 2) >> 1) & 0x7DEF;
+			while (count--) {
+				const uint16 dstColor = (READ_UINT16(dstPtr) >> 1) & 0x7DEF;
+				writeColor(dstPtr, dstType, srcColor + dstColor);
+				dstPtr += dstInc;
+			}
+		} else {
+			const uint16 color = (type == kWizRMap) ? READ_LE_UINT16(palPtr + *dataPtr * 2) : *dataPtr;
+			while (count--) {
+				writeColor(dstPtr, dstType, color);
+				dstPtr += dstInc;
+			}
+		}
+	} else {
+		if (type == kWizXMap) {
+			const uint8 *xmap = xmapPtr + *dataPtr * 256;
+			while (count--) {
+				*dstPtr = xmap[*dstPtr];
+				dstPtr += dstInc;
+			}
+		} else {
+			const uint8 color = (type == kWizRMap) ? palPtr[*dataPtr] : *dataPtr;
+			// Calling memset only pays off for longer runs
+			if (count >= 16) {
+				if (dstInc < 0)
+					dstPtr -= count - 1;
+				memset(dstPtr, color, count);
+			} else {
+				while (count--) {
+					*dstPtr = color;
+					dstPtr += dstInc;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Write the 'count' pixels at src, starting at dst and advancing by dstInc.
+ * Equivalent to calling write8BitColor for each pixel.
+ */
+template <int type>
+void Wiz::write8BitLiteralRun(uint8 *dstPtr, const uint8 *dataPtr, int count, int dstInc, int dstType, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth) {
+	if (bitDepth == 2) {
+		while (count--) {
+			write8BitColor<type>(dstPtr, dataPtr++, dstType, palPtr, xmapPtr, bitDepth);
+			dstPtr += dstInc;
+		}
+	} else if (type == kWizXMap) {
+		while (count--) {
+			*dstPtr = xmapPtr[*dataPtr++ * 256 + *dstPtr];
+			dstPtr += dstInc;
+		}
+	} else if (type == kWizRMap) {
+		while (count--) {
+			*dstPtr = palPtr[*dataPtr++];
+			dstPtr += dstInc;
+		}
+	} else if (dstInc > 0 && count >= 16) {
+		memcpy(dstPtr, dataPtr, count);
+	} else {
+		while (count--) {
+			*dstPtr = *dataPtr++;
+			dstPtr += dstInc;
+		}
+	}
+}
+
 template <int type>
 void Wiz::decompressWizImage(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth) {
 	const uint8 *dataPtr, *dataPtrNext;
@@ -905,10 +982,8 @@ void Wiz::decompressWizImage(uint8 *dst, int dstPitch, int dstType, const uint8
 					if (w < 0) {
 						code += w;
 					}
-					while (code--) {
-						write8BitColor<type>(dstPtr, dataPtr, dstType, palPtr, xmapPtr, bitDepth);
-						dstPtr += dstInc;
-					}
+					write8BitSolidRun<type>(dstPtr, dataPtr, code, dstInc, dstType, palPtr, xmapPtr, bitDepth);
+					dstPtr += dstInc * code;
 					dataPtr++;
 				} else {
 					code = (code >> 2) + 1;
@@ -925,11 +1000,9 @@ void Wiz::decompressWizImage(uint8 *dst, int dstPitch, int dstType, const uint8
 					if (w < 0) {
 						code += w;
 					}
-					while (code--) {
-						write8BitColor<type>(dstPtr, dataPtr, dstType, palPtr, xmapPtr, bitDepth);
-						dataPtr++;
-						dstPtr += dstInc;
-					}
+					write8BitLiteralRun<type>(dstPtr, dataPtr, code, dstInc, dstType, palPtr, xmapPtr, bitDepth);
+					dataPtr += code;
+					dstPtr += dstInc * code;
 				}
 			}
 		}
@@ -1960,26 +2033,49 @@ void Wiz::drawWizPolygonImage(uint8 *dst, const uint8 *src, const uint8 *mask, i
 		++y_start;
 	}
 
+	const int32 srcSize = wizW * wizH;
 	pra = &pdd.ra[0];
 	for (i = 0; i < pdd.rAreasNum; ++i, ++pra) {
 		uint8 *dstPtr = dst + pra->dst_offs;
 		int32 w = pra->w;
 		int32 x_acc = pra->x_s;
 		int32 y_acc = pra->y_s;
-		while (--w) {
-			int32 src_offs = (y_acc >> 16) * wizW + (x_acc >> 16);
-			assert(src_offs < wizW * wizH);
-			x_acc += pra->x_step;
-			y_acc += pra->y_step;
-			if (bitDepth == 2) {
-				if (transColor == -1 || transColor != READ_LE_UINT16(src + src_offs * 2)) {
-					writeColor(dstPtr, dstType, READ_LE_UINT16(src + src_offs * 2));
-				}
-			} else {
-				if (transColor == -1 || transColor != src[src_offs])
-					*dstPtr = src[src_offs];
+		const int32 x_step = pra->x_step;
+		const int32 y_step = pra->y_step;
+		if (bitDepth == 2) {
+			while (--w) {
+				const int32 src_offs = (y_acc >> 16) * wizW + (x_acc >> 16);
+				assert(src_offs < srcSize);
+				x_acc += x_step;
+				y_acc += y_step;
+				const uint16 color = READ_LE_UINT16(src + src_offs * 2);
+				if (transColor == -1 || transColor != color)
+					writeColor(dstPtr, dstType, color);
+				dstPtr += 2;
+			}
+		} else if (y_step == 0) {
+			// Unrotated images: the whole span samples a single source row
+			const int32 row_offs = (y_acc >> 16) * wizW;
+			while (--w) {
+				const int32 src_offs = row_offs + (x_acc >> 16);
+				assert(src_offs < srcSize);
+				x_acc += x_step;
+				const uint8 color = src[src_offs];
+				if (transColor == -1 || transColor != color)
+					*dstPtr = color;
+				dstPtr++;
+			}
+		} else {
+			while (--w) {
+				const int32 src_offs = (y_acc >> 16) * wizW + (x_acc >> 16);
+				assert(src_offs < srcSize);
+				x_acc += x_step;
+				y_acc += y_step;
+				const uint8 color = src[src_offs];
+				if (transColor == -1 || transColor != color)
+					*dstPtr = color;
+				dstPtr++;
 			}
-			dstPtr += bitDepth;
 		}
 	}
 
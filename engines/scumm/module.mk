@@ -43,6 +43,7 @@ MODULE_OBJS := \
 	player_v2cms.o \
 	player_v3a.o \
 	player_v4a.o \
+	profiler.o \
 	resource_v2.o \
 	resource_v3.o \
 	resource_v4.o \
@@ -91,6 +92,7 @@ MODULE_OBJS += \
 	smush/codec37.o \
 	smush/codec47.o \
 	smush/imuse_channel.o \
+	smush/smush_bench.o \
 	smush/smush_player.o \
 	smush/saud_channel.o \
 	smush/smush_mixer.o \
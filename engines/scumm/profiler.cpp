@@ -0,0 +1,156 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#include "common/algorithm.h"
+#include "common/array.h"
+#include "common/file.h"
+
+#include "scumm/profiler.h"
+#include "scumm/scumm.h"
+
+namespace Scumm {
+
+struct ProfileLine {
+	const ScriptProfiler::Entry *entry;
+	uint32 id;
+};
+
+struct ProfileLineLess {
+	bool operator()(const ProfileLine &a, const ProfileLine &b) const {
+		if (a.entry->time != b.entry->time)
+			return a.entry->time > b.entry->time;
+		return a.id < b.id;
+	}
+};
+
+static const char *whereName(int where) {
+	switch (where) {
+	case WIO_INVENTORY:
+		return "inventory";
+	case WIO_ROOM:
+		return "object";
+	case WIO_GLOBAL:
+		return "global";
+	case WIO_LOCAL:
+		return "local";
+	case WIO_FLOBJECT:
+		return "flobject";
+	default:
+		return "?";
+	}
+}
+
+static double percentOf(double part, double total) {
+	return (total > 0) ? part * 100.0 / total : 0.0;
+}
+
+ScriptProfiler::ScriptProfiler() {
+	clear();
+}
+
+void ScriptProfiler::clear() {
+	for (int i = 0; i < 256; i++)
+		_opcodes[i] = Entry();
+	_scripts.clear();
+	_childTime = 0;
+	_totalOpcodes = 0;
+	_totalTime = 0;
+}
+
+const char *ScriptProfiler::getTimeUnits() {
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	return "cycles";
+#else
+	return "ms";
+#endif
+}
+
+void ScriptProfiler::report(ScummEngine *vm, Common::StringList &lines, int maxEntries) const {
+	Common::Array<ProfileLine> sorted;
+	char buf[128];
+	int i;
+
+	snprintf(buf, sizeof(buf), "%u opcodes in %u scripts, %.0f %s",
+		_totalOpcodes, _scripts.size(), _totalTime, getTimeUnits());
+	lines.push_back(buf);
+
+	for (ScriptMap::const_iterator it = _scripts.begin(); it != _scripts.end(); ++it) {
+		ProfileLine line = { &it->_value, it->_key };
+		sorted.push_back(line);
+	}
+	Common::sort(sorted.begin(), sorted.end(), ProfileLineLess());
+
+	lines.push_back("");
+	snprintf(buf, sizeof(buf), "%14s %6s %10s %8s  %s", getTimeUnits(), "%", "opcodes", "slices", "script");
+	lines.push_back(buf);
+	for (i = 0; i < (int)sorted.size() && i < maxEntries; i++) {
+		const ScriptProfiler::Entry &e = *sorted[i].entry;
+		snprintf(buf, sizeof(buf), "%14.0f %6.2f %10u %8u  %s %u",
+			e.time, percentOf(e.time, _totalTime), e.count, e.slices,
+			whereName(sorted[i].id >> 16), sorted[i].id & 0xFFFF);
+		lines.push_back(buf);
+	}
+
+	sorted.clear();
+	for (i = 0; i < 256; i++) {
+		if (_opcodes[i].count) {
+			ProfileLine line = { &_opcodes[i], (uint32)i };
+			sorted.push_back(line);
+		}
+	}
+	Common::sort(sorted.begin(), sorted.end(), ProfileLineLess());
+
+	lines.push_back("");
+	snprintf(buf, sizeof(buf), "%14s %6s %10s %10s  %s", getTimeUnits(), "%", "count", "average", "opcode");
+	lines.push_back(buf);
+	for (i = 0; i < (int)sorted.size() && i < maxEntries; i++) {
+		const ScriptProfiler::Entry &e = *sorted[i].entry;
+		const char *desc = vm->getOpcodeDesc(sorted[i].id);
+		snprintf(buf, sizeof(buf), "%14.0f %6.2f %10u %10.1f  [%02X] %s",
+			e.time, percentOf(e.time, _totalTime), e.count, e.time / e.count,
+			sorted[i].id, desc ? desc : "");
+		lines.push_back(buf);
+	}
+}
+
+bool ScriptProfiler::dump(ScummEngine *vm, const char *filename) const {
+	Common::DumpFile out;
+	Common::StringList lines;
+
+	if (!out.open(filename)) {
+		warning("ScriptProfiler: Could not open '%s' for writing", filename);
+		return false;
+	}
+
+	report(vm, lines, 0x7FFFFFFF);
+	for (uint i = 0; i < lines.size(); i++) {
+		out.writeString(lines[i]);
+		out.writeByte('\n');
+	}
+	out.finalize();
+	return !out.err();
+}
+
+} // End of namespace Scumm
@@ -0,0 +1,142 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#ifndef SCUMM_PROFILER_H
+#define SCUMM_PROFILER_H
+
+#include "common/flathashmap.h"
+#include "common/str.h"
+#include "common/system.h"
+
+namespace Scumm {
+
+class ScummEngine;
+
+/**
+ * Collects per-script and per-opcode execution counts and times.
+ *
+ * The profiler only exists while profiling is enabled (see the "profile"
+ * debugger command and the "script_profile" config key), so the script
+ * interpreter pays for a single NULL check per opcode otherwise.
+ *
+ * Times are "self" times: an opcode which runs a nested script, e.g.
+ * startScript with the recursive flag, is not charged for the opcodes of
+ * that script, those are accounted to the nested script instead. On x86
+ * the times are taken from the CPU time stamp counter, elsewhere they
+ * fall back to milliseconds, which is only useful over long runs.
+ */
+class ScriptProfiler {
+public:
+	struct Entry {
+		uint32 count;	///< Opcodes executed (scripts) or times executed (opcodes)
+		uint32 slices;	///< Times the script got to run (scripts only)
+		double time;	///< Self time, in counter units
+
+		Entry() : count(0), slices(0), time(0) {}
+	};
+
+	/** State saved across one opcode, see beginOpcode() and endOpcode(). */
+	struct Sample {
+		uint32 start;
+		uint32 outerChildTime;
+	};
+
+	ScriptProfiler();
+
+	void clear();
+
+	/** Name of the file the profile is written to on exit, if any. */
+	const Common::String &getDumpFile() const { return _dumpFile; }
+	void setDumpFile(const Common::String &filename) { _dumpFile = filename; }
+
+	/** Units of the times, "cycles" or "ms". */
+	static const char *getTimeUnits();
+
+	void beginSlice(int where, int number) {
+		_scripts[makeKey(where, number)].slices++;
+	}
+
+	void beginOpcode(Sample &sample) {
+		sample.outerChildTime = _childTime;
+		_childTime = 0;
+		sample.start = readCounter();
+	}
+
+	void endOpcode(const Sample &sample, byte opcode, int where, int number) {
+		const uint32 elapsed = readCounter() - sample.start;
+		const uint32 self = (elapsed > _childTime) ? elapsed - _childTime : 0;
+
+		Entry &op = _opcodes[opcode];
+		op.count++;
+		op.time += self;
+
+		Entry &script = _scripts[makeKey(where, number)];
+		script.count++;
+		script.time += self;
+
+		_totalTime += self;
+		_totalOpcodes++;
+		_childTime = sample.outerChildTime + elapsed;
+	}
+
+	/**
+	 * Format the profile as text, one line per array entry, listing at
+	 * most maxEntries scripts and opcodes sorted by their self time.
+	 */
+	void report(ScummEngine *vm, Common::StringList &lines, int maxEntries) const;
+
+	/** Write the full profile to the given file. */
+	bool dump(ScummEngine *vm, const char *filename) const;
+
+private:
+	typedef Common::FlatHashMap<uint32, Entry> ScriptMap;
+
+	static uint32 makeKey(int where, int number) {
+		return ((uint32)(where & 0xFF) << 16) | (uint16)number;
+	}
+
+	static uint32 readCounter() {
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+		uint32 lo, hi;
+		__asm__ __volatile__("rdtsc" : "=a" (lo), "=d" (hi));
+		return lo;
+#else
+		return g_system->getMillis();
+#endif
+	}
+
+	Entry _opcodes[256];
+	ScriptMap _scripts;
+
+	uint32 _childTime;
+	uint32 _totalOpcodes;
+	double _totalTime;
+
+	Common::String _dumpFile;
+};
+
+} // End of namespace Scumm
+
+#endif
@@ -50,6 +50,25 @@ enum {
 	RS_MODIFIED = 0x10
 };
 
+enum {
+	// Reload costs as determined by getReloadCost()
+	kReloadCostSameRoom = 0,
+	kReloadCostSameDisk = 1,
+	kReloadCostOtherDisk = 2,
+	kNumReloadCosts = 3
+};
+
+static inline uint32 makeAgeLink(int type, int idx) {
+	return ((uint32)(type + 1) << 16) | idx;
+}
+
+static inline int ageLinkType(uint32 link) {
+	return (link >> 16) - 1;
+}
+
+static inline int ageLinkIndex(uint32 link) {
+	return link & 0xFFFF;
+}
 
 
 extern const char *resTypeFromId(int id);
@@ -527,6 +546,24 @@ void ResourceManager::allocResTypeData(int id, uint32 tag, int num_, const char
 	if (num_ >= 8000)
 		error("Too many %ss (%d) in directory", name_, num_);
 
+	if (_ageNext[id]) {
+		// The type is being reallocated (e.g. on restart), which loses all
+		// its resources; make sure they don't linger in the age buckets.
+		for (int counter = 0; counter < kNumAgeBuckets; counter++) {
+			uint32 link = _ageBucket[counter];
+			while (link) {
+				const int type = ageLinkType(link);
+				const int idx = ageLinkIndex(link);
+				link = _ageNext[type][idx];
+				if (type == id)
+					unlinkAgeBucket(type, idx);
+			}
+		}
+		free(_ageNext[id]);
+		free(_agePrev[id]);
+		_ageNext[id] = _agePrev[id] = 0;
+	}
+
 	mode[id] = mode_;
 	num[id] = num_;
 	tags[id] = tag;
@@ -538,6 +575,8 @@ void ResourceManager::allocResTypeData(int id, uint32 tag, int num_, const char
 	if (mode_) {
 		roomno[id] = (byte *)calloc(num_, sizeof(byte));
 		roomoffs[id] = (uint32 *)calloc(num_, sizeof(uint32));
+		_ageNext[id] = (uint32 *)calloc(num_, sizeof(uint32));
+		_agePrev[id] = (uint32 *)calloc(num_, sizeof(uint32));
 	}
 
 	if (_vm->_game.heversion >= 70) {
@@ -606,6 +645,7 @@ void ScummEngine::ensureResourceLoaded(int type, int i) {
 	if (addr)
 		return;
 
+	_res->countResourceAccess(false);
 	loadResource(type, i);
 
 	if (_game.version == 5 && type == rtRoom && i == _roomResource)
@@ -725,8 +765,11 @@ byte *ScummEngine::getResourceAddress(int type, int idx) {
 		return NULL;
 	}
 
-	if (_res->mode[type] && !_res->address[type][idx]) {
-		ensureResourceLoaded(type, idx);
+	if (_res->mode[type]) {
+		if (!_res->address[type][idx])
+			ensureResourceLoaded(type, idx);
+		else
+			_res->countResourceAccess(true);
 	}
 
 	if (!(ptr = (byte *)_res->address[type][idx])) {
@@ -767,7 +810,11 @@ void ResourceManager::increaseResourceCounter() {
 	int i, j;
 	byte counter;
 
+	// The usage counters of expirable resources are aged by shifting the
+	// age buckets; only the other resources have to be visited one by one.
 	for (i = rtFirst; i <= rtLast; i++) {
+		if (_ageNext[i])
+			continue;
 		for (j = num[i]; --j >= 0;) {
 			counter = flags[i][j] & RF_USAGE;
 			if (counter && counter < RF_USAGE_MAX) {
@@ -775,11 +822,82 @@ void ResourceManager::increaseResourceCounter() {
 			}
 		}
 	}
+
+	// The second oldest bucket merges into the oldest one, since the
+	// counters saturate at RF_USAGE_MAX.
+	uint32 link = _ageBucket[RF_USAGE_MAX - 1];
+	while (link) {
+		i = ageLinkType(link);
+		j = ageLinkIndex(link);
+		link = _ageNext[i][j];
+		setResourceCounter(i, j, RF_USAGE_MAX);
+	}
+
+	// All other buckets move up by one.
+	for (counter = RF_USAGE_MAX - 1; counter > 1; counter--) {
+		_ageBucket[counter] = link = _ageBucket[counter - 1];
+		while (link) {
+			i = ageLinkType(link);
+			j = ageLinkIndex(link);
+			link = _ageNext[i][j];
+			flags[i][j] = (flags[i][j] & ~RF_USAGE) | counter;
+		}
+	}
+	_ageBucket[1] = 0;
 }
 
 void ResourceManager::setResourceCounter(int type, int idx, byte flag) {
-	flags[type][idx] &= ~RF_USAGE;
-	flags[type][idx] |= flag;
+	if (_ageNext[type] && address[type][idx]) {
+		if ((flags[type][idx] & RF_USAGE) == flag)
+			return;
+		unlinkAgeBucket(type, idx);
+		flags[type][idx] &= ~RF_USAGE;
+		flags[type][idx] |= flag;
+		linkAgeBucket(type, idx);
+	} else {
+		flags[type][idx] &= ~RF_USAGE;
+		flags[type][idx] |= flag;
+	}
+}
+
+void ResourceManager::linkAgeBucket(int type, int idx) {
+	const byte counter = flags[type][idx] & RF_USAGE;
+	const uint32 link = makeAgeLink(type, idx);
+	const uint32 next = _ageBucket[counter];
+
+	if (next)
+		_agePrev[ageLinkType(next)][ageLinkIndex(next)] = link;
+	_ageNext[type][idx] = next;
+	_agePrev[type][idx] = 0;
+	_ageBucket[counter] = link;
+}
+
+void ResourceManager::unlinkAgeBucket(int type, int idx) {
+	const byte counter = flags[type][idx] & RF_USAGE;
+	const uint32 next = _ageNext[type][idx];
+	const uint32 prev = _agePrev[type][idx];
+
+	if (prev)
+		_ageNext[ageLinkType(prev)][ageLinkIndex(prev)] = next;
+	else
+		_ageBucket[counter] = next;
+	if (next)
+		_agePrev[ageLinkType(next)][ageLinkIndex(next)] = prev;
+}
+
+int ResourceManager::getReloadCost(int type, int idx) {
+	// Reloading a resource from the room which was loaded last requires
+	// no seeking to speak of, and one from another room on the same disk
+	// at least doesn't require a different file to be opened.
+	const int room = _vm->getResourceRoomNr(type, idx);
+	const int lastRoom = _vm->_lastLoadedRoom;
+
+	if (room == lastRoom)
+		return kReloadCostSameRoom;
+	if (lastRoom > 0 && room > 0 && room < num[rtRoom] && lastRoom < num[rtRoom] &&
+			roomno[rtRoom] && roomno[rtRoom][room] == roomno[rtRoom][lastRoom])
+		return kReloadCostSameDisk;
+	return kReloadCostOtherDisk;
 }
 
 /* 2 bytes safety area to make "precaching" of bytes in the gdi drawer easier */
@@ -813,7 +931,10 @@ byte *ResourceManager::createResource(int type, int idx, uint32 size) {
 
 	address[type][idx] = (byte *)ptr;
 	((MemBlkHeader *)ptr)->size = size;
-	setResourceCounter(type, idx, 1);
+	flags[type][idx] &= ~RF_USAGE;
+	flags[type][idx] |= 1;
+	if (_ageNext[type])
+		linkAgeBucket(type, idx);
 	return (byte *)ptr + sizeof(MemBlkHeader);	/* skip header */
 }
 
@@ -853,6 +974,8 @@ void ResourceManager::nukeResource(int type, int idx) {
 	ptr = address[type][idx];
 	if (ptr != NULL) {
 		debugC(DEBUG_RESOURCE, "nukeResource(%s,%d)", resTypeFromId(type), idx);
+		if (_ageNext[type])
+			unlinkAgeBucket(type, idx);
 		address[type][idx] = 0;
 		flags[type][idx] = 0;
 		status[type][idx] &= ~RS_MODIFIED;
@@ -949,9 +1072,8 @@ bool ResourceManager::isModified(int type, int i) const {
 
 void ResourceManager::expireResources(uint32 size) {
 	int i, j;
-	byte flag;
-	byte best_counter;
-	int best_type, best_res = 0;
+	int counter, cost;
+	uint32 link;
 	uint32 oldAllocatedSize;
 
 	if (_expireCounter != 0xFF) {
@@ -964,26 +1086,26 @@ void ResourceManager::expireResources(uint32 size) {
 
 	oldAllocatedSize = _allocatedSize;
 
-	do {
-		best_type = 0;
-		best_counter = 2;
-
-		for (i = rtFirst; i <= rtLast; i++)
-			if (mode[i]) {
-				for (j = num[i]; --j >= 0;) {
-					flag = flags[i][j];
-					if (!(flag & RF_LOCK) && flag >= best_counter && address[i][j] && !_vm->isResourceInUse(i, j)) {
-						best_counter = flag;
-						best_type = i;
-						best_res = j;
-					}
+	// Expire the least recently used resources first; resources used
+	// since the last aging (i.e. with a counter of 1) are never expired.
+	// Among resources of the same age, those which are cheapest to
+	// reload go first.
+	for (counter = RF_USAGE_MAX; counter >= 2 && size + _allocatedSize > _minHeapThreshold; counter--) {
+		for (cost = 0; cost < kNumReloadCosts && size + _allocatedSize > _minHeapThreshold; cost++) {
+			link = _ageBucket[counter];
+			while (link && size + _allocatedSize > _minHeapThreshold) {
+				i = ageLinkType(link);
+				j = ageLinkIndex(link);
+				link = _ageNext[i][j];
+
+				if (!(flags[i][j] & RF_LOCK) && getReloadCost(i, j) == cost && !_vm->isResourceInUse(i, j)) {
+					_numExpired++;
+					_expiredSize += ((MemBlkHeader *)address[i][j])->size;
+					nukeResource(i, j);
 				}
 			}
-
-		if (!best_type)
-			break;
-		nukeResource(best_type, best_res);
-	} while (size + _allocatedSize > _minHeapThreshold);
+		}
+	}
 
 	increaseResourceCounter();
 
@@ -1002,6 +1124,8 @@ void ResourceManager::freeResources() {
 		free(status[i]);
 		free(roomno[i]);
 		free(roomoffs[i]);
+		free(_ageNext[i]);
+		free(_agePrev[i]);
 
 		free(globsize[i]);
 	}
@@ -1051,6 +1175,7 @@ void ResourceManager::resourceStats() {
 		}
 
 	debug(1, "Total allocated size=%d, locked=%d(%d)", _allocatedSize, lockedSize, lockedNum);
+	debug(1, "Hits=%d, misses=%d, expired=%d(%d)", _numHits, _numMisses, _numExpired, _expiredSize);
 }
 
 void ScummEngine_v5::readMAXS(int blockSize) {
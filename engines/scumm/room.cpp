@@ -131,8 +131,11 @@ void ScummEngine::startScene(int room, Actor *a, int objectNr) {
 	if (VAR_ROOM_RESOURCE != 0xFF)
 		VAR(VAR_ROOM_RESOURCE) = _roomResource;
 
-	if (room != 0)
+	if (room != 0) {
+		const uint32 loadStart = _system->getMillis();
 		ensureResourceLoaded(rtRoom, room);
+		debugC(DEBUG_RESOURCE, "Loading room %d took %d ms", room, _system->getMillis() - loadStart);
+	}
 
 	clearRoomObjects();
 
@@ -479,6 +482,7 @@ void ScummEngine::resetRoomSubBlocks() {
 
 	_res->nukeResource(rtMatrix, 1);
 	_res->nukeResource(rtMatrix, 2);
+	invalidateBoxCache();
 	if (_game.features & GF_SMALL_HEADER) {
 		ptr = findResourceData(MKID_BE('BOXD'), roomptr);
 		if (ptr) {
@@ -729,6 +733,7 @@ void ScummEngine_v3old::resetRoomSubBlocks() {
 	//
 	_res->nukeResource(rtMatrix, 1);
 	_res->nukeResource(rtMatrix, 2);
+	invalidateBoxCache();
 
 	if (_game.version <= 2)
 		ptr = roomptr + *(roomptr + 0x15);
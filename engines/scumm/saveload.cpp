@@ -24,6 +24,8 @@
  */
 
 #include "common/config-manager.h"
+#include "common/delta.h"
+#include "common/md5.h"
 #include "common/savefile.h"
 #include "common/system.h"
 #include "common/zlib.h"
@@ -72,6 +74,21 @@ struct SaveInfoSection {
 
 #define INFOSECTION_VERSION 2
 
+enum {
+	/**
+	 * The number of delta saves made off the same base, before a full save
+	 * is made again. This bounds the size of the deltas, which grow as the
+	 * state drifts away from the base.
+	 */
+	kDeltaSavesPerSnapshot = 8,
+
+	/**
+	 * The minimum size of the serialized state for delta saves. Smaller
+	 * states, i.e. those of all but the HE games, are always saved in full.
+	 */
+	kMinDeltaStateSize = 512 * 1024
+};
+
 #pragma mark -
 
 Common::Error ScummEngine::loadGameState(int slot) {
@@ -162,7 +179,7 @@ static bool saveSaveGameHeader(Common::OutSaveFile *out, SaveGameHeader &hdr) {
 	return true;
 }
 
-bool ScummEngine::saveState(Common::OutSaveFile *out, bool writeHeader) {
+void ScummEngine::saveStateHeader(Common::OutSaveFile *out, bool writeHeader) {
 	SaveGameHeader hdr;
 
 	if (writeHeader) {
@@ -173,16 +190,133 @@ bool ScummEngine::saveState(Common::OutSaveFile *out, bool writeHeader) {
 	Graphics::saveThumbnail(*out);
 #endif
 	saveInfos(out);
+}
+
+bool ScummEngine::saveState(Common::OutSaveFile *out, bool writeHeader) {
+	saveStateHeader(out, writeHeader);
+
+	// Since version 81 the state is either saved in full, or as a delta
+	out->writeUint32BE(MKID_BE('FULL'));
 
 	Serializer ser(0, out, CURRENT_VER);
 	saveOrLoad(&ser);
 	return true;
 }
 
+bool ScummEngine::saveDeltaState(Common::OutSaveFile *out, const Common::String &filename) {
+	Common::MemoryWriteStreamDynamic state;
+	Common::MemoryWriteStreamDynamic *delta = NULL;
+	bool isBase = false;
+
+	Serializer ser(0, &state, CURRENT_VER);
+	saveOrLoad(&ser);
+
+	byte *stateData = state.getData();
+	const uint32 stateSize = state.size();
+
+	// Small states are saved in full, for them a delta only costs the time
+	// to encode it, and the memory and the file for the base
+	if (stateSize < kMinDeltaStateSize) {
+		free(_deltaBase);
+		_deltaBase = NULL;
+		_deltaBaseSize = 0;
+		_deltaBaseFiles.clear();
+
+		saveStateHeader(out, true);
+		out->writeUint32BE(MKID_BE('FULL'));
+		out->write(stateData, stateSize);
+		free(stateData);
+		return true;
+	}
+
+	if (_deltaBase && _numDeltaSaves < kDeltaSavesPerSnapshot) {
+		delta = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+		Common::encodeDelta(_deltaBase, _deltaBaseSize, stateData, stateSize, *delta);
+
+		// Most of the state changed, start over with a new base
+		if (delta->size() > stateSize / 2) {
+			delete delta;
+			delta = NULL;
+		}
+	}
+
+	if (!delta) {
+		// This state is the base of the following delta saves. Its own
+		// delta is empty, the state is only written to the base file.
+		free(_deltaBase);
+		_deltaBase = stateData;
+		_deltaBaseSize = stateSize;
+		Common::MemoryReadStream base(_deltaBase, _deltaBaseSize);
+		Common::md5_file(base, _deltaBaseMD5);
+		_numDeltaSaves = 0;
+		_deltaBaseFiles.clear();
+		isBase = true;
+
+		delta = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+		Common::encodeDelta(_deltaBase, _deltaBaseSize, _deltaBase, _deltaBaseSize, *delta);
+	}
+
+	saveStateHeader(out, true);
+
+	// The base file is written once per savegame file and base, instead of
+	// a full save. Thus no save writes more than the state and its delta.
+	if (saveDeltaBase(filename)) {
+		out->writeUint32BE(MKID_BE('DLTA'));
+		out->write(_deltaBaseMD5, sizeof(_deltaBaseMD5));
+		out->write(delta->getData(), delta->size());
+		if (!isBase)
+			_numDeltaSaves++;
+
+		debug(1, "Saved %d bytes of state as a delta of %d bytes%s", stateSize, delta->size(), isBase ? ", as new delta base" : "");
+	} else {
+		out->writeUint32BE(MKID_BE('FULL'));
+		out->write(stateData, stateSize);
+	}
+
+	delete delta;
+	if (!isBase)
+		free(stateData);
+	return true;
+}
+
+bool ScummEngine::saveDeltaBase(const Common::String &filename) {
+	Common::OutSaveFile *out;
+	bool success;
+
+	// Check that the base file is still there, it is removed along with
+	// its savegame
+	for (uint i = 0; i < _deltaBaseFiles.size(); i++) {
+		if (_deltaBaseFiles[i] == filename) {
+			if (!_saveFileMan->listSavefiles(makeDeltaBaseName(filename)).empty())
+				return true;
+			_deltaBaseFiles.remove_at(i);
+			break;
+		}
+	}
+
+	if (!(out = _saveFileMan->openForSaving(makeDeltaBaseName(filename))))
+		return false;
+
+	out->writeUint32BE(MKID_BE('SCVB'));
+	out->writeUint32LE(CURRENT_VER);
+	out->write(_deltaBaseMD5, sizeof(_deltaBaseMD5));
+	out->writeUint32LE(_deltaBaseSize);
+	out->write(_deltaBase, _deltaBaseSize);
+
+	out->finalize();
+	success = !out->err();
+	delete out;
+
+	if (success)
+		_deltaBaseFiles.push_back(filename);
+	return success;
+}
+
 bool ScummEngine::saveState(int slot, bool compat) {
 	bool saveFailed;
 	Common::String filename;
 	Common::OutSaveFile *out;
+	const uint32 startTime = _system->getMillis();
 
 	if (_saveLoadSlot == 255) {
 		// Allow custom filenames for save game system in HE Games
@@ -194,8 +328,12 @@ bool ScummEngine::saveState(int slot, bool compat) {
 		return false;
 
 	saveFailed = false;
-	if (!saveState(out))
+	if (_deltaSaves && !compat) {
+		if (!saveDeltaState(out, filename))
+			saveFailed = true;
+	} else if (!saveState(out)) {
 		saveFailed = true;
+	}
 
 	out->finalize();
 	if (out->err())
@@ -206,7 +344,7 @@ bool ScummEngine::saveState(int slot, bool compat) {
 		debug(1, "State save as '%s' FAILED", filename.c_str());
 		return false;
 	}
-	debug(1, "State saved as '%s'", filename.c_str());
+	debug(1, "State saved as '%s' in %d ms", filename.c_str(), _system->getMillis() - startTime);
 	return true;
 }
 
@@ -303,9 +441,50 @@ static bool loadSaveGameHeader(Common::SeekableReadStream *in, SaveGameHeader &h
 	return !in->err() && hdr.type == MKID_BE('SCVM');
 }
 
+Common::SeekableReadStream *ScummEngine::loadDeltaState(Common::SeekableReadStream *in, const Common::String &filename, uint32 version) {
+	Common::InSaveFile *baseFile;
+	uint8 md5[16], baseMD5[16];
+	byte *base, *state;
+	uint32 baseSize, stateSize;
+
+	in->read(md5, sizeof(md5));
+
+	if (!(baseFile = _saveFileMan->openForLoading(makeDeltaBaseName(filename)))) {
+		warning("Base of delta savegame '%s' is missing", filename.c_str());
+		return 0;
+	}
+
+	if (baseFile->readUint32BE() != MKID_BE('SCVB') || baseFile->readUint32LE() != version ||
+			baseFile->read(baseMD5, sizeof(baseMD5)) != sizeof(baseMD5) || memcmp(md5, baseMD5, sizeof(md5))) {
+		warning("Base of delta savegame '%s' does not match", filename.c_str());
+		delete baseFile;
+		return 0;
+	}
+
+	baseSize = baseFile->readUint32LE();
+	base = (byte *)malloc(baseSize);
+	if (!base || baseFile->read(base, baseSize) != baseSize) {
+		warning("Base of delta savegame '%s' is truncated", filename.c_str());
+		free(base);
+		delete baseFile;
+		return 0;
+	}
+	delete baseFile;
+
+	state = Common::decodeDelta(base, baseSize, *in, stateSize);
+	free(base);
+
+	if (!state) {
+		warning("Invalid delta in savegame '%s'", filename.c_str());
+		return 0;
+	}
+	return new Common::MemoryReadStream(state, stateSize, DisposeAfterUse::YES);
+}
+
 bool ScummEngine::loadState(int slot, bool compat) {
 	Common::String filename;
 	Common::SeekableReadStream *in;
+	Common::SeekableReadStream *state;
 	int i, j;
 	SaveGameHeader hdr;
 	int sb, sh;
@@ -378,6 +557,23 @@ bool ScummEngine::loadState(int slot, bool compat) {
 		_engineStartTime = _system->getMillis() / 1000;
 	}
 
+	// Since version 81 the state is either saved in full, or as the delta
+	// to the state in a base file.
+	state = in;
+	if (hdr.ver >= VER(81)) {
+		uint32 tag = in->readUint32BE();
+		if (tag == MKID_BE('DLTA')) {
+			if (!(state = loadDeltaState(in, filename, hdr.ver))) {
+				delete in;
+				return false;
+			}
+		} else if (tag != MKID_BE('FULL')) {
+			warning("Invalid savegame '%s'", filename.c_str());
+			delete in;
+			return false;
+		}
+	}
+
 	// Due to a bug in scummvm up to and including 0.3.0, save games could be saved
 	// in the V8/V9 format but were tagged with a V7 mark. Ouch. So we just pretend V7 == V8 here
 	if (hdr.ver == VER(7))
@@ -435,10 +631,15 @@ bool ScummEngine::loadState(int slot, bool compat) {
 	//
 	// Now do the actual loading
 	//
-	Serializer ser(in, 0, hdr.ver);
+	Serializer ser(state, 0, hdr.ver);
 	saveOrLoad(&ser);
+	if (state != in)
+		delete state;
 	delete in;
 
+	// The box resources were replaced by the ones from the savegame
+	invalidateBoxCache();
+
 	// Update volume settings
 	syncSoundSettings();
 
@@ -624,7 +825,7 @@ bool ScummEngine::getSavegameName(int slot, Common::String &desc) {
 	return result;
 }
 
-bool getSavegameName(Common::InSaveFile *in, Common::String &desc, int heversion) {
+static bool readSavegameName(Common::SeekableReadStream *in, Common::String &desc, int heversion, uint32 &version) {
 	SaveGameHeader hdr;
 
 	if (!loadSaveGameHeader(in, hdr)) {
@@ -647,9 +848,30 @@ bool getSavegameName(Common::InSaveFile *in, Common::String &desc, int heversion
 
 	hdr.name[sizeof(hdr.name) - 1] = 0;
 	desc = hdr.name;
+	version = hdr.ver;
 	return true;
 }
 
+bool getSavegameName(Common::InSaveFile *in, Common::String &desc, int heversion) {
+	uint32 version;
+	return readSavegameName(in, desc, heversion, version);
+}
+
+bool ScummEngine::loadDescriptionAndInfos(Common::SeekableReadStream *in, Common::String &desc, InfoStuff *stuff) {
+	uint32 version;
+
+	memset(stuff, 0, sizeof(InfoStuff));
+
+	// FIXME: heversion?!?
+	if (!readSavegameName(in, desc, 0, version) || version < VER(56))
+		return false;
+
+	if (!Graphics::skipThumbnailHeader(*in))
+		return false;
+
+	return loadInfos(in, stuff);
+}
+
 Graphics::Surface *ScummEngine::loadThumbnailFromSlot(const char *target, int slot) {
 	Common::SeekableReadStream *in;
 	SaveGameHeader hdr;
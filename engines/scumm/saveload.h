@@ -50,7 +50,7 @@ namespace Scumm {
  * only saves/loads those which are valid for the version of the savegame
  * which is being loaded/saved currently.
  */
-#define CURRENT_VER 80
+#define CURRENT_VER 81
 
 /**
  * An auxillary macro, used to specify savegame versions. We use this instead
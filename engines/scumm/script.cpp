@@ -29,6 +29,7 @@
 
 #include "scumm/actor.h"
 #include "scumm/object.h"
+#include "scumm/profiler.h"
 #include "scumm/resource.h"
 #include "scumm/util.h"
 #include "scumm/scumm_v2.h"
@@ -450,6 +451,10 @@ void ScummEngine::getScriptEntryPoint() {
 /** Execute a script - Read opcode, and execute it from the table */
 void ScummEngine::executeScript() {
 	int c;
+
+	if (_scriptProfiler && _currentScript != 0xFF)
+		_scriptProfiler->beginSlice(vm.slot[_currentScript].where, vm.slot[_currentScript].number);
+
 	while (_currentScript != 0xFF) {
 
 		if (_showStack == 1) {
@@ -474,7 +479,20 @@ void ScummEngine::executeScript() {
 			printf("\n");
 		}
 
-		executeOpcode(_opcode);
+		if (_scriptProfiler) {
+			// The opcode may stop the script or run nested ones, both of
+			// which change _currentScript, so take note of it beforehand.
+			const ScriptSlot &slot = vm.slot[_currentScript];
+			const int where = slot.where, number = slot.number;
+			const byte opcode = _opcode;
+			ScriptProfiler::Sample sample;
+
+			_scriptProfiler->beginOpcode(sample);
+			executeOpcode(opcode);
+			_scriptProfiler->endOpcode(sample, opcode, where, number);
+		} else {
+			executeOpcode(_opcode);
+		}
 
 	}
 }
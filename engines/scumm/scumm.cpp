@@ -35,6 +35,7 @@
 #include "graphics/cursorman.h"
 
 #include "scumm/akos.h"
+#include "scumm/boxes.h"
 #include "scumm/charset.h"
 #include "scumm/costume.h"
 #include "scumm/debugger.h"
@@ -59,6 +60,7 @@
 #include "scumm/player_v2a.h"
 #include "scumm/player_v3a.h"
 #include "scumm/player_v4a.h"
+#include "scumm/profiler.h"
 #include "scumm/he/resource_he.h"
 #include "scumm/scumm_v0.h"
 #include "scumm/scumm_v8.h"
@@ -124,6 +126,7 @@ ScummEngine::ScummEngine(OSystem *syst, const DetectorResult &dr)
 		_gdi = new Gdi(this);
 	}
 	_res = new ResourceManager(this);
+	_boxCache = new BoxCache();
 
 	// Convert MD5 checksum back into a digest
 	for (int i = 0; i < 16; ++i) {
@@ -304,6 +307,7 @@ ScummEngine::ScummEngine(OSystem *syst, const DetectorResult &dr)
 	_keepText = false;
 	_costumeLoader = NULL;
 	_costumeRenderer = NULL;
+	_scriptProfiler = NULL;
 	_2byteFontPtr = 0;
 	_V1TalkingActor = 0;
 	_NESStartStrip = 0;
@@ -463,6 +467,12 @@ ScummEngine::ScummEngine(OSystem *syst, const DetectorResult &dr)
 		_debugMode = true;
 
 	_copyProtection = ConfMan.getBool("copy_protection");
+
+	ConfMan.registerDefault("delta_saves", false);
+	_deltaSaves = ConfMan.getBool("delta_saves");
+	_deltaBase = NULL;
+	_deltaBaseSize = 0;
+	_numDeltaSaves = 0;
 	if (ConfMan.getBool("demo_mode"))
 		_game.features |= GF_DEMO;
 	if (ConfMan.hasKey("nosubtitles")) {
@@ -598,12 +608,21 @@ ScummEngine::~ScummEngine() {
 	free(_classData);
 	free(_arraySlot);
 
+	free(_deltaBase);
+
 	free(_compositeBuf);
 	free(_herculesBuf);
 	free(_fmtownsBuf);
 
 	delete _debugger;
 
+	if (_scriptProfiler) {
+		if (!_scriptProfiler->getDumpFile().empty())
+			_scriptProfiler->dump(this, _scriptProfiler->getDumpFile().c_str());
+		delete _scriptProfiler;
+	}
+
+	delete _boxCache;
 	delete _res;
 	delete _gdi;
 }
@@ -1118,6 +1137,12 @@ Common::Error ScummEngine::init() {
 	// Create the debugger now that _numVariables has been set
 	_debugger = new ScummDebugger(this);
 
+	// Profile the scripts from the start, and write the result on exit
+	if (ConfMan.hasKey("script_profile")) {
+		_scriptProfiler = new ScriptProfiler();
+		_scriptProfiler->setDumpFile(ConfMan.get("script_profile"));
+	}
+
 	resetScumm();
 	resetScummVars();
 
@@ -71,11 +71,15 @@ class IMuseDigital;
 class MusicEngine;
 class ScummEngine;
 class ScummDebugger;
+class ScriptProfiler;
 class Serializer;
 class Sound;
 
 struct Box;
+struct BoxCache;
 struct BoxCoords;
+struct BoxEdge;
+struct BoxInfo;
 struct FindObjectInRoom;
 
 // Use g_scumm from error() ONLY
@@ -377,6 +381,24 @@ protected:
 	uint32 _maxHeapThreshold, _minHeapThreshold;
 	byte _expireCounter;
 
+	enum {
+		kNumAgeBuckets = 128
+	};
+
+	/**
+	 * All loaded resources of the types which can be expired are kept in
+	 * doubly linked lists, one for each value of their usage counter, so
+	 * that expireResources() doesn't have to search all resources for the
+	 * least recently used ones. The links encode type and index of the
+	 * neighbouring resource, with 0 marking the end of a list.
+	 */
+	uint32 *_ageNext[rtNumTypes];
+	uint32 *_agePrev[rtNumTypes];
+	uint32 _ageBucket[kNumAgeBuckets];
+
+	uint32 _numHits, _numMisses;
+	uint32 _numExpired, _expiredSize;
+
 public:
 	ResourceManager(ScummEngine *vm);
 	~ResourceManager();
@@ -402,12 +424,17 @@ public:
 	void setResourceCounter(int type, int index, byte flag);
 	void increaseResourceCounter();
 
+	void countResourceAccess(bool loaded) { if (loaded) _numHits++; else _numMisses++; }
 	void resourceStats();
 
 //protected:
 	bool validateResource(const char *str, int type, int index) const;
 protected:
 	void expireResources(uint32 size);
+
+	void linkAgeBucket(int type, int index);
+	void unlinkAgeBucket(int type, int index);
+	int getReloadCost(int type, int index);
 };
 
 /**
@@ -415,6 +442,7 @@ protected:
  */
 class ScummEngine : public Engine {
 	friend class ScummDebugger;
+	friend class ScriptProfiler;
 	friend class CharsetRenderer;
 	friend class ResourceManager;
 
@@ -645,9 +673,26 @@ protected:
 	char _saveLoadFileName[32];
 	char _saveLoadName[32];
 
+	/**
+	 * Delta saves: the state of the last snapshot is kept here, later
+	 * saves only store the difference to it. _deltaBaseFiles lists the
+	 * savefiles whose base file holds that state. Only used for states of
+	 * at least kMinDeltaStateSize bytes.
+	 */
+	bool _deltaSaves;
+	byte *_deltaBase;
+	uint32 _deltaBaseSize;
+	uint8 _deltaBaseMD5[16];
+	int _numDeltaSaves;
+	Common::StringList _deltaBaseFiles;
+
+	void saveStateHeader(Common::OutSaveFile *out, bool writeHeader);
 	bool saveState(Common::OutSaveFile *out, bool writeHeader = true);
 	bool saveState(int slot, bool compat);
+	bool saveDeltaState(Common::OutSaveFile *out, const Common::String &filename);
+	bool saveDeltaBase(const Common::String &filename);
 	bool loadState(int slot, bool compat);
+	Common::SeekableReadStream *loadDeltaState(Common::SeekableReadStream *in, const Common::String &filename, uint32 version);
 	virtual void saveOrLoad(Serializer *s);
 	void saveLoadResource(Serializer *ser, int type, int index);	// "Obsolete"
 	void saveResource(Serializer *ser, int type, int index);
@@ -662,6 +707,11 @@ protected:
 public:
 	static Common::String makeSavegameName(const Common::String &target, int slot, bool temporary);
 
+	/** The name of the file holding the base state of a delta save. */
+	static Common::String makeDeltaBaseName(const Common::String &filename) {
+		return filename + ".base";
+	}
+
 	bool getSavegameName(int slot, Common::String &desc);
 	void listSavegames(bool *marks, int num);
 
@@ -677,6 +727,14 @@ public:
 
 	static bool loadInfosFromSlot(const char *target, int slot, InfoStuff *stuff);
 
+	/**
+	 * Read the description and, if present, the info section of a
+	 * savegame from the start of the given stream. The description is set
+	 * to an error message for invalid savegames.
+	 * @return true if the info section was read
+	 */
+	static bool loadDescriptionAndInfos(Common::SeekableReadStream *in, Common::String &desc, InfoStuff *stuff);
+
 protected:
 	void saveInfos(Common::WriteStream* file);
 	static bool loadInfos(Common::SeekableReadStream *file, InfoStuff *stuff);
@@ -695,6 +753,9 @@ protected:
 
 	OpcodeEntry _opcodes[256];
 
+	/** Script profiler, only allocated while profiling is enabled. */
+	ScriptProfiler *_scriptProfiler;
+
 	virtual void setupOpcodes() = 0;
 	void executeOpcode(byte i);
 	const char *getOpcodeDesc(byte i);
@@ -1171,6 +1232,7 @@ public:
 	bool checkXYInBoxBounds(int box, int x, int y);
 
 	BoxCoords getBoxCoordinates(int boxnum);
+	BoxEdge getBoxEdge(byte box1nr, byte box2nr);
 
 	byte getMaskFromBox(int box);
 	Box *getBoxBaseAddr(int box);
@@ -1180,7 +1242,18 @@ public:
 	int getScale(int box, int x, int y);
 	int getScaleFromSlot(int slot, int x, int y);
 
+	void invalidateBoxCache();
+
 protected:
+	BoxCache *_boxCache;
+
+	int adjustBoxNum(int box, int numOfBoxes);
+	Box *getBoxBaseAddr(byte *ptr, int box);
+	void decodeBox(const Box *bp, BoxInfo &info);
+	void buildBoxCache();
+	const BoxInfo *getBoxInfo(int box);
+	int calcNextBox(byte from, byte to);
+
 	// Scaling slots/items
 	struct ScaleSlot {
 		int x1, y1, scale1;
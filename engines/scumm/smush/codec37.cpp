@@ -29,9 +29,26 @@
 #include "scumm/bomp.h"
 #include "scumm/smush/codec37.h"
 
+#if defined(__SSE2__) && !defined(SCUMM_NEED_ALIGNMENT)
+#define SCUMM_CODEC37_SSE2
+#include <emmintrin.h>
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON)) && !defined(SCUMM_NEED_ALIGNMENT)
+#define SCUMM_CODEC37_NEON
+#include <arm_neon.h>
+#endif
+
 namespace Scumm {
 
+bool Codec37Decoder::hasSimd() {
+#if defined(SCUMM_CODEC37_SSE2) || defined(SCUMM_CODEC37_NEON)
+	return true;
+#else
+	return false;
+#endif
+}
+
 Codec37Decoder::Codec37Decoder(int width, int height) {
+	_simd = true;
 	_width = width;
 	_height = height;
 	_frameSize = _width * _height;
@@ -327,6 +344,32 @@ void Codec37Decoder::maketable(int pitch, int index) {
 		dst += 4;						  \
 	} while (0)
 
+/*
+ * Copy a run of 4x4 pixel blocks in one block row from the same place in the
+ * other buffer. With simd set, the lines are copied 16 pixels at a time with
+ * the SIMD instructions of the platform, if there are any.
+ */
+
+static inline void copyRun4x4(byte *dst, const byte *src, int32 blocks, int pitch, bool simd) {
+	const int32 len = blocks * 4;
+	for (int y = 0; y < 4; y++, dst += pitch, src += pitch) {
+		int32 x = 0;
+#if defined(SCUMM_CODEC37_SSE2)
+		if (simd) {
+			for (; x + 16 <= len; x += 16)
+				_mm_storeu_si128((__m128i *)(dst + x), _mm_loadu_si128((const __m128i *)(src + x)));
+		}
+#elif defined(SCUMM_CODEC37_NEON)
+		if (simd) {
+			for (; x + 16 <= len; x += 16)
+				vst1q_u8(dst + x, vld1q_u8(src + x));
+		}
+#endif
+		for (; x < len; x += 4)
+			COPY_4X1_LINE(dst + x, src + x);
+	}
+}
+
 void Codec37Decoder::proc1(byte *dst, const byte *src, int32 next_offs, int bw, int bh, int pitch, int16 *offset_table) {
 	uint8 code;
 	bool filling, skipCode;
@@ -441,10 +484,12 @@ void Codec37Decoder::proc4WithFDFE(byte *dst, const byte *src, int32 next_offs,
 				LITERAL_1X1(src, dst, pitch);
 			} else if (code == 0x00) {
 				int32 length = *src++ + 1;
-				for (int32 l = 0; l < length; l++) {
-					byte *dst2 = dst + next_offs;
-					COPY_4X4(dst2, dst, pitch);
-					i--;
+				while (length > 0) {
+					int32 blocks = MIN(length, i);
+					copyRun4x4(dst, dst + next_offs, blocks, pitch, _simd);
+					dst += blocks * 4;
+					length -= blocks;
+					i -= blocks;
 					if (i == 0) {
 						dst += pitch * 3;
 						bh--;
@@ -473,10 +518,12 @@ void Codec37Decoder::proc4WithoutFDFE(byte *dst, const byte *src, int32 next_off
 				LITERAL_1X1(src, dst, pitch);
 			} else if (code == 0x00) {
 				int32 length = *src++ + 1;
-				for (int32 l = 0; l < length; l++) {
-					byte *dst2 = dst + next_offs;
-					COPY_4X4(dst2, dst, pitch);
-					i--;
+				while (length > 0) {
+					int32 blocks = MIN(length, i);
+					copyRun4x4(dst, dst + next_offs, blocks, pitch, _simd);
+					dst += blocks * 4;
+					length -= blocks;
+					i -= blocks;
 					if (i == 0) {
 						dst += pitch * 3;
 						bh--;
@@ -43,10 +43,24 @@ private:
 	int _tableLastIndex;
 	int32 _frameSize;
 	int _width, _height;
+	bool _simd;
 
 public:
 	Codec37Decoder(int width, int height);
 	~Codec37Decoder();
+
+	/**
+	 * Whether runs of copied 4x4 blocks can be copied with SIMD instructions
+	 * on this platform, i.e. with SSE2 or NEON.
+	 */
+	static bool hasSimd();
+
+	/**
+	 * Use the SIMD instructions (the default), or the word copies which are
+	 * used on other platforms. Only meant for checking that both decode the
+	 * same.
+	 */
+	void setSimdEnabled(bool enable) { _simd = enable; }
 protected:
 	void maketable(int, int);
 	void proc1(byte *dst, const byte *src, int32, int, int, int, int16 *);
@@ -29,6 +29,14 @@
 #include "scumm/bomp.h"
 #include "scumm/smush/codec47.h"
 
+#if defined(__SSE2__) && !defined(SCUMM_NEED_ALIGNMENT) && !defined(USE_ARM_SMUSH_ASM)
+#define SCUMM_CODEC47_SSE2
+#include <emmintrin.h>
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON)) && !defined(SCUMM_NEED_ALIGNMENT) && !defined(USE_ARM_SMUSH_ASM)
+#define SCUMM_CODEC47_NEON
+#include <arm_neon.h>
+#endif
+
 namespace Scumm {
 
 #if defined(SCUMM_NEED_ALIGNMENT)
@@ -47,6 +55,19 @@ namespace Scumm {
 		(dst)[1] = (src)[1];	\
 	} while (0)
 
+#define DECLARE_FILL_4X1_TEMP(v)		\
+	byte v
+
+#define MAKE_FILL_4X1_TEMP(v, val)		\
+	v = val
+
+#define FILL_4X1_LINE(dst, v)			\
+	do {					\
+		(dst)[0] = v;	\
+		(dst)[1] = v;	\
+		(dst)[2] = v;	\
+		(dst)[3] = v;	\
+	} while (0)
 
 #else /* SCUMM_NEED_ALIGNMENT */
 
@@ -56,15 +77,48 @@ namespace Scumm {
 #define COPY_2X1_LINE(dst, src)			\
 	*(uint16 *)(dst) = *(const uint16 *)(src)
 
-#endif
+#define DECLARE_FILL_4X1_TEMP(v)		\
+	uint32 v
 
-#define FILL_4X1_LINE(dst, val)			\
-	do {					\
-		(dst)[0] = val;	\
-		(dst)[1] = val;	\
-		(dst)[2] = val;	\
-		(dst)[3] = val;	\
-	} while (0)
+#define MAKE_FILL_4X1_TEMP(v, val)		\
+	v = (val) * 0x01010101
+
+#define FILL_4X1_LINE(dst, v)			\
+	*(uint32 *)(dst) = v
+
+#endif /* SCUMM_NEED_ALIGNMENT */
+
+/* Lines of the 8x8 blocks are copied or filled in one go if possible */
+
+#if defined(SCUMM_CODEC47_SSE2)
+
+#define COPY_8X1_LINE(dst, src)			\
+	_mm_storel_epi64((__m128i *)(dst), _mm_loadl_epi64((const __m128i *)(src)))
+
+#define DECLARE_FILL_8X1_TEMP(v)		\
+	__m128i v
+
+#define MAKE_FILL_8X1_TEMP(v, val)		\
+	v = _mm_set1_epi8((char)(val))
+
+#define FILL_8X1_LINE(dst, v)			\
+	_mm_storel_epi64((__m128i *)(dst), v)
+
+#elif defined(SCUMM_CODEC47_NEON)
+
+#define COPY_8X1_LINE(dst, src)			\
+	vst1_u8((dst), vld1_u8(src))
+
+#define DECLARE_FILL_8X1_TEMP(v)		\
+	uint8x8_t v
+
+#define MAKE_FILL_8X1_TEMP(v, val)		\
+	v = vdup_n_u8(val)
+
+#define FILL_8X1_LINE(dst, v)			\
+	vst1_u8((dst), v)
+
+#endif
 
 #define FILL_2X1_LINE(dst, val)			\
 	do {					\
@@ -72,6 +126,46 @@ namespace Scumm {
 		(dst)[1] = val;	\
 	} while (0)
 
+/*
+ * With simd set, the 8x8 blocks are copied and filled with the SIMD
+ * instructions of the platform, if there are any. Otherwise the word copies
+ * and fills are used, which must give the same result.
+ */
+
+template<bool simd>
+static inline void copyBlock8x8(byte *dst, int32 offset, int pitch) {
+#if defined(COPY_8X1_LINE)
+	if (simd) {
+		for (int i = 0; i < 8; i++, dst += pitch)
+			COPY_8X1_LINE(dst, dst + offset);
+		return;
+	}
+#endif
+	for (int i = 0; i < 8; i++, dst += pitch) {
+		COPY_4X1_LINE(dst + 0, dst + offset + 0);
+		COPY_4X1_LINE(dst + 4, dst + offset + 4);
+	}
+}
+
+template<bool simd>
+static inline void fillBlock8x8(byte *dst, byte val, int pitch) {
+#if defined(FILL_8X1_LINE)
+	if (simd) {
+		DECLARE_FILL_8X1_TEMP(t);
+		MAKE_FILL_8X1_TEMP(t, val);
+		for (int i = 0; i < 8; i++, dst += pitch)
+			FILL_8X1_LINE(dst, t);
+		return;
+	}
+#endif
+	DECLARE_FILL_4X1_TEMP(t);
+	MAKE_FILL_4X1_TEMP(t, val);
+	for (int i = 0; i < 8; i++, dst += pitch) {
+		FILL_4X1_LINE(dst + 0, t);
+		FILL_4X1_LINE(dst + 4, t);
+	}
+}
+
 static const  int8 codec47_table_small1[] = {
   0, 1, 2, 3, 3, 3, 3, 2, 1, 0, 0, 0, 1, 2, 2, 1,
 };
@@ -393,6 +487,7 @@ void Codec47Decoder::level2(byte *d_dst) {
 	int32 tmp;
 	byte code = *_d_src++;
 	int i;
+	DECLARE_FILL_4X1_TEMP(t);
 
 	if (code < 0xF8) {
 		tmp = _table[code] + _offset1;
@@ -409,7 +504,7 @@ void Codec47Decoder::level2(byte *d_dst) {
 		d_dst += 2;
 		level3(d_dst);
 	} else if (code == 0xFE) {
-		byte t = *_d_src++;
+		MAKE_FILL_4X1_TEMP(t, *_d_src++);
 		for (i = 0; i < 4; i++) {
 			FILL_4X1_LINE(d_dst, t);
 			d_dst += _d_pitch;
@@ -437,7 +532,7 @@ void Codec47Decoder::level2(byte *d_dst) {
 			d_dst += _d_pitch;
 		}
 	} else {
-		byte t = _paramPtr[code];
+		MAKE_FILL_4X1_TEMP(t, _paramPtr[code]);
 		for (i = 0; i < 4; i++) {
 			FILL_4X1_LINE(d_dst, t);
 			d_dst += _d_pitch;
@@ -445,18 +540,13 @@ void Codec47Decoder::level2(byte *d_dst) {
 	}
 }
 
+template<bool simd>
 void Codec47Decoder::level1(byte *d_dst) {
-	int32 tmp, tmp2;
+	int32 tmp;
 	byte code = *_d_src++;
-	int i;
 
 	if (code < 0xF8) {
-		tmp2 = _table[code] + _offset1;
-		for (i = 0; i < 8; i++) {
-			COPY_4X1_LINE(d_dst + 0, d_dst + tmp2);
-			COPY_4X1_LINE(d_dst + 4, d_dst + tmp2 + 4);
-			d_dst += _d_pitch;
-		}
+		copyBlock8x8<simd>(d_dst, _table[code] + _offset1, _d_pitch);
 	} else if (code == 0xFF) {
 		level2(d_dst);
 		d_dst += 4;
@@ -466,12 +556,7 @@ void Codec47Decoder::level1(byte *d_dst) {
 		d_dst += 4;
 		level2(d_dst);
 	} else if (code == 0xFE) {
-		byte t = *_d_src++;
-		for (i = 0; i < 8; i++) {
-			FILL_4X1_LINE(d_dst, t);
-			FILL_4X1_LINE(d_dst + 4, t);
-			d_dst += _d_pitch;
-		}
+		fillBlock8x8<simd>(d_dst, *_d_src++, _d_pitch);
 	} else if (code == 0xFD) {
 		tmp = *_d_src++;
 		byte *tmp_ptr = _tableBig + tmp * 388;
@@ -490,42 +575,50 @@ void Codec47Decoder::level1(byte *d_dst) {
 			tmp_ptr2++;
 		}
 	} else if (code == 0xFC) {
-		tmp2 = _offset2;
-		for (i = 0; i < 8; i++) {
-			COPY_4X1_LINE(d_dst + 0, d_dst + tmp2);
-			COPY_4X1_LINE(d_dst + 4, d_dst + tmp2 + 4);
-			d_dst += _d_pitch;
-		}
+		copyBlock8x8<simd>(d_dst, _offset2, _d_pitch);
 	} else {
-		byte t = _paramPtr[code];
-		for (i = 0; i < 8; i++) {
-			FILL_4X1_LINE(d_dst, t);
-			FILL_4X1_LINE(d_dst + 4, t);
-			d_dst += _d_pitch;
-		}
+		fillBlock8x8<simd>(d_dst, _paramPtr[code], _d_pitch);
 	}
 }
 
-void Codec47Decoder::decode2(byte *dst, const byte *src, int width, int height, const byte *param_ptr) {
-	_d_src = src;
-	_paramPtr = param_ptr - 0xf8;
+template<bool simd>
+void Codec47Decoder::decodeBlocks(byte *dst, int width, int height) {
 	int bw = (width + 7) / 8;
 	int bh = (height + 7) / 8;
 	int next_line = width * 7;
-	_d_pitch = width;
 
 	do {
 		int tmp_bw = bw;
 		do {
-			level1(dst);
+			level1<simd>(dst);
 			dst += 8;
 		} while (--tmp_bw);
 		dst += next_line;
 	} while (--bh);
 }
+
+void Codec47Decoder::decode2(byte *dst, const byte *src, int width, int height, const byte *param_ptr) {
+	_d_src = src;
+	_paramPtr = param_ptr - 0xf8;
+	_d_pitch = width;
+
+	if (_simd)
+		decodeBlocks<true>(dst, width, height);
+	else
+		decodeBlocks<false>(dst, width, height);
+}
 #endif
 
+bool Codec47Decoder::hasSimd() {
+#if defined(SCUMM_CODEC47_SSE2) || defined(SCUMM_CODEC47_NEON)
+	return true;
+#else
+	return false;
+#endif
+}
+
 Codec47Decoder::Codec47Decoder(int width, int height) {
+	_simd = true;
 	_lastTableWidth = -1;
 	_width = width;
 	_height = height;
@@ -47,18 +47,33 @@ private:
 	int16 _table[256];
 	int32 _frameSize;
 	int _width, _height;
+	bool _simd;
 
 	void makeTablesInterpolation(int param);
 	void makeTables47(int width);
-	void level1(byte *d_dst);
+	template<bool simd> void level1(byte *d_dst);
 	void level2(byte *d_dst);
 	void level3(byte *d_dst);
+	template<bool simd> void decodeBlocks(byte *dst, int width, int height);
 	void decode2(byte *dst, const byte *src, int width, int height, const byte *param_ptr);
 
 public:
 	Codec47Decoder(int width, int height);
 	~Codec47Decoder();
 	bool decode(byte *dst, const byte *src);
+
+	/**
+	 * Whether 8x8 blocks can be copied and filled with SIMD instructions on
+	 * this platform, i.e. with SSE2 or NEON.
+	 */
+	static bool hasSimd();
+
+	/**
+	 * Use the SIMD instructions (the default), or the word copies and fills
+	 * which are used on other platforms. Only meant for checking that both
+	 * decode the same.
+	 */
+	void setSimdEnabled(bool enable) { _simd = enable; }
 };
 
 } // End of namespace Scumm
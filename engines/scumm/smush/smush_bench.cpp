@@ -0,0 +1,231 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#include "common/endian.h"
+#include "common/fs.h"
+#include "common/stream.h"
+#include "common/util.h"
+#include "common/zlib.h"
+
+#include "graphics/video/video_benchmark.h"
+
+#include "scumm/smush/codec37.h"
+#include "scumm/smush/codec47.h"
+#include "scumm/smush/smush_bench.h"
+
+namespace Scumm {
+
+void smush_decode_codec1(byte *dst, const byte *src, int left, int top, int width, int height, int pitch);
+
+/**
+ * Decodes the frame objects of a SMUSH video, which has been read into
+ * memory, the way SmushPlayer does.
+ */
+class SmushBenchDecoder {
+public:
+	SmushBenchDecoder(const byte *data, uint32 size, bool simd);
+	~SmushBenchDecoder();
+
+	/**
+	 * Decode all frames and add them to the benchmark.
+	 * @return false if the video has no frames of a known codec
+	 */
+	bool run(Graphics::VideoBenchmark &bench);
+
+	int getWidth() const { return _width; }
+	int getHeight() const { return _height; }
+
+private:
+	void decodeFrame(const byte *src, int32 frameSize);
+	void decodeFrameObject(const byte *src, int32 size);
+
+	const byte *_data;
+	uint32 _size;
+	bool _simd;
+
+	byte *_frame;
+	int _width, _height;
+	Codec37Decoder *_codec37;
+	Codec47Decoder *_codec47;
+};
+
+SmushBenchDecoder::SmushBenchDecoder(const byte *data, uint32 size, bool simd)
+	: _data(data), _size(size), _simd(simd), _frame(0), _width(0), _height(0), _codec37(0), _codec47(0) {
+}
+
+SmushBenchDecoder::~SmushBenchDecoder() {
+	delete _codec37;
+	delete _codec47;
+	free(_frame);
+}
+
+bool SmushBenchDecoder::run(Graphics::VideoBenchmark &bench) {
+	if (_size < 8 || READ_BE_UINT32(_data) != MKID_BE('ANIM'))
+		return false;
+
+	const uint32 end = MIN<uint32>(_size, 8 + READ_BE_UINT32(_data + 4));
+
+	bench.start();
+	for (uint32 pos = 8; pos + 8 <= end; ) {
+		const uint32 type = READ_BE_UINT32(_data + pos);
+		// Truncated chunks at the end of the file are cut off
+		const uint32 size = MIN<uint32>(READ_BE_UINT32(_data + pos + 4), end - pos - 8);
+
+		if (type == MKID_BE('FRME')) {
+			decodeFrame(_data + pos + 8, size);
+			if (_frame)
+				bench.addFrame(_frame, _width, _width, _height);
+		}
+
+		pos += 8 + size;
+	}
+	bench.stop();
+
+	return bench.getFrames() > 0;
+}
+
+void SmushBenchDecoder::decodeFrame(const byte *src, int32 frameSize) {
+	int32 subSize;
+
+	for (int32 pos = 0; pos + 8 <= frameSize; pos += 8 + subSize + (subSize & 1)) {
+		const uint32 subType = READ_BE_UINT32(src + pos);
+		subSize = READ_BE_UINT32(src + pos + 4);
+		if (subSize < 0 || subSize > frameSize - pos - 8)
+			return;
+
+		if (subType == MKID_BE('FOBJ')) {
+			decodeFrameObject(src + pos + 8, subSize);
+#ifdef USE_ZLIB
+		} else if (subType == MKID_BE('ZFOB') && subSize >= 4) {
+			unsigned long decompressedSize = READ_BE_UINT32(src + pos + 8);
+			byte *fobj = (byte *)malloc(decompressedSize);
+			if (fobj && Common::uncompress(fobj, &decompressedSize, src + pos + 12, subSize - 4))
+				decodeFrameObject(fobj, decompressedSize);
+			free(fobj);
+#endif
+		}
+	}
+}
+
+void SmushBenchDecoder::decodeFrameObject(const byte *src, int32 size) {
+	if (size < 14)
+		return;
+
+	const int codec = READ_LE_UINT16(src + 0);
+	const int left = READ_LE_UINT16(src + 2);
+	const int top = READ_LE_UINT16(src + 4);
+	const int width = READ_LE_UINT16(src + 6);
+	const int height = READ_LE_UINT16(src + 8);
+
+	// The first frame object determines the size of the video. Smaller ones
+	// are overlays, which are skipped by SmushPlayer as well.
+	if (!_frame) {
+		if (width <= 0 || height <= 0)
+			return;
+		_width = width;
+		_height = height;
+		_frame = (byte *)calloc(_width * _height, 1);
+		assert(_frame);
+	}
+
+	if (left != 0 || top != 0 || width != _width || height != _height)
+		return;
+
+	switch (codec) {
+	case 1:
+	case 3:
+		smush_decode_codec1(_frame, src + 14, 0, 0, width, height, _width);
+		break;
+	case 37:
+		if (!_codec37) {
+			_codec37 = new Codec37Decoder(width, height);
+			_codec37->setSimdEnabled(_simd);
+		}
+		_codec37->decode(_frame, src + 14);
+		break;
+	case 47:
+		if (!_codec47) {
+			_codec47 = new Codec47Decoder(width, height);
+			_codec47->setSimdEnabled(_simd);
+		}
+		_codec47->decode(_frame, src + 14);
+		break;
+	default:
+		warning("SmushBenchDecoder: Unknown codec %d", codec);
+		break;
+	}
+}
+
+Common::Error benchSmushVideo(const Common::FSNode &node) {
+	Common::String name = node.getName();
+	name.toLowercase();
+	if (!name.hasSuffix(".san") && !name.hasSuffix(".snm"))
+		return Common::kUnsupportedGameidError;
+
+	Common::SeekableReadStream *stream = node.createReadStream();
+	if (!stream)
+		return Common::kReadingFailed;
+
+	// Reading the file is not part of the decoding
+	const uint32 size = stream->size();
+	byte *data = (byte *)malloc(size);
+	assert(data);
+	const bool ok = (stream->read(data, size) == size);
+	delete stream;
+
+	if (!ok) {
+		free(data);
+		return Common::kReadingFailed;
+	}
+
+	const Common::String fileName = node.getPath();
+	Common::Error result = Common::kNoError;
+	uint32 simdCRC = 0;
+
+	for (int pass = 0; pass < ((Codec37Decoder::hasSimd() || Codec47Decoder::hasSimd()) ? 2 : 1); pass++) {
+		const bool simd = (pass == 0);
+
+		Graphics::VideoBenchmark bench(simd ? fileName : fileName + " (no SIMD)");
+		SmushBenchDecoder decoder(data, size, simd);
+		if (!decoder.run(bench)) {
+			result = Common::kReadingFailed;
+			break;
+		}
+
+		bench.printResult(decoder.getWidth(), decoder.getHeight());
+
+		if (simd) {
+			simdCRC = bench.getCRC();
+		} else if (bench.getCRC() != simdCRC) {
+			printf("%s: Decoding with and without SIMD instructions gives different frames\n", fileName.c_str());
+			result = Common::kUnknownError;
+		}
+	}
+
+	free(data);
+	return result;
+}
+
+} // End of namespace Scumm
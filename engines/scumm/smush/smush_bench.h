@@ -0,0 +1,52 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#ifndef SCUMM_SMUSH_BENCH_H
+#define SCUMM_SMUSH_BENCH_H
+
+#include "common/error.h"
+
+namespace Common {
+	class FSNode;
+}
+
+namespace Scumm {
+
+/**
+ * Decode all video frames of a SMUSH video (.san or .snm) for the
+ * --bench-video command line option, without sound or the INSANE overlays.
+ *
+ * If codec47 uses SIMD instructions on this platform, the video is decoded
+ * a second time without them, and the CRCs of both runs are compared. Any
+ * difference is reported as an error; the CRC of every frame can be shown
+ * with debug level 1 to find the first frame that differs.
+ *
+ * @return kUnsupportedGameidError if the file is no SMUSH video
+ */
+Common::Error benchSmushVideo(const Common::FSNode &node);
+
+} // End of namespace Scumm
+
+#endif
@@ -27,7 +27,9 @@
 
 #include "common/config-manager.h"
 #include "common/file.h"
+#include "common/md5.h"
 #include "common/system.h"
+#include "common/timer.h"
 #include "common/util.h"
 
 #include "graphics/cursorman.h"
@@ -243,6 +245,17 @@ SmushPlayer::SmushPlayer(ScummEngine_v7 *scumm) {
 	_paused = false;
 	_pauseStartTime = 0;
 	_pauseTime = 0;
+
+	_numQueuedChunks = 0;
+	_prefetchEnd = false;
+	_prefetchTimer = false;
+	_inflateBuffer = NULL;
+	_inflateCapacity = 0;
+
+	_chunksPrefetched = 0;
+	_chunksRead = 0;
+	_maxQueuedChunks = 0;
+	_framesDropped = 0;
 }
 
 SmushPlayer::~SmushPlayer() {
@@ -281,6 +294,14 @@ void SmushPlayer::init(int32 speed) {
 void SmushPlayer::release() {
 	_vm->_smushVideoShouldFinish = true;
 
+	// Note: The timer must not be removed while holding _prefetchMutex,
+	// since the timer manager holds its own lock while invoking the proc.
+	if (_prefetchTimer) {
+		_vm->_system->getTimerManager()->removeTimerProc(&prefetchTimerProc);
+		_prefetchTimer = false;
+	}
+	freePrefetchedChunks();
+
 	for (int i = 0; i < 5; i++) {
 		delete _sf[i];
 		_sf[i] = NULL;
@@ -766,6 +787,15 @@ void SmushPlayer::decodeFrameObject(int codec, const uint8 *src, int left, int t
 		error("Invalid codec for frame object : %d", codec);
 	}
 
+	// Log checksums of the decoded frames, so that the output of the
+	// codecs can be compared between builds and platforms
+	if (gDebugLevel >= 5 && Common::isDebugChannelEnabled(DEBUG_SMUSH)) {
+		char md5str[32 + 1];
+		Common::MemoryReadStream frameStream(_dst, _width * _height);
+		Common::md5_file_string(frameStream, md5str);
+		debugC(DEBUG_SMUSH, "SmushPlayer::decodeFrameObject(%d) codec %d checksum %s", _frame, codec, md5str);
+	}
+
 	if (_storeFrame) {
 		if (_frameBuffer == NULL) {
 			_frameBuffer = (byte *)malloc(_width * _height);
@@ -968,19 +998,237 @@ SmushFont *SmushPlayer::getFont(int font) {
 	return _sf[font];
 }
 
+#pragma mark -
+#pragma mark --- Prefetching ---
+
+void SmushPlayer::prefetchTimerProc(void *refCon) {
+	((SmushPlayer *)refCon)->prefetchChunks(kPrefetchBytesPerTick);
+}
+
+/**
+ * Read chunks ahead until the queue is full, or at least maxBytes have
+ * been read in this call. The timer thread also runs iMUSE and other
+ * timers, which must not be starved by slow media.
+ */
+void SmushPlayer::prefetchChunks(uint32 maxBytes) {
+	Common::StackLock lock(_prefetchMutex);
+	uint32 bytes = 0;
+
+	// Pending seeks are handled by parseNextFrame, which discards all
+	// chunks read ahead anyway.
+	while (bytes < maxBytes && _base && _seekPos < 0 && !_prefetchEnd && _numQueuedChunks < kMaxQueuedChunks) {
+		PrefetchedChunk *chunk = readChunk();
+		if (!chunk)
+			break;
+		_queuedChunks.push_back(chunk);
+		_numQueuedChunks++;
+		bytes += chunk->size;
+	}
+}
+
+/**
+ * Read the next chunk from _base into a pooled buffer. Returns 0 at the
+ * end of the file. Must be called with _prefetchMutex held.
+ */
+SmushPlayer::PrefetchedChunk *SmushPlayer::readChunk() {
+	const uint32 type = _base->readUint32BE();
+	const int32 size = _base->readUint32BE();
+	const int32 offset = _base->pos();
+
+	if (offset >= (int32)_baseSize) {
+		_prefetchEnd = true;
+		return NULL;
+	}
+
+	PrefetchedChunk *chunk;
+	if (_freeChunks.empty()) {
+		chunk = new PrefetchedChunk;
+		chunk->data = NULL;
+		chunk->capacity = 0;
+	} else {
+		chunk = _freeChunks.front();
+		_freeChunks.pop_front();
+	}
+
+	chunk->type = type;
+	// Truncated chunks at the end of the file are cut off
+	chunk->size = CLIP<int32>(size, 0, _baseSize - offset);
+	chunk->offset = offset;
+
+	if ((uint32)chunk->size > chunk->capacity) {
+		free(chunk->data);
+		chunk->capacity = chunk->size;
+		chunk->data = (byte *)malloc(chunk->capacity);
+		assert(chunk->data);
+	}
+
+	const uint32 len = _base->read(chunk->data, chunk->size);
+	memset(chunk->data + len, 0, chunk->size - len);
+	_base->seek(offset + size, SEEK_SET);
+
+#ifdef USE_ZLIB
+	if (type == MKID_BE('FRME'))
+		inflateFrameObjects(chunk);
+#endif
+
+	return chunk;
+}
+
+#ifdef USE_ZLIB
+/**
+ * Replace all ZFOB objects in a frame by the FOBJ objects they contain,
+ * so that inflating them is done by the prefetch timer, too. Frames which
+ * aren't well formed are left alone, and the errors are then reported by
+ * handleFrame / handleZlibFrameObject as usual.
+ */
+void SmushPlayer::inflateFrameObjects(PrefetchedChunk *chunk) {
+	const byte *src = chunk->data;
+	const int32 frameSize = chunk->size;
+	uint32 newSize = 0;
+	bool found = false;
+	int32 pos, subSize, len;
+
+	for (pos = 0; pos < frameSize; pos += 8 + subSize + (subSize & 1)) {
+		if (pos + 8 > frameSize)
+			return;
+		subSize = READ_BE_UINT32(src + pos + 4);
+		if (subSize < 0 || subSize > frameSize - pos - 8)
+			return;
+
+		len = subSize;
+		if (READ_BE_UINT32(src + pos) == MKID_BE('ZFOB')) {
+			if (subSize < 4)
+				return;
+			len = READ_BE_UINT32(src + pos + 8);
+			if (len < 14)
+				return;
+			found = true;
+		}
+		newSize += 8 + len + (len & 1);
+	}
+
+	if (!found)
+		return;
+
+	if (newSize > _inflateCapacity) {
+		free(_inflateBuffer);
+		_inflateCapacity = newSize;
+		_inflateBuffer = (byte *)malloc(_inflateCapacity);
+		assert(_inflateBuffer);
+	}
+
+	byte *dst = _inflateBuffer;
+	for (pos = 0; pos < frameSize; pos += 8 + subSize + (subSize & 1)) {
+		subSize = READ_BE_UINT32(src + pos + 4);
+
+		if (READ_BE_UINT32(src + pos) == MKID_BE('ZFOB')) {
+			unsigned long decompressedSize = READ_BE_UINT32(src + pos + 8);
+			len = decompressedSize;
+			if (!Common::uncompress(dst + 8, &decompressedSize, src + pos + 12, subSize - 4))
+				return;
+			WRITE_BE_UINT32(dst, MKID_BE('FOBJ'));
+			WRITE_BE_UINT32(dst + 4, len);
+		} else {
+			len = subSize;
+			memcpy(dst, src + pos, 8 + len);
+		}
+
+		dst += 8 + len;
+		if (len & 1)
+			*dst++ = 0;
+	}
+
+	SWAP(chunk->data, _inflateBuffer);
+	SWAP(chunk->capacity, _inflateCapacity);
+	chunk->size = newSize;
+}
+#endif
+
+/**
+ * Return the next chunk to be played, either from the prefetch queue or,
+ * if the timer proc hasn't caught up, read right away. Returns 0 at the
+ * end of the file. The chunk has to be returned with releaseChunk().
+ */
+SmushPlayer::PrefetchedChunk *SmushPlayer::nextChunk() {
+	Common::StackLock lock(_prefetchMutex);
+
+	if (_numQueuedChunks > _maxQueuedChunks)
+		_maxQueuedChunks = _numQueuedChunks;
+
+	if (!_queuedChunks.empty()) {
+		PrefetchedChunk *chunk = _queuedChunks.front();
+		_queuedChunks.pop_front();
+		_numQueuedChunks--;
+		_chunksPrefetched++;
+		return chunk;
+	}
+
+	if (_prefetchEnd)
+		return NULL;
+
+	_chunksRead++;
+	return readChunk();
+}
+
+void SmushPlayer::releaseChunk(PrefetchedChunk *chunk) {
+	Common::StackLock lock(_prefetchMutex);
+	_freeChunks.push_back(chunk);
+}
+
+/**
+ * Discard all chunks read ahead, e.g. because of a seek. Must be called
+ * with _prefetchMutex held.
+ */
+void SmushPlayer::flushPrefetchedChunks() {
+	while (!_queuedChunks.empty()) {
+		_freeChunks.push_back(_queuedChunks.front());
+		_queuedChunks.pop_front();
+	}
+	_numQueuedChunks = 0;
+	_prefetchEnd = false;
+}
+
+void SmushPlayer::freePrefetchedChunks() {
+	Common::StackLock lock(_prefetchMutex);
+
+	flushPrefetchedChunks();
+	for (ChunkList::iterator i = _freeChunks.begin(); i != _freeChunks.end(); ++i) {
+		free((*i)->data);
+		delete *i;
+	}
+	_freeChunks.clear();
+
+	free(_inflateBuffer);
+	_inflateBuffer = NULL;
+	_inflateCapacity = 0;
+}
+
+#pragma mark -
+
 void SmushPlayer::parseNextFrame() {
 
 	if (_seekPos >= 0) {
+		// The timer proc leaves _base alone while a seek is pending, so
+		// only discarding the chunks read ahead and replacing _base need
+		// the lock.
+		{
+			Common::StackLock lock(_prefetchMutex);
+			flushPrefetchedChunks();
+		}
+
 		if (_smixer)
 			_smixer->stop();
 
 		if (_seekFile.size() > 0) {
-			delete _base;
-
 			ScummFile *tmp = new ScummFile();
 			if (!g_scumm->openFile(*tmp, _seekFile))
 				error("SmushPlayer: Unable to open file %s", _seekFile.c_str());
-			_base = tmp;
+
+			{
+				Common::StackLock lock(_prefetchMutex);
+				delete _base;
+				_base = tmp;
+			}
 			_base->readUint32BE();
 			_baseSize = _base->readUint32BE();
 
@@ -1011,35 +1259,35 @@ void SmushPlayer::parseNextFrame() {
 		_startFrame = _frame;
 		_startTime = _vm->_system->getMillis();
 
+		Common::StackLock lock(_prefetchMutex);
 		_seekPos = -1;
 	}
 
 	assert(_base);
 
-	const uint32 subType = _base->readUint32BE();
-	const int32 subSize = _base->readUint32BE();
-	const int32 subOffset = _base->pos();
-
-	if (_base->pos() >= (int32)_baseSize) {
+	PrefetchedChunk *chunk = nextChunk();
+	if (!chunk) {
 		_vm->_smushVideoShouldFinish = true;
 		_endOfFile = true;
 		return;
 	}
 
-	debug(3, "Chunk: %s at %x", Common::tag2string(subType).c_str(), subOffset);
+	debug(3, "Chunk: %s at %x", Common::tag2string(chunk->type).c_str(), chunk->offset);
+
+	Common::MemoryReadStream b(chunk->data, chunk->size);
 
-	switch (subType) {
+	switch (chunk->type) {
 	case MKID_BE('AHDR'): // FT INSANE may seek file to the beginning
-		handleAnimHeader(subSize, *_base);
+		handleAnimHeader(chunk->size, b);
 		break;
 	case MKID_BE('FRME'):
-		handleFrame(subSize, *_base);
+		handleFrame(chunk->size, b);
 		break;
 	default:
-		error("Unknown Chunk found at %x: %s, %d", subOffset, Common::tag2string(subType).c_str(), subSize);
+		error("Unknown Chunk found at %x: %s, %d", chunk->offset, Common::tag2string(chunk->type).c_str(), chunk->size);
 	}
 
-	_base->seek(subOffset + subSize, SEEK_SET);
+	releaseChunk(chunk);
 
 	if (_insanity)
 		_vm->_sound->processSound();
@@ -1085,6 +1333,8 @@ void SmushPlayer::insanity(bool flag) {
 }
 
 void SmushPlayer::seekSan(const char *file, int32 pos, int32 contFrame) {
+	Common::StackLock lock(_prefetchMutex);
+
 	_seekFile = file ? file : "";
 	_seekPos = pos;
 	_seekFrame = contFrame;
@@ -1175,6 +1425,12 @@ void SmushPlayer::play(const char *filename, int32 speed, int32 offset, int32 st
 
 	_pauseTime = 0;
 
+	_chunksPrefetched = 0;
+	_chunksRead = 0;
+	_maxQueuedChunks = 0;
+	_framesDropped = 0;
+	_prefetchTimer = _vm->_system->getTimerManager()->installTimerProc(&prefetchTimerProc, kPrefetchInterval, this);
+
 	int skipped = 0;
 
 	for (;;) {
@@ -1205,6 +1461,11 @@ void SmushPlayer::play(const char *filename, int32 speed, int32 offset, int32 st
 				skipFrame = true;
 			else
 				skipFrame = false;
+
+			// The previous frame was skipped and is overwritten now
+			if (_updateNeeded)
+				_framesDropped++;
+
 			timerCallback();
 		}
 
@@ -1266,6 +1527,9 @@ void SmushPlayer::play(const char *filename, int32 speed, int32 offset, int32 st
 		_vm->_system->delayMillis(10);
 	}
 
+	debugC(DEBUG_SMUSH, "Smush stats: %d frames dropped, %d of %d chunks read ahead, max. queue depth %d",
+		_framesDropped, _chunksPrefetched, _chunksPrefetched + _chunksRead, _maxQueuedChunks);
+
 	release();
 
 	// Reset mouse state
@@ -26,6 +26,8 @@
 #if !defined(SCUMM_SMUSH_PLAYER_H) && defined(ENABLE_SCUMM_7_8)
 #define SCUMM_SMUSH_PLAYER_H
 
+#include "common/list.h"
+#include "common/mutex.h"
 #include "common/util.h"
 #include "scumm/sound.h"
 
@@ -85,6 +87,48 @@ private:
 	bool _middleAudio;
 	bool _skipPalette;
 
+	/**
+	 * A top level chunk of the SMUSH file. These are read ahead of
+	 * playback by a timer proc, which also inflates the ZFOB objects in
+	 * frames, so that the main thread only has to decode and present them.
+	 */
+	struct PrefetchedChunk {
+		uint32 type;
+		int32 size;
+		int32 offset;
+		byte *data;
+		uint32 capacity;
+	};
+
+	typedef Common::List<PrefetchedChunk *> ChunkList;
+
+	enum {
+		/** Maximal number of chunks read ahead. */
+		kMaxQueuedChunks = 6,
+		/** Number of bytes after which a timer invocation stops reading. */
+		kPrefetchBytesPerTick = 64 * 1024,
+		/** Interval of the prefetch timer (in microseconds). */
+		kPrefetchInterval = 10 * 1000
+	};
+
+	/**
+	 * Guards _base, _seekPos and all the prefetch state below. While a
+	 * seek is pending, the timer proc does not access _base.
+	 */
+	Common::Mutex _prefetchMutex;
+	ChunkList _queuedChunks;
+	ChunkList _freeChunks;
+	int _numQueuedChunks;
+	bool _prefetchEnd;
+	bool _prefetchTimer;
+	byte *_inflateBuffer;
+	uint32 _inflateCapacity;
+
+	uint32 _chunksPrefetched;
+	uint32 _chunksRead;
+	int _maxQueuedChunks;
+	uint32 _framesDropped;
+
 public:
 	SmushPlayer(ScummEngine_v7 *scumm);
 	~SmushPlayer();
@@ -138,6 +182,17 @@ private:
 	void readPalette(byte *, Common::SeekableReadStream &);
 
 	void timerCallback();
+
+	static void prefetchTimerProc(void *refCon);
+	void prefetchChunks(uint32 maxBytes);
+	PrefetchedChunk *readChunk();
+#ifdef USE_ZLIB
+	void inflateFrameObjects(PrefetchedChunk *chunk);
+#endif
+	PrefetchedChunk *nextChunk();
+	void releaseChunk(PrefetchedChunk *chunk);
+	void flushPrefetchedChunks();
+	void freePrefetchedChunks();
 };
 
 } // End of namespace Scumm
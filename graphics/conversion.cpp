@@ -26,7 +26,72 @@
 
 namespace Graphics {
 
-// TODO: YUV to RGB conversion function
+// The contributions of U and V to each color component, as computed by
+// YUV2RGB, and the pixel format bits of each (unclipped) color component
+// value, for the pixel format the tables were last built for.
+static int16 s_yuvVToR[256], s_yuvVToG[256], s_yuvUToG[256], s_yuvUToB[256];
+static uint32 s_yuvRToColor[1024], s_yuvGToColor[1024], s_yuvBToColor[1024];
+static Graphics::PixelFormat s_yuvTablesFormat;
+static bool s_yuvTablesBuilt = false;
+
+static void buildYUVTables(const Graphics::PixelFormat &format) {
+	for (int i = 0; i < 256; i++) {
+		s_yuvVToR[i] = (1357 * (i - 128)) >> 10;
+		s_yuvVToG[i] = (691 * (i - 128)) >> 10;
+		s_yuvUToG[i] = (333 * (i - 128)) >> 10;
+		s_yuvUToB[i] = (1715 * (i - 128)) >> 10;
+	}
+
+	// The alpha bits are merged into the red table
+	for (int i = 0; i < 1024; i++) {
+		const int c = CLIP<int>(i - 384, 0, 255);
+		s_yuvRToColor[i] = format.RGBToColor(c, 0, 0);
+		s_yuvGToColor[i] = format.RGBToColor(0, c, 0) & ~format.ARGBToColor(0xFF, 0, 0, 0);
+		s_yuvBToColor[i] = format.RGBToColor(0, 0, c) & ~format.ARGBToColor(0xFF, 0, 0, 0);
+	}
+
+	s_yuvTablesFormat = format;
+	s_yuvTablesBuilt = true;
+}
+
+template<typename PixelInt>
+static void convertYUV444ToRGBRow(PixelInt *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int w) {
+	const uint32 *rToColor = s_yuvRToColor + 384;
+	const uint32 *gToColor = s_yuvGToColor + 384;
+	const uint32 *bToColor = s_yuvBToColor + 384;
+
+	for (int x = 0; x < w; x++) {
+		const int y = ySrc[x];
+		const byte u = uSrc[x];
+		const byte v = vSrc[x];
+
+		dst[x] = rToColor[y + s_yuvVToR[v]] | gToColor[y - s_yuvVToG[v] - s_yuvUToG[u]] | bToColor[y + s_yuvUToB[u]];
+	}
+}
+
+bool convertYUV444ToRGB(byte *dst, int dstPitch, const Graphics::PixelFormat &dstFmt,
+						const byte *ySrc, const byte *uSrc, const byte *vSrc,
+						int yPitch, int uvPitch, int w, int h) {
+	if (dstFmt.bytesPerPixel != 2 && dstFmt.bytesPerPixel != 4)
+		return false;
+
+	if (!s_yuvTablesBuilt || !(s_yuvTablesFormat == dstFmt))
+		buildYUVTables(dstFmt);
+
+	for (int y = 0; y < h; y++) {
+		if (dstFmt.bytesPerPixel == 2)
+			convertYUV444ToRGBRow<uint16>((uint16 *)dst, ySrc, uSrc, vSrc, w);
+		else
+			convertYUV444ToRGBRow<uint32>((uint32 *)dst, ySrc, uSrc, vSrc, w);
+
+		dst += dstPitch;
+		ySrc += yPitch;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+
+	return true;
+}
 
 // Function to blit a rect from one color format to another
 bool crossBlit(byte *dst, const byte *src, int dstpitch, int srcpitch,
@@ -52,7 +52,27 @@ inline static void CPYUV2RGB(byte y, byte u, byte v, byte &r, byte &g, byte &b)
 	b = CLIP<int>(y + 2 * (u - 128), 0, 255);
 }
 
-// TODO: generic YUV to RGB blit
+/**
+ * Converts planar YUV 4:4:4 data, such as the components of a JPEG image,
+ * to RGB. The colors are exactly the same as those of YUV2RGB, but are
+ * computed with lookup tables.
+ *
+ * @param dst		the buffer which will receive the converted graphics data
+ * @param dstPitch	width in bytes of one full line of the dest buffer
+ * @param dstFmt	the desired pixel format, with 2 or 4 bytes per pixel
+ * @param ySrc		the Y plane
+ * @param uSrc		the U (Cb) plane
+ * @param vSrc		the V (Cr) plane
+ * @param yPitch	width in bytes of one full line of the Y plane
+ * @param uvPitch	width in bytes of one full line of the U and V planes
+ * @param w			the width of the graphics data
+ * @param h			the height of the graphics data
+ * @return			true if conversion completes successfully,
+ *					false if the destination format is not supported.
+ */
+bool convertYUV444ToRGB(byte *dst, int dstPitch, const Graphics::PixelFormat &dstFmt,
+						const byte *ySrc, const byte *uSrc, const byte *vSrc,
+						int yPitch, int uvPitch, int w, int h);
 
 /**
  * Blits a rectangle from one graphical format to another.
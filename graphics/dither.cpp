@@ -104,29 +104,67 @@ void PaletteLUT::buildNext() {
 #define SQR(x) ((x) * (x))
 // Building one "slice"
 void PaletteLUT::build(int d1) {
+	// Sort the palette entries by their distance to the slice in the first
+	// dimension (a counting sort, which keeps entries of the same distance
+	// in the order of their index). Once that distance alone is greater
+	// than the one of the closest entry found so far, no later entry can
+	// be closer.
+	uint16 count[257];
+	byte order[256];
+	int entries = 0;
+
+	memset(count, 0, sizeof(count));
+	for (int c = 0; c < 256; c++)
+		if (c != _transp)
+			count[ABS(d1 - _lutPal[c * 3]) + 1]++;
+	for (int i = 1; i < 257; i++)
+		count[i] += count[i - 1];
+	for (int c = 0; c < 256; c++) {
+		// Ignore the transparent color
+		if (c == _transp)
+			continue;
+
+		order[count[ABS(d1 - _lutPal[c * 3])]++] = c;
+		entries++;
+	}
+
 	// First dimension
 	byte *lut = _lut + d1 * _dim2;
 
+	uint32 dist[256];
+
 	// Second dimension
-	for (uint32 j = 0; j < _dim1; j++) {
+	for (int j = 0; j < (int)_dim1; j++) {
+		byte n = order[0];
+
+		// The distances in the first two dimensions
+		for (int i = 0; i < entries; i++) {
+			const byte *p = _lutPal + order[i] * 3;
+			dist[i] = SQR(d1 - p[0]) + SQR(j - p[1]);
+		}
+
 		// Third dimension
-		for (uint32 k = 0; k < _dim1; k++) {
-			const byte *p = _lutPal;
-			uint32 d = 0xFFFFFFFF;
-			byte n = 0;
-
-			// Going over every palette entry, searching for the closest
-			for (int c = 0; c < 256; c++, p += 3) {
-				// Ignore the transparent color
-				if (c == _transp)
+		for (int k = 0; k < (int)_dim1; k++) {
+			// The closest entry of the neighbouring color is usually close
+			// to this one as well, which ends the search early
+			const byte *p = _lutPal + n * 3;
+			uint32 d = SQR(d1 - p[0]) + SQR(j - p[1]) + SQR(k - p[2]);
+
+			// Searching for the closest entry. Of several equally close
+			// ones, the one with the lowest index is used.
+			for (int i = 0; i < entries; i++) {
+				const byte c = order[i];
+				p = _lutPal + c * 3;
+
+				if (SQR(d1 - p[0]) > d)
+					break;
+				if (dist[i] > d)
 					continue;
 
-				uint32 di = SQR(d1 - p[0]) + SQR(j - p[1]) + SQR(k - p[2]);
-				if (di < d) {
+				uint32 di = dist[i] + SQR(k - p[2]);
+				if ((di < d) || ((di == d) && (c < n))) {
 					d = di;
 					n = c;
-					if (d == 0)
-						break;
 				}
 			}
 
@@ -138,8 +176,18 @@ void PaletteLUT::build(int d1) {
 	_gots[d1] = 1;
 }
 
-inline int PaletteLUT::getIndex(byte c1, byte c2, byte c3) const {
-	return ((c1 >> _shift) << _depth2) | ((c2 >> _shift) << _depth1) | (c3 >> _shift);
+uint32 PaletteLUT::getHash() const {
+	// FNV-1a
+	uint32 hash = 2166136261U;
+
+	hash = (hash ^ _depth1) * 16777619U;
+	hash = (hash ^ _format) * 16777619U;
+	hash = (hash ^ (_transp & 0xFF)) * 16777619U;
+	hash = (hash ^ (_transp < 0)) * 16777619U;
+	for (int i = 0; i < 768; i++)
+		hash = (hash ^ _realPal[i]) * 16777619U;
+
+	return hash;
 }
 
 void PaletteLUT::getEntry(byte index, byte &c1, byte &c2, byte &c3) const {
@@ -148,25 +196,6 @@ void PaletteLUT::getEntry(byte index, byte &c1, byte &c2, byte &c3) const {
 	c3 = _realPal[index * 3 + 2];
 }
 
-byte PaletteLUT::findNearest(byte c1, byte c2, byte c3) {
-	return _lut[getIndex(c1, c2, c3)];
-}
-
-byte PaletteLUT::findNearest(byte c1, byte c2, byte c3, byte &nC1, byte &nC2, byte &nC3) {
-	// If we don't have the required "slice" yet, build it
-	if (!_gots[c1 >> _shift])
-		build(c1 >> _shift);
-
-	int palIndex = _lut[getIndex(c1, c2, c3)];
-	int i = palIndex * 3;
-
-	nC1 = _realPal[i + 0];
-	nC2 = _realPal[i + 1];
-	nC3 = _realPal[i + 2];
-
-	return palIndex;
-}
-
 bool PaletteLUT::save(Common::WriteStream &stream) {
 	// The table has to be completely built before we can save
 	while (_got < _dim1)
@@ -175,6 +204,8 @@ bool PaletteLUT::save(Common::WriteStream &stream) {
 	stream.writeUint32BE(MKID_BE('PLUT')); // Magic
 	stream.writeUint32BE(kVersion);
 	stream.writeByte(_depth1);
+	stream.writeByte(_format);
+	stream.writeSint32BE(_transp);
 	if (stream.write(_realPal, 768) != 768)
 		return false;
 	if (stream.write(_lutPal, 768) != 768)
@@ -191,8 +222,8 @@ bool PaletteLUT::save(Common::WriteStream &stream) {
 }
 
 bool PaletteLUT::load(Common::SeekableReadStream &stream) {
-	//             _realPal + _lutPal + _lut  + _depth1 + magic + version
-	int32 needSize =  768   +   768   + _dim3 +    1    +   4   +    4;
+	//             _realPal + _lutPal + _lut  + _depth1 + _format + _transp + magic + version
+	int32 needSize =  768   +   768   + _dim3 +    1    +    1    +    4    +   4   +    4;
 
 	if ((stream.size() - stream.pos()) < needSize)
 		return false;
@@ -209,6 +240,11 @@ bool PaletteLUT::load(Common::SeekableReadStream &stream) {
 	if (depth1 != _depth1)
 		return false;
 
+	if (stream.readByte() != _format)
+		return false;
+
+	_transp = stream.readSint32BE();
+
 	if (stream.read(_realPal, 768) != 768)
 		return false;
 	if (stream.read(_lutPal, 768) != 768)
@@ -228,6 +264,8 @@ SierraLight::SierraLight(int16 width, PaletteLUT *palLUT) {
 	_width = width;
 	_palLUT = palLUT;
 
+	assert(palLUT);
+
 	// Big buffer for the errors of the current and next line
 	_errorBuf = new int32[3 * (2 * (_width + 2*1))];
 	memset(_errorBuf, 0, (3 * (2 * (_width + 2*1))) * sizeof(int32));
@@ -235,6 +273,9 @@ SierraLight::SierraLight(int16 width, PaletteLUT *palLUT) {
 	_curLine = 0;
 	_errors[0] = _errorBuf + 3;
 	_errors[1] = _errors[0] + 3 * (_width + 2*1);
+
+	_errCur  = _errors[0];
+	_errNext = _errors[1];
 }
 
 SierraLight::~SierraLight() {
@@ -245,6 +286,9 @@ void SierraLight::newFrame() {
 	_curLine = 0;
 	memset(_errors[0], 0, 3 * _width * sizeof(int32));
 	memset(_errors[1], 0, 3 * _width * sizeof(int32));
+
+	_errCur  = _errors[0];
+	_errNext = _errors[1];
 }
 
 void SierraLight::nextLine() {
@@ -252,63 +296,59 @@ void SierraLight::nextLine() {
 	memset(_errors[_curLine], 0, 3 * _width * sizeof(int32));
 
 	_curLine = (_curLine + 1) % 2;
-}
-
-byte SierraLight::dither(byte c1, byte c2, byte c3, uint32 x) {
-	assert(_palLUT);
-	assert(x < (uint32)_width);
-
-	int32 eC1, eC2, eC3;
-
-	getErrors(x, eC1, eC2, eC3);
 
-	// Apply error on values
-	c1 = CLIP<int>(c1 + eC1, 0, 255);
-	c2 = CLIP<int>(c2 + eC2, 0, 255);
-	c3 = CLIP<int>(c3 + eC3, 0, 255);
-
-	// Find color
-	byte newC1, newC2, newC3;
-	byte newPixel = _palLUT->findNearest(c1, c2, c3, newC1, newC2, newC3);
-
-	// Calculate new error
-	eC1 = c1 - newC1;
-	eC2 = c2 - newC2;
-	eC3 = c3 - newC3;
-
-	// Add them
-	addErrors(x, eC1, eC2, eC3);
-
-	return newPixel;
+	_errCur  = _errors[_curLine];
+	_errNext = _errors[(_curLine + 1) % 2];
 }
 
-inline void SierraLight::getErrors(uint32 x, int32 &eC1, int32 &eC2, int32 &eC3) {
-	int32 *errCur = _errors[_curLine];
+void SierraLight::ditherLine(byte *dest, const byte *c1, const byte *c2, const byte *c3, uint32 width) {
+	assert(width <= (uint32)_width);
+
+	const int32 *errCur = _errCur;
+	int32 *errNext = _errNext;
+
+	// Instead of adding each pixel's error to its neighbours in the buffers,
+	// it is carried along: The right neighbour gets twice the error, and the
+	// pixel below left the sum of the errors of the two pixels above it.
+	// The next line's errors are still all 0 here, so they can be written
+	// instead of added to, each as soon as it is complete.
+	int32 eRight1 = 0, eRight2 = 0, eRight3 = 0;
+	int32 eLast1  = 0, eLast2  = 0, eLast3  = 0;
+
+	for (uint32 x = 0; x < width; x++, errCur += 3, errNext += 3) {
+		// Apply error on values
+		byte v1 = CLIP<int>(c1[x] + ((errCur[0] + eRight1) >> 2), 0, 255);
+		byte v2 = CLIP<int>(c2[x] + ((errCur[1] + eRight2) >> 2), 0, 255);
+		byte v3 = CLIP<int>(c3[x] + ((errCur[2] + eRight3) >> 2), 0, 255);
+
+		// Find color
+		byte newC1, newC2, newC3;
+		dest[x] = _palLUT->findNearest(v1, v2, v3, newC1, newC2, newC3);
+
+		// Calculate new error
+		int32 eC1 = v1 - newC1;
+		int32 eC2 = v2 - newC2;
+		int32 eC3 = v3 - newC3;
+
+		if (x > 0) {
+			errNext[-3] = eLast1 + eC1;
+			errNext[-2] = eLast2 + eC2;
+			errNext[-1] = eLast3 + eC3;
+		}
 
-	x *= 3;
-	eC1 = errCur[x + 0] >> 2;
-	eC2 = errCur[x + 1] >> 2;
-	eC3 = errCur[x + 2] >> 2;
-}
+		eRight1 = eC1 << 1;
+		eRight2 = eC2 << 1;
+		eRight3 = eC3 << 1;
+		eLast1  = eC1;
+		eLast2  = eC2;
+		eLast3  = eC3;
+	}
 
-inline void SierraLight::addErrors(uint32 x, int32 eC1, int32 eC2, int32 eC3) {
-	int32 *errCur  = _errors[_curLine];
-	int32 *errNext = _errors[(_curLine + 1) % 2];
-
-	// Indices for current error
-	int x0 = 3 * (x + 1);
-	int x1 = 3 * (x + 0);
-	int x2 = 3 * (x - 1);
-
-	errCur [x0 + 0] += eC1 << 1;
-	errCur [x0 + 1] += eC2 << 1;
-	errCur [x0 + 2] += eC3 << 1;
-	errNext[x1 + 0] += eC1;
-	errNext[x1 + 1] += eC2;
-	errNext[x1 + 2] += eC3;
-	errNext[x2 + 0] += eC1;
-	errNext[x2 + 1] += eC2;
-	errNext[x2 + 2] += eC3;
+	if (width > 0) {
+		errNext[-3] = eLast1;
+		errNext[-2] = eLast2;
+		errNext[-1] = eLast3;
+	}
 }
 
 } // End of namespace Graphics
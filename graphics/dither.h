@@ -81,6 +81,13 @@ public:
 	 */
 	void buildNext();
 
+	/** Return a hash of the palette, the table's depth and format and the
+	 *  transparent index, i.e. of everything the table's content depends on.
+	 *
+	 *  Can be used to key a cache of saved tables.
+	 */
+	uint32 getHash() const;
+
 	/** Querying the color components to a given palette entry index. */
 	void getEntry(byte index, byte &c1, byte &c2, byte &c3) const;
 	/** Finding the nearest matching entry.
@@ -90,7 +97,7 @@ public:
 	 *  @param c3 The third component of the wanted color.
 	 *  @return The palette entry matching the wanted color best.
 	 */
-	byte findNearest(byte c1, byte c2, byte c3);
+	inline byte findNearest(byte c1, byte c2, byte c3);
 	/** Finding the nearest matching entry, together with its color components.
 	 *
 	 *  @param c1 The first component of the wanted color.
@@ -101,18 +108,21 @@ public:
 	 *  @paran nC3 The third component of the found color.
 	 *  @return The palette entry matching the wanted color best.
 	 */
-	byte findNearest(byte c1, byte c2, byte c3, byte &nC1, byte &nC2, byte &nC3);
+	inline byte findNearest(byte c1, byte c2, byte c3, byte &nC1, byte &nC2, byte &nC3);
 
 	/** Save the table to a stream.
 	 *
 	 *  This will build the whole table first.
 	 */
 	bool save(Common::WriteStream &stream);
-	/** Load the table from a stream. */
+	/** Load the table from a stream.
+	 *
+	 *  This replaces the palette with the one the table was saved with.
+	 */
 	bool load(Common::SeekableReadStream &stream);
 
 private:
-	static const uint32 kVersion = 1;
+	static const uint32 kVersion = 2;
 
 	byte _depth1; ///< The table's depth for one dimension.
 	byte _depth2; ///< The table's depth for two dimensions.
@@ -172,7 +182,20 @@ public:
 	 *  @param c3 The third color component of the pixel.
 	 *  @param x The pixel's x coordinate within the image.
 	 */
-	byte dither(byte c1, byte c2, byte c3, uint32 x);
+	inline byte dither(byte c1, byte c2, byte c3, uint32 x);
+	/** Dither a whole line.
+	 *
+	 *  Gives the same result as calling dither() for each pixel from left to
+	 *  right, but faster. None of the line's pixels may have been
+	 *  dithered yet.
+	 *
+	 *  @param dest Where to write the dithered pixels.
+	 *  @param c1 The first color components of the pixels.
+	 *  @param c2 The second color components of the pixels.
+	 *  @param c3 The third color components of the pixels.
+	 *  @param width The number of pixels to dither.
+	 */
+	void ditherLine(byte *dest, const byte *c1, const byte *c2, const byte *c3, uint32 width);
 
 protected:
 	int16 _width; ///< The image's width.
@@ -183,12 +206,69 @@ protected:
 	int32 *_errors[2]; ///< Pointers into the error buffer for two lines.
 	int _curLine;      ///< Which one is the current line?
 
-	/** Querying a pixel's errors. */
-	inline void getErrors(uint32 x, int32 &eC1, int32 &eC2, int32 &eC3);
-	/** Adding a pixel's errors. */
-	inline void addErrors(uint32 x, int32 eC1, int32 eC2, int32 eC3);
+	int32 *_errCur;  ///< The current line's errors.
+	int32 *_errNext; ///< The next line's errors.
 };
 
+inline byte PaletteLUT::findNearest(byte c1, byte c2, byte c3, byte &nC1, byte &nC2, byte &nC3) {
+	// If we don't have the required "slice" yet, build it
+	if (!_gots[c1 >> _shift])
+		build(c1 >> _shift);
+
+	int palIndex = _lut[getIndex(c1, c2, c3)];
+	int i = palIndex * 3;
+
+	nC1 = _realPal[i + 0];
+	nC2 = _realPal[i + 1];
+	nC3 = _realPal[i + 2];
+
+	return palIndex;
+}
+
+inline byte PaletteLUT::findNearest(byte c1, byte c2, byte c3) {
+	return _lut[getIndex(c1, c2, c3)];
+}
+
+inline int PaletteLUT::getIndex(byte c1, byte c2, byte c3) const {
+	return ((c1 >> _shift) << _depth2) | ((c2 >> _shift) << _depth1) | (c3 >> _shift);
+}
+
+// Inlined, since it's called for every pixel of dithered videos
+inline byte SierraLight::dither(byte c1, byte c2, byte c3, uint32 x) {
+	assert(x < (uint32)_width);
+
+	int32 *errCur  = _errCur  + 3 * x;
+	int32 *errNext = _errNext + 3 * x;
+
+	// Apply error on values
+	c1 = CLIP<int>(c1 + (errCur[0] >> 2), 0, 255);
+	c2 = CLIP<int>(c2 + (errCur[1] >> 2), 0, 255);
+	c3 = CLIP<int>(c3 + (errCur[2] >> 2), 0, 255);
+
+	// Find color
+	byte newC1, newC2, newC3;
+	byte newPixel = _palLUT->findNearest(c1, c2, c3, newC1, newC2, newC3);
+
+	// Calculate new error
+	int32 eC1 = c1 - newC1;
+	int32 eC2 = c2 - newC2;
+	int32 eC3 = c3 - newC3;
+
+	// Add them: Twice to the next pixel, once to the pixel below and the
+	// one below left
+	errCur [ 3] += eC1 << 1;
+	errCur [ 4] += eC2 << 1;
+	errCur [ 5] += eC3 << 1;
+	errNext[ 0] += eC1;
+	errNext[ 1] += eC2;
+	errNext[ 2] += eC3;
+	errNext[-3] += eC1;
+	errNext[-2] += eC2;
+	errNext[-1] += eC3;
+
+	return newPixel;
+}
+
 } // End of namespace Graphics
 
 #endif
@@ -52,19 +52,8 @@ JPEG::JPEG() :
 
 	// Initialize the Huffman tables
 	for (int i = 0; i < 2 * JPEG_MAX_HUFF_TABLES; i++) {
-		_huff[i].count = 0;
 		_huff[i].values = NULL;
-		_huff[i].sizes = NULL;
-		_huff[i].codes = NULL;
-	}
-
-	// Initialize sqrt_2 and cosine lookups
-	_sqrt_2 = sqrt(2.0f);
-	debug(2, "JPEG: _sqrt_2: %f", _sqrt_2);
-
-	for(byte i = 0; i < 32; i++) {
-		_cosine_32[i] = cos(i * PI / 16);
-		debug(2, "JPEG: _cosine_32[%d]: %f", i, _cosine_32[i]);
+		clearHuffmanTable(_huff[i]);
 	}
 }
 
@@ -95,11 +84,19 @@ void JPEG::reset() {
 	}
 
 	// Free the Huffman tables
-	for (int i = 0; i < 2 * JPEG_MAX_HUFF_TABLES; i++) {
-		_huff[i].count = 0;
-		delete[] _huff[i].values; _huff[i].values = NULL;
-		delete[] _huff[i].sizes; _huff[i].sizes = NULL;
-		delete[] _huff[i].codes; _huff[i].codes = NULL;
+	for (int i = 0; i < 2 * JPEG_MAX_HUFF_TABLES; i++)
+		clearHuffmanTable(_huff[i]);
+}
+
+void JPEG::clearHuffmanTable(HuffmanTable &table) {
+	table.count = 0;
+	delete[] table.values; table.values = NULL;
+
+	// Make every code invalid
+	memset(table.lookup, 0, sizeof(table.lookup));
+	for (int size = 0; size <= 16; size++) {
+		table.maxCode[size] = -1;
+		table.valOffset[size] = 0;
 	}
 }
 
@@ -265,48 +262,50 @@ bool JPEG::readDHT() {
 		uint8 tableNum = (tableId << 1) + tableType;
 
 		// Free the Huffman table
-		delete[] _huff[tableNum].values; _huff[tableNum].values = NULL;
-		delete[] _huff[tableNum].sizes; _huff[tableNum].sizes = NULL;
-		delete[] _huff[tableNum].codes;	_huff[tableNum].codes = NULL;
+		HuffmanTable &huff = _huff[tableNum];
+		clearHuffmanTable(huff);
 
 		// Read the number of values for each length
 		uint8 numValues[16];
-		_huff[tableNum].count = 0;
+		int count = 0;
 		for (int len = 0; len < 16; len++) {
 			numValues[len] = _str->readByte();
-			_huff[tableNum].count += numValues[len];
+			count += numValues[len];
+		}
+
+		if (count > 256) {
+			warning("JPEG: Invalid Huffman table");
+			return false;
 		}
 
-		// Allocate memory for the current table
-		_huff[tableNum].values = new uint8[_huff[tableNum].count];
-		_huff[tableNum].sizes = new uint8[_huff[tableNum].count];
-		_huff[tableNum].codes = new uint16[_huff[tableNum].count];
+		// Allocate memory for the current table, and read its contents
+		huff.count = count;
+		huff.values = new uint8[count];
+		_str->read(huff.values, count);
 
-		// Read the table contents
+		// Assign the canonical Huffman codes, which are consecutive for
+		// each code size, and fill the decoding tables
 		int cur = 0;
-		for (int len = 0; len < 16; len++) {
-			for (int i = 0; i < numValues[len]; i++) {
-				_huff[tableNum].values[cur] = _str->readByte();
-				_huff[tableNum].sizes[cur] = len + 1;
-				cur++;
-			}
-		}
+		uint32 code = 0;
+		for (int codeSize = 1; codeSize <= 16; codeSize++) {
+			huff.valOffset[codeSize] = cur - code;
+
+			for (int i = 0; i < numValues[codeSize - 1]; i++, cur++, code++) {
+				if (code >= (1u << codeSize)) {
+					warning("JPEG: Invalid Huffman table");
+					return false;
+				}
 
-		// Fill the table of Huffman codes
-		cur = 0;
-		uint16 curCode = 0;
-		uint8 curCodeSize = _huff[tableNum].sizes[0];
-		while (cur < _huff[tableNum].count) {
-			// Increase the code size to fit the request
-			while (_huff[tableNum].sizes[cur] != curCodeSize) {
-				curCode <<= 1;
-				curCodeSize++;
+				if (codeSize <= JPEG_HUFF_LOOKAHEAD) {
+					// Fill in all entries starting with this code
+					int shift = JPEG_HUFF_LOOKAHEAD - codeSize;
+					for (int j = 0; j < (1 << shift); j++)
+						huff.lookup[(code << shift) | j] = (codeSize << 8) | huff.values[cur];
+				}
 			}
 
-			// Assign the current code
-			_huff[tableNum].codes[cur] = curCode;
-			curCode++;
-			cur++;
+			huff.maxCode[codeSize] = numValues[codeSize - 1] ? (int32)code - 1 : -1;
+			code <<= 1;
 		}
 	}
 
@@ -390,7 +389,9 @@ bool JPEG::readSOS() {
 	}
 
 	// Entropy coded sequence starts, initialize Huffman decoder
+	_bitsData = 0;
 	_bitsNumber = 0;
+	_bitsMarker = false;
 
 	// Read all the scan MCUs
 	uint16 xMCU = _w / (_maxFactorH * 8);
@@ -467,20 +468,139 @@ bool JPEG::readMCU(uint16 xMCU, uint16 yMCU) {
 	return ok;
 }
 
-float JPEG::idct(int x, int y, int weight, int fx, int fy) {
-	byte vx_in = ((int32)((2 * x) + 1) * fx) % 32;
-	byte vy_in = ((int32)((2 * y) + 1) * fy) % 32;
-	float ret = (float)weight * _cosine_32[vx_in] * _cosine_32[vy_in];
+// Fixed point constants of the IDCT, scaled by 2^13: FIX(x) = x * 8192
+enum {
+	kIdctConstBits = 13,
+	kIdctPass1Bits = 2,
+
+	kFix_0_298631336 = 2446,
+	kFix_0_390180644 = 3196,
+	kFix_0_541196100 = 4433,
+	kFix_0_765366865 = 6270,
+	kFix_0_899976223 = 7373,
+	kFix_1_175875602 = 9633,
+	kFix_1_501321110 = 12299,
+	kFix_1_847759065 = 15137,
+	kFix_1_961570560 = 16069,
+	kFix_2_053119869 = 16819,
+	kFix_2_562915447 = 20995,
+	kFix_3_072711026 = 25172
+};
+
+#define JPEG_DESCALE(x, n) (((x) + (1 << ((n) - 1))) >> (n))
+
+// One dimensional 8 point IDCT of the Loeffler, Ligtenberg and Moschytz
+// kind, as also used by the IJG library. The input is read with the given
+// stride, the even and odd halves of the output are left in tmp10..tmp13
+// and tmp0..tmp3, to be combined by the caller.
+#define JPEG_IDCT_1D(in, stride) \
+	do { \
+		int32 z1, z2, z3, z4, z5; \
+		\
+		/* Even part */ \
+		z2 = in[2 * stride]; \
+		z3 = in[6 * stride]; \
+		z1 = (z2 + z3) * kFix_0_541196100; \
+		tmp2 = z1 - z3 * kFix_1_847759065; \
+		tmp3 = z1 + z2 * kFix_0_765366865; \
+		\
+		tmp0 = (in[0] + in[4 * stride]) << kIdctConstBits; \
+		tmp1 = (in[0] - in[4 * stride]) << kIdctConstBits; \
+		\
+		tmp10 = tmp0 + tmp3; \
+		tmp13 = tmp0 - tmp3; \
+		tmp11 = tmp1 + tmp2; \
+		tmp12 = tmp1 - tmp2; \
+		\
+		/* Odd part */ \
+		tmp0 = in[7 * stride]; \
+		tmp1 = in[5 * stride]; \
+		tmp2 = in[3 * stride]; \
+		tmp3 = in[1 * stride]; \
+		\
+		z1 = tmp0 + tmp3; \
+		z2 = tmp1 + tmp2; \
+		z3 = tmp0 + tmp2; \
+		z4 = tmp1 + tmp3; \
+		z5 = (z3 + z4) * kFix_1_175875602; \
+		\
+		tmp0 *= kFix_0_298631336; \
+		tmp1 *= kFix_2_053119869; \
+		tmp2 *= kFix_3_072711026; \
+		tmp3 *= kFix_1_501321110; \
+		z1 *= -kFix_0_899976223; \
+		z2 *= -kFix_2_562915447; \
+		z3 = z3 * -kFix_1_961570560 + z5; \
+		z4 = z4 * -kFix_0_390180644 + z5; \
+		\
+		tmp0 += z1 + z3; \
+		tmp1 += z2 + z4; \
+		tmp2 += z2 + z3; \
+		tmp3 += z1 + z4; \
+	} while (0)
+
+static inline byte idctClamp(int32 val) {
+	// Level shift to make the values unsigned
+	val += 128;
+	return (val < 0) ? 0 : ((val > 255) ? 255 : val);
+}
 
-	if (fx == 0)
-		ret /= _sqrt_2;
+void JPEG::idct8x8(const int32 *in, byte *out) {
+	int32 tmp0, tmp1, tmp2, tmp3, tmp10, tmp11, tmp12, tmp13;
+	int32 workspace[64];
+	int32 *ws = workspace;
+
+	// Pass 1: process the columns, store the results scaled up by
+	// 2^kIdctPass1Bits in the workspace
+	for (int i = 0; i < 8; i++, in++, ws++) {
+		// Most columns are empty apart from the DC coefficient
+		if (!(in[8] | in[16] | in[24] | in[32] | in[40] | in[48] | in[56])) {
+			const int32 dc = in[0] << kIdctPass1Bits;
+			for (int j = 0; j < 8; j++)
+				ws[j * 8] = dc;
+			continue;
+		}
 
-	if (fy == 0)
-		ret /= _sqrt_2;
+		JPEG_IDCT_1D(in, 8);
+
+		const int shift = kIdctConstBits - kIdctPass1Bits;
+		ws[0]  = JPEG_DESCALE(tmp10 + tmp3, shift);
+		ws[56] = JPEG_DESCALE(tmp10 - tmp3, shift);
+		ws[8]  = JPEG_DESCALE(tmp11 + tmp2, shift);
+		ws[48] = JPEG_DESCALE(tmp11 - tmp2, shift);
+		ws[16] = JPEG_DESCALE(tmp12 + tmp1, shift);
+		ws[40] = JPEG_DESCALE(tmp12 - tmp1, shift);
+		ws[24] = JPEG_DESCALE(tmp13 + tmp0, shift);
+		ws[32] = JPEG_DESCALE(tmp13 - tmp0, shift);
+	}
 
-	return ret;
+	// Pass 2: process the rows, removing the pass 1 scaling and the factor
+	// of 8 of the transformation
+	ws = workspace;
+	for (int i = 0; i < 8; i++, ws += 8, out += 8) {
+		if (!(ws[1] | ws[2] | ws[3] | ws[4] | ws[5] | ws[6] | ws[7])) {
+			const byte dc = idctClamp(JPEG_DESCALE(ws[0], kIdctPass1Bits + 3));
+			memset(out, dc, 8);
+			continue;
+		}
+
+		JPEG_IDCT_1D(ws, 1);
+
+		const int shift = kIdctConstBits + kIdctPass1Bits + 3;
+		out[0] = idctClamp(JPEG_DESCALE(tmp10 + tmp3, shift));
+		out[7] = idctClamp(JPEG_DESCALE(tmp10 - tmp3, shift));
+		out[1] = idctClamp(JPEG_DESCALE(tmp11 + tmp2, shift));
+		out[6] = idctClamp(JPEG_DESCALE(tmp11 - tmp2, shift));
+		out[2] = idctClamp(JPEG_DESCALE(tmp12 + tmp1, shift));
+		out[5] = idctClamp(JPEG_DESCALE(tmp12 - tmp1, shift));
+		out[3] = idctClamp(JPEG_DESCALE(tmp13 + tmp0, shift));
+		out[4] = idctClamp(JPEG_DESCALE(tmp13 - tmp0, shift));
+	}
 }
 
+#undef JPEG_IDCT_1D
+#undef JPEG_DESCALE
+
 bool JPEG::readDataUnit(uint16 x, uint16 y) {
 	// Prepare an empty data array
 	int16 readData[64];
@@ -495,41 +615,16 @@ bool JPEG::readDataUnit(uint16 x, uint16 y) {
 	readAC(readData);
 
 	// Calculate the DCT coefficients from the input sequence
-	int16 DCT[64];
+	const uint16 *quant = _quant[_currentComp->quantTableSelector];
+	int32 DCT[64];
 	for (uint8 i = 0; i < 64; i++) {
-		// Dequantize
-		int16 val = readData[i];
-		int16 quant = _quant[_currentComp->quantTableSelector][i];
-		val *= quant;
-
-		// Store the normalized coefficients, undoing the Zig-Zag
-		DCT[_zigZagOrder[i]] = val;
-	}
-
-	// Shortcut the IDCT for DC component
-	float result[64];
-	for (uint8 i = 0; i < 64; i++)
-		result[i] = DCT[0] / 2;
-
-	// Apply the IDCT (PAG31)
-	for (int i = 1; i < 64; i++) {
-		if (DCT[i])
-			for (int _y = 0; _y < 8; _y++)
-				for (int _x = 0; _x < 8; _x++)
-					result[_y * 8 + _x] += idct(_x, _y, DCT[i], i % 8, i / 8);
+		// Dequantize, and store the coefficients undoing the Zig-Zag
+		DCT[_zigZagOrder[i]] = readData[i] * quant[i];
 	}
 
-	// Level shift to make the values unsigned
-	// Divide by 4 is final part of IDCT
-	for (int i = 0; i < 64; i++) {
-		result[i] = result[i] / 4 + 128;
-
-		if (result[i] < 0)
-			result[i] = 0;
-
-		if (result[i] > 255)
-			result[i] = 255;
-	}
+	// Apply the IDCT
+	byte result[64];
+	idct8x8(DCT, result);
 
 	// Paint the component surface
 	uint8 scalingV = _maxFactorV / _currentComp->factorV;
@@ -539,6 +634,12 @@ bool JPEG::readDataUnit(uint16 x, uint16 y) {
 	x <<= 3;
 	y <<= 3;
 
+	if (scalingV == 1 && scalingH == 1) {
+		for (uint8 j = 0; j < 8; j++)
+			memcpy(_currentComp->surface.getBasePtr(x, y + j), result + j * 8, 8);
+		return true;
+	}
+
 	for (uint8 j = 0; j < 8; j++) {
 		for (uint16 sV = 0; sV < scalingV; sV++) {
 			// Get the beginning of the block line
@@ -546,7 +647,7 @@ bool JPEG::readDataUnit(uint16 x, uint16 y) {
 
 			for (uint8 i = 0; i < 8; i++) {
 				for (uint16 sH = 0; sH < scalingH; sH++) {
-					*ptr = (byte)(result[j * 8 + i]);
+					*ptr = result[j * 8 + i];
 					ptr++;
 				}
 			}
@@ -591,85 +692,98 @@ void JPEG::readAC(int16 *out) {
 			cur += r;
 
 			// Read the next value
-			out[cur] = readSignedBits(s);
+			int16 val = readSignedBits(s);
+			if (cur < 64)
+				out[cur] = val;
 			cur++;
 		}
 	}
 }
 
 int16 JPEG::readSignedBits(uint8 numBits) {
-	uint16 ret = 0;
+	if (numBits == 0)
+		return 0;
 	if (numBits > 16) error("requested %d bits", numBits); //XXX
 
 	// MSB=0 for negatives, 1 for positives
-	for (int i = 0; i < numBits; i++)
-		ret = (ret << 1) + readBit();
+	int32 ret = readBits(numBits);
 
 	// Extend sign bits (PAG109)
-	if (!(ret >> (numBits - 1)))
-	{
-		uint16 tmp = ((uint16)-1 << numBits) + 1;
-		ret = ret + tmp;
-	}
+	if (ret < (1 << (numBits - 1)))
+		ret -= (1 << numBits) - 1;
 	return ret;
 }
 
-// TODO: optimize?
 uint8 JPEG::readHuff(uint8 table) {
-	bool foundCode = false;
-	uint8 val = 0;
-
-	uint8 cur = 0;
-	uint8 codeSize = 1;
-	uint16 code = readBit();
-	while (!foundCode) {
-		// Prepare a code of the current size
-		while (codeSize < _huff[table].sizes[cur]) {
-			code = (code << 1) + readBit();
-			codeSize++;
-		}
+	const HuffmanTable &huff = _huff[table];
 
-		// Compare the codes of the current size
-		while (!foundCode && (codeSize == _huff[table].sizes[cur])) {
-			if (code == _huff[table].codes[cur]) {
-				// Found the code
-				val = _huff[table].values[cur];
-				foundCode = true;
-			} else {
-				// Continue reading
-				cur++;
-			}
+	if (_bitsNumber < 16)
+		fillBits();
+
+	// Decode short codes with a single table lookup
+	uint16 lookup = huff.lookup[(_bitsData >> (_bitsNumber - JPEG_HUFF_LOOKAHEAD)) & ((1 << JPEG_HUFF_LOOKAHEAD) - 1)];
+	if (lookup) {
+		_bitsNumber -= lookup >> 8;
+		return lookup & 0xFF;
+	}
+
+	// Longer codes are compared to the largest code of each size, as the
+	// codes of each size are consecutive
+	for (uint8 size = JPEG_HUFF_LOOKAHEAD + 1; size <= 16; size++) {
+		int32 code = (_bitsData >> (_bitsNumber - size)) & ((1 << size) - 1);
+		if (code <= huff.maxCode[size]) {
+			_bitsNumber -= size;
+			return huff.values[huff.valOffset[size] + code];
 		}
 	}
 
-	return val;
+	warning("JPEG: Invalid Huffman code");
+	_bitsNumber -= 16;
+	return 0;
+}
+
+uint16 JPEG::readBits(uint8 numBits) {
+	if (_bitsNumber < numBits)
+		fillBits();
+
+	_bitsNumber -= numBits;
+	return (_bitsData >> _bitsNumber) & ((1 << numBits) - 1);
 }
 
-uint8 JPEG::readBit() {
-	// Read a whole byte if necessary
-	if (_bitsNumber == 0) {
-		_bitsData = _str->readByte();
-		_bitsNumber = 8;
-
-		// Detect markers
-		if (_bitsData == 0xFF) {
-			uint8 byte2 = _str->readByte();
-
-			// A stuffed 0 validates the previous byte
-			if (byte2 != 0) {
-				if (byte2 == 0xDC) {
-					// DNL marker: Define Number of Lines
-					// TODO: terminate scan
-					printf("DNL marker detected: terminate scan\n");
-				} else {
-					printf("Error: marker 0x%02X read in entropy data\n", byte2);
+void JPEG::fillBits() {
+	// Keep at least 25 bits buffered, so that any code and the value
+	// following it can be read without checking again
+	while (_bitsNumber <= 24) {
+		uint8 data = 0;
+
+		// Once a marker has been found, only feed zeros
+		if (!_bitsMarker) {
+			data = _str->readByte();
+
+			// Detect markers
+			if (data == 0xFF) {
+				uint8 byte2 = _str->readByte();
+
+				// A stuffed 0 validates the previous byte
+				if (byte2 != 0) {
+					if (byte2 == 0xDC) {
+						// DNL marker: Define Number of Lines
+						// TODO: terminate scan
+						debug(2, "JPEG: DNL marker detected: terminate scan");
+					}
+
+					// Leave the marker to read(), which has to find
+					// it once the scan is complete
+					_str->seek(-2, SEEK_CUR);
+					_bitsMarker = true;
+					data = 0;
 				}
 			}
 		}
-	}
-	_bitsNumber--;
 
-	return (_bitsData & (1 << _bitsNumber)) ? 1 : 0;
+		_bitsData = (_bitsData << 8) | data;
+		_bitsNumber += 8;
+	}
 }
 
 Surface *JPEG::getComponent(uint c) {
@@ -34,6 +34,9 @@ namespace Graphics {
 #define JPEG_MAX_QUANT_TABLES 4
 #define JPEG_MAX_HUFF_TABLES 2
 
+// Huffman codes of up to this many bits are decoded with a single lookup
+#define JPEG_HUFF_LOOKAHEAD 8
+
 class JPEG {
 public:
 	JPEG();
@@ -82,9 +85,15 @@ private:
 	struct HuffmanTable {
 		uint8 count;
 		uint8 *values;
-		uint8 *sizes;
-		uint16 *codes;
+
+		// Decoding tables: code size and value of the codes starting with
+		// each JPEG_HUFF_LOOKAHEAD bits combination (0 for longer codes),
+		// and the largest code and offset into values for each code size
+		uint16 lookup[1 << JPEG_HUFF_LOOKAHEAD];
+		int32 maxCode[17];
+		int32 valOffset[17];
 	} _huff[2 * JPEG_MAX_HUFF_TABLES];
+	void clearHuffmanTable(HuffmanTable &table);
 
 	// Marker read functions
 	bool readJFIF();
@@ -102,14 +111,14 @@ private:
 
 	// Huffman decoding
 	uint8 readHuff(uint8 table);
-	uint8 readBit();
-	uint8 _bitsData;
+	uint16 readBits(uint8 numBits);
+	void fillBits();
+	uint32 _bitsData;
 	uint8 _bitsNumber;
+	bool _bitsMarker;
 
-	float _sqrt_2;
-	float _cosine_32[32];
-	// Discrete Cosine Transformation
-	float idct(int x, int y, int weight, int fx, int fy);
+	// Inverse Discrete Cosine Transformation
+	static void idct8x8(const int32 *in, byte *out);
 };
 
 } // End of Graphics namespace
@@ -18,14 +18,17 @@ MODULE_OBJS := \
 	scaler/thumbnail_intern.o \
 	sjis.o \
 	surface.o \
+	surfacepool.o \
 	thumbnail.o \
 	VectorRenderer.o \
 	VectorRendererSpec.o \
+	video/async_decoder.o \
 	video/avi_decoder.o \
 	video/dxa_decoder.o \
 	video/flic_decoder.o \
 	video/mpeg_player.o \
 	video/smk_decoder.o \
+	video/video_benchmark.o \
 	video/video_player.o \
 	video/codecs/msrle.o \
 	video/codecs/msvideo1.o \
@@ -0,0 +1,140 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#include "graphics/surfacepool.h"
+#include "graphics/surface.h"
+
+#include "common/config-manager.h"
+#include "common/util.h"
+
+DECLARE_SINGLETON(Graphics::SharedSurfacePool);
+
+namespace Graphics {
+
+static uint32 getSurfaceSize(const Surface *surface) {
+	return surface->pitch * surface->h;
+}
+
+SurfacePool::SurfacePool(uint32 maxRetainedBytes) : _maxRetainedBytes(maxRetainedBytes) {
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+SurfacePool::~SurfacePool() {
+	clear();
+}
+
+Surface *SurfacePool::acquire(uint16 width, uint16 height, uint8 bytesPerPixel) {
+	_stats.acquired++;
+
+	for (Common::List<Surface *>::iterator it = _surfaces.begin(); it != _surfaces.end(); ++it) {
+		Surface *surface = *it;
+		if (surface->w == width && surface->h == height && surface->bytesPerPixel == bytesPerPixel) {
+			_surfaces.erase(it);
+			_stats.retainedBytes -= getSurfaceSize(surface);
+			_stats.reused++;
+			return surface;
+		}
+	}
+
+	Surface *surface = new Surface();
+	surface->create(width, height, bytesPerPixel);
+	return surface;
+}
+
+void SurfacePool::release(Surface *surface) {
+	if (!surface)
+		return;
+
+	uint32 size = getSurfaceSize(surface);
+	if (size > _maxRetainedBytes) {
+		surface->free();
+		delete surface;
+		_stats.discarded++;
+		return;
+	}
+
+	_surfaces.push_front(surface);
+	_stats.retainedBytes += size;
+	trim(_maxRetainedBytes);
+
+	_stats.peakRetainedBytes = MAX(_stats.peakRetainedBytes, _stats.retainedBytes);
+}
+
+void SurfacePool::setMaxRetainedBytes(uint32 bytes) {
+	_maxRetainedBytes = bytes;
+	trim(_maxRetainedBytes);
+}
+
+void SurfacePool::clear() {
+	trim(0);
+}
+
+/**
+ * Free the least recently released surfaces, until at most maxBytes are
+ * retained.
+ */
+void SurfacePool::trim(uint32 maxBytes) {
+	while (_stats.retainedBytes > maxBytes) {
+		Surface *surface = _surfaces.back();
+		_surfaces.pop_back();
+
+		_stats.retainedBytes -= getSurfaceSize(surface);
+		_stats.discarded++;
+
+		surface->free();
+		delete surface;
+	}
+}
+
+
+#pragma mark -
+
+
+SharedSurfacePool::SharedSurfacePool() {
+	if (ConfMan.hasKey("video_pool_size"))
+		_pool.setMaxRetainedBytes(MAX(ConfMan.getInt("video_pool_size"), 0) * 1024);
+}
+
+Surface *SharedSurfacePool::acquire(uint16 width, uint16 height, uint8 bytesPerPixel) {
+	Common::StackLock lock(_mutex);
+	return _pool.acquire(width, height, bytesPerPixel);
+}
+
+void SharedSurfacePool::release(Surface *surface) {
+	Common::StackLock lock(_mutex);
+	_pool.release(surface);
+}
+
+void SharedSurfacePool::clear() {
+	Common::StackLock lock(_mutex);
+	_pool.clear();
+}
+
+void SharedSurfacePool::getStatistics(SurfacePool::Statistics &stats) {
+	Common::StackLock lock(_mutex);
+	stats = _pool.getStatistics();
+}
+
+} // End of namespace Graphics
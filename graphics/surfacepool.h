@@ -0,0 +1,139 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#ifndef GRAPHICS_SURFACEPOOL_H
+#define GRAPHICS_SURFACEPOOL_H
+
+#include "common/scummsys.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+
+namespace Graphics {
+
+struct Surface;
+
+/**
+ * A pool of surfaces, which keeps the surfaces released by video decoders
+ * around, so that the next video of the same size can reuse them instead of
+ * allocating (and page faulting in) new ones. This makes starting videos
+ * back to back cheap.
+ *
+ * Surfaces are matched by their width, height and bytes per pixel. The pool
+ * retains at most getMaxRetainedBytes() bytes of pixel data, released
+ * surfaces which do not fit anymore are freed, least recently released
+ * first.
+ *
+ * This class is not thread safe, video decoders use the SharedSurfacePool.
+ */
+class SurfacePool {
+public:
+	enum {
+		/** Enough for the frame buffers of a few 640x480 videos. */
+		kDefaultMaxRetainedBytes = 4 * 1024 * 1024
+	};
+
+	/**
+	 * Statistics about the use of the pool.
+	 */
+	struct Statistics {
+		/** The number of surfaces acquired. */
+		uint32 acquired;
+		/** The number of acquired surfaces which were reused from the pool. */
+		uint32 reused;
+		/** The number of released surfaces which were freed instead of being reused. */
+		uint32 discarded;
+		/** The number of bytes currently retained by the pool. */
+		uint32 retainedBytes;
+		/** The highest number of bytes retained by the pool. */
+		uint32 peakRetainedBytes;
+	};
+
+	SurfacePool(uint32 maxRetainedBytes = kDefaultMaxRetainedBytes);
+	~SurfacePool();
+
+	/**
+	 * Acquire a surface, which is reused from the pool if possible, and
+	 * created otherwise. The contents of a reused surface are undefined.
+	 * The surface has to be returned with release().
+	 */
+	Surface *acquire(uint16 width, uint16 height, uint8 bytesPerPixel);
+
+	/**
+	 * Return a surface acquired with acquire() to the pool. Passing 0 is
+	 * allowed, and does nothing.
+	 */
+	void release(Surface *surface);
+
+	/**
+	 * Set the maximal number of bytes of pixel data retained by the pool,
+	 * and free the surfaces exceeding it. 0 disables the pool.
+	 */
+	void setMaxRetainedBytes(uint32 bytes);
+	uint32 getMaxRetainedBytes() const { return _maxRetainedBytes; }
+
+	/** Free all surfaces retained by the pool. */
+	void clear();
+
+	const Statistics &getStatistics() const { return _stats; }
+
+private:
+	void trim(uint32 maxBytes);
+
+	/** The retained surfaces, the most recently released first. */
+	Common::List<Surface *> _surfaces;
+	uint32 _maxRetainedBytes;
+	Statistics _stats;
+};
+
+/**
+ * A thread safe SurfacePool shared by all video decoders. It is destroyed
+ * after each engine exits, and its size can be set in KB with the
+ * "video_pool_size" config key, also per game.
+ *
+ * The instance is created on first use, which hence must not happen in
+ * several threads at once; and it requires g_system to be available.
+ */
+class SharedSurfacePool : public Common::Singleton<SharedSurfacePool> {
+public:
+	Surface *acquire(uint16 width, uint16 height, uint8 bytesPerPixel);
+	void release(Surface *surface);
+	void clear();
+	void getStatistics(SurfacePool::Statistics &stats);
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	SharedSurfacePool();
+
+	Common::Mutex _mutex;
+	SurfacePool _pool;
+};
+
+} // End of namespace Graphics
+
+/** Shortcut for accessing the shared surface pool. */
+#define SurfacePoolMan	(::Graphics::SharedSurfacePool::instance())
+
+#endif
@@ -0,0 +1,332 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#include "graphics/video/async_decoder.h"
+
+#include "common/array.h"
+#include "common/debug.h"
+#include "common/singleton.h"
+#include "common/system.h"
+#include "common/timer.h"
+#include "common/util.h"
+
+#include "graphics/surface.h"
+#include "graphics/surfacepool.h"
+
+namespace Graphics {
+
+/**
+ * Decodes ahead for all playing AsyncVideoDecoders from a single timer
+ * proc. Every tick decodes at most one frame, for the decoders in turn.
+ */
+class AsyncDecodeScheduler : public Common::Singleton<AsyncDecodeScheduler> {
+public:
+	void add(AsyncVideoDecoder *decoder);
+	void remove(AsyncVideoDecoder *decoder);
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	AsyncDecodeScheduler() : _next(0), _timerInstalled(false) {}
+
+	enum {
+		/** The interval of the timer proc in microseconds. */
+		kDecodeInterval = 10000
+	};
+
+	static void decodeTimerProc(void *refCon);
+	void decodeAhead();
+
+	/** Guards _decoders and _next. Held while a frame is decoded. */
+	Common::Mutex _mutex;
+	Common::Array<AsyncVideoDecoder *> _decoders;
+	uint _next;
+
+	/** Only accessed by the main thread. */
+	bool _timerInstalled;
+};
+
+} // End of namespace Graphics
+
+DECLARE_SINGLETON(Graphics::AsyncDecodeScheduler);
+
+namespace Graphics {
+
+void AsyncDecodeScheduler::add(AsyncVideoDecoder *decoder) {
+	{
+		Common::StackLock lock(_mutex);
+		_decoders.push_back(decoder);
+	}
+
+	if (!_timerInstalled)
+		_timerInstalled = g_system->getTimerManager()->installTimerProc(&decodeTimerProc, kDecodeInterval, this);
+}
+
+void AsyncDecodeScheduler::remove(AsyncVideoDecoder *decoder) {
+	bool empty;
+	{
+		// Also waits for a frame the timer proc is decoding for it
+		Common::StackLock lock(_mutex);
+		for (uint i = 0; i < _decoders.size(); i++) {
+			if (_decoders[i] == decoder) {
+				_decoders.remove_at(i);
+				break;
+			}
+		}
+		empty = _decoders.empty();
+	}
+
+	// Note: The timer must not be removed while holding the mutex, since
+	// the timer proc may be waiting for it.
+	if (empty && _timerInstalled) {
+		g_system->getTimerManager()->removeTimerProc(&decodeTimerProc);
+		_timerInstalled = false;
+	}
+}
+
+void AsyncDecodeScheduler::decodeAhead() {
+	Common::StackLock lock(_mutex);
+
+	// Decode a frame for the next decoder in turn with a free frame buffer
+	for (uint i = 0; i < _decoders.size(); i++) {
+		uint index = (_next + i) % _decoders.size();
+		if (_decoders[index]->decodeAhead()) {
+			_next = index + 1;
+			return;
+		}
+	}
+}
+
+void AsyncDecodeScheduler::decodeTimerProc(void *refCon) {
+	((AsyncDecodeScheduler *)refCon)->decodeAhead();
+}
+
+AsyncVideoDecoder::AsyncVideoDecoder(VideoDecoder *decoder, uint numFrames, DisposeAfterUse::Flag disposeDecoder)
+	: _decoder(decoder), _disposeDecoder(disposeDecoder), _frames(0), _numFrames(MAX<uint>(numFrames, 1)),
+	  _decodingAhead(false) {
+	assert(_decoder);
+	_videoFrameBuffer = 0;
+	_videoFrameSurface = 0;
+}
+
+AsyncVideoDecoder::~AsyncVideoDecoder() {
+	closeFile();
+
+	if (_disposeDecoder == DisposeAfterUse::YES)
+		delete _decoder;
+}
+
+bool AsyncVideoDecoder::loadFile(const char *filename) {
+	closeFile();
+
+	if (!_decoder->loadFile(filename))
+		return false;
+
+	_videoInfo.width = _decoder->getWidth();
+	_videoInfo.height = _decoder->getHeight();
+	_videoInfo.frameCount = _decoder->getFrameCount();
+	_videoInfo.frameRate = _decoder->getFrameRate();
+	_videoInfo.frameDelay = _decoder->getFrameDelay();
+	_videoInfo.firstframeOffset = 0;
+	_videoInfo.currentFrame = 0;
+	_videoInfo.startTime = 0;
+
+	// The stream belongs to the wrapped decoder, it only tells the
+	// VideoDecoder methods that a video is loaded.
+	_fileStream = _decoder->_fileStream;
+
+	_frames = new Frame[_numFrames];
+	for (uint i = 0; i < _numFrames; i++) {
+		_frames[i].surface = SurfacePoolMan.acquire(_videoInfo.width, _videoInfo.height, 1);
+		_frames[i].hasPalette = false;
+	}
+
+	_videoFrameSurface = SurfacePoolMan.acquire(_videoInfo.width, _videoInfo.height, 1);
+	_videoFrameBuffer = (byte *)_videoFrameSurface->pixels;
+	memset(_videoFrameBuffer, 0, _videoInfo.width * _videoInfo.height);
+
+	_firstQueued = _numQueued = 0;
+	_numDecoded = 0;
+	_audioTime = 0;
+	_audioTimeMillis = 0;
+	memset(&_stats, 0, sizeof(_stats));
+
+	return true;
+}
+
+void AsyncVideoDecoder::closeFile() {
+	if (!_fileStream)
+		return;
+
+	stopDecodeAhead();
+
+	debug(2, "AsyncVideoDecoder: %d frames shown, %d late, %d not decoded ahead, up to %d decoded ahead",
+		_stats.frames, _stats.lateFrames, _stats.starvedFrames, _stats.maxQueuedFrames);
+
+	_decoder->closeFile();
+	_fileStream = 0;
+
+	for (uint i = 0; i < _numFrames; i++)
+		SurfacePoolMan.release(_frames[i].surface);
+	delete[] _frames;
+	_frames = 0;
+
+	SurfacePoolMan.release(_videoFrameSurface);
+	_videoFrameSurface = 0;
+	_videoFrameBuffer = 0;
+}
+
+int32 AsyncVideoDecoder::getAudioLag() {
+	if (!_fileStream)
+		return 0;
+
+	Common::StackLock lock(_queueMutex);
+
+	if (!_numDecoded)
+		return 0;
+
+	int32 audioTime = _audioTime + (g_system->getMillis() - _audioTimeMillis) * 100;
+	int32 videoTime = _videoInfo.currentFrame * _videoInfo.frameDelay;
+
+	return videoTime - audioTime;
+}
+
+bool AsyncVideoDecoder::decodeNextFrame() {
+	if (!_fileStream)
+		return false;
+
+	// Decoding ahead only starts with the first frame, so that the audio
+	// of the wrapped decoder does not start before the video is shown.
+	startDecodeAhead();
+
+	bool starved;
+	{
+		Common::StackLock lock(_queueMutex);
+		starved = !_numQueued && _numDecoded < _videoInfo.frameCount;
+	}
+
+	if (starved) {
+		// The first frame is never decoded ahead
+		if (_videoInfo.currentFrame)
+			_stats.starvedFrames++;
+		decodeAhead();
+	}
+
+	byte palette[256 * 3];
+	bool hasPalette;
+	{
+		Common::StackLock lock(_queueMutex);
+
+		if (!_numQueued)
+			return false;
+
+		// Swap the buffer of the frame with the one shown so far, which
+		// is then reused for decoding ahead.
+		Frame &frame = _frames[_firstQueued];
+		SWAP(frame.surface, _videoFrameSurface);
+		_videoFrameBuffer = (byte *)_videoFrameSurface->pixels;
+
+		hasPalette = frame.hasPalette;
+		if (hasPalette)
+			memcpy(palette, frame.palette, sizeof(palette));
+
+		_firstQueued = (_firstQueued + 1) % _numFrames;
+		_numQueued--;
+	}
+
+	if (hasPalette)
+		setPalette(palette);
+
+	_videoInfo.currentFrame++;
+	_stats.frames++;
+
+	if (getAudioLag() < -_videoInfo.frameDelay)
+		_stats.lateFrames++;
+
+	return _videoInfo.currentFrame < _videoInfo.frameCount;
+}
+
+/**
+ * Decode the next frame of the wrapped decoder into a free frame buffer.
+ * Called by the AsyncDecodeScheduler, and by decodeNextFrame() if no frame has been
+ * decoded ahead.
+ * @return true if a frame was decoded, false if there was no free frame
+ *         buffer or the video has ended
+ */
+bool AsyncVideoDecoder::decodeAhead() {
+	Common::StackLock decodeLock(_decodeMutex);
+
+	Frame *frame;
+	{
+		Common::StackLock lock(_queueMutex);
+
+		if (_numQueued == _numFrames || _numDecoded >= _videoInfo.frameCount)
+			return false;
+
+		// Frames which are not queued are not accessed by the main thread
+		frame = &_frames[(_firstQueued + _numQueued) % _numFrames];
+	}
+
+	_decoder->_paletteCapture = frame->palette;
+	_decoder->_paletteCaptured = false;
+
+	_decoder->decodeNextFrame();
+	_decoder->copyFrameToBuffer((byte *)frame->surface->pixels, 0, 0, _videoInfo.width);
+
+	frame->hasPalette = _decoder->_paletteCaptured;
+	_decoder->_paletteCapture = 0;
+
+	int32 audioTime = _decoder->getCurFrame() * _videoInfo.frameDelay - _decoder->getAudioLag();
+	uint32 now = g_system->getMillis();
+
+	Common::StackLock lock(_queueMutex);
+
+	_numDecoded++;
+	_numQueued++;
+	_stats.maxQueuedFrames = MAX<uint32>(_stats.maxQueuedFrames, _numQueued);
+
+	_audioTime = audioTime;
+	_audioTimeMillis = now;
+
+	return true;
+}
+
+void AsyncVideoDecoder::startDecodeAhead() {
+	if (_decodingAhead)
+		return;
+
+	AsyncDecodeScheduler::instance().add(this);
+	_decodingAhead = true;
+}
+
+void AsyncVideoDecoder::stopDecodeAhead() {
+	// Must not be called while holding one of the mutexes, since the
+	// scheduler may be decoding a frame and waiting for them.
+	if (_decodingAhead) {
+		AsyncDecodeScheduler::instance().remove(this);
+		_decodingAhead = false;
+	}
+}
+
+} // End of namespace Graphics
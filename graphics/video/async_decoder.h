@@ -0,0 +1,142 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#ifndef GRAPHICS_VIDEO_ASYNC_DECODER_H
+#define GRAPHICS_VIDEO_ASYNC_DECODER_H
+
+#include "common/mutex.h"
+#include "common/types.h"
+
+#include "graphics/video/video_player.h"
+
+namespace Graphics {
+
+class AsyncDecodeScheduler;
+struct Surface;
+
+/**
+ * A video decoder which decodes the frames of another decoder ahead of
+ * time, so that decoding happens in the background instead of when a
+ * frame is due.
+ *
+ * Frames are decoded by a timer proc into a fixed number of recycled
+ * frame buffers, together with their palette changes, which are applied
+ * when the frame is shown. If no frame has been decoded ahead when one
+ * is due, it is decoded synchronously.
+ *
+ * Since it is a VideoDecoder itself, engines can opt in by wrapping their
+ * decoder, e.g.
+ *
+ *   new VideoPlayer(new AsyncVideoDecoder(new SmackerDecoder(mixer)))
+ *
+ * The frames of all playing AsyncVideoDecoders are decoded by a single
+ * timer proc, one frame per timer tick, taking turns. The timer thread is
+ * shared with the sound of the engines, so a frame which takes long to
+ * decode still delays it; it is only bounded to one frame per tick.
+ *
+ * The wrapped decoder must only be accessed through the wrapper. Decoders
+ * which override setPalette(), like the AGOS and HE movie players, can't
+ * be wrapped, since the palette is captured before it reaches them.
+ */
+class AsyncVideoDecoder : public VideoDecoder {
+public:
+	/**
+	 * Statistics about the playback of the current video.
+	 */
+	struct Statistics {
+		/** The number of frames shown. */
+		uint32 frames;
+		/** The number of frames shown more than a frame delay too late. */
+		uint32 lateFrames;
+		/** The number of frames which had not been decoded ahead. */
+		uint32 starvedFrames;
+		/** The highest number of frames decoded ahead. */
+		uint32 maxQueuedFrames;
+	};
+
+	/**
+	 * @param decoder		the decoder to wrap
+	 * @param numFrames		the maximal number of frames decoded ahead
+	 * @param disposeDecoder	whether to delete the decoder with the wrapper
+	 */
+	AsyncVideoDecoder(VideoDecoder *decoder, uint numFrames = 4,
+			DisposeAfterUse::Flag disposeDecoder = DisposeAfterUse::YES);
+	virtual ~AsyncVideoDecoder();
+
+	int32 getAudioLag();
+
+	bool loadFile(const char *filename);
+	void closeFile();
+
+	bool decodeNextFrame();
+
+	const Statistics &getStatistics() const { return _stats; }
+
+private:
+	struct Frame {
+		Surface *surface;
+		byte palette[256 * 3];
+		bool hasPalette;
+	};
+
+	friend class AsyncDecodeScheduler;
+
+	bool decodeAhead();
+	void startDecodeAhead();
+	void stopDecodeAhead();
+
+	VideoDecoder *_decoder;
+	DisposeAfterUse::Flag _disposeDecoder;
+
+	/** Guards _decoder. Held while a frame is decoded. */
+	Common::Mutex _decodeMutex;
+
+	/** Guards the frame queue and the audio clock below. */
+	Common::Mutex _queueMutex;
+	Frame *_frames;
+	uint _numFrames;
+	uint _firstQueued;
+	uint _numQueued;
+	uint32 _numDecoded;
+
+	/** The surface holding _videoFrameBuffer. */
+	Surface *_videoFrameSurface;
+
+	/**
+	 * The audio clock of the wrapped decoder (in 1/100 ms), as sampled at
+	 * _audioTimeMillis. The audio time at any other moment is extrapolated
+	 * from it, so that getAudioLag() does not have to wait for a frame to
+	 * be decoded.
+	 */
+	int32 _audioTime;
+	uint32 _audioTimeMillis;
+
+	bool _decodingAhead;
+	Statistics _stats;
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -33,6 +33,7 @@
 #include "sound/mixer.h"
 #include "sound/decoders/raw.h"
 
+#include "graphics/surfacepool.h"
 #include "graphics/video/avi_decoder.h"
 
 // Codecs
@@ -48,6 +49,7 @@ AviDecoder::AviDecoder(Audio::Mixer *mixer, Audio::Mixer::SoundType soundType) :
 	_decodedHeader = false;
 	_audStream = NULL;
 	_fileStream = NULL;
+	_frameSurface = NULL;
 	_audHandle = new Audio::SoundHandle();
 	memset(_palette, 0, sizeof(_palette));
 	memset(&_wvInfo, 0, sizeof(PCMWAVEFORMAT));
@@ -220,7 +222,8 @@ bool AviDecoder::loadFile(const char *fileName) {
 	while (!_decodedHeader)
 		runHandle(_fileStream->readUint32BE());
 
-	_videoFrameBuffer = new byte[_header.width * _header.height];
+	_frameSurface = SurfacePoolMan.acquire(_header.width, _header.height, 1);
+	_videoFrameBuffer = (byte *)_frameSurface->pixels;
 	memset(_videoFrameBuffer, 0, _header.width * _header.height);
 
 	uint32 nextTag = _fileStream->readUint32BE();
@@ -273,7 +276,8 @@ void AviDecoder::closeFile() {
 	delete _fileStream;
 	_fileStream = 0;
 
-	delete[] _videoFrameBuffer;
+	SurfacePoolMan.release(_frameSurface);
+	_frameSurface = 0;
 	_videoFrameBuffer = 0;
 
 	// Deinitialize sound
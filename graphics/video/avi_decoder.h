@@ -202,6 +202,7 @@ private:
 	AVIStreamHeader _vidsHeader;
 	AVIStreamHeader _audsHeader;
 	byte _palette[3 * 256];
+	Surface *_frameSurface; // holds _videoFrameBuffer, from the surface pool
 
 	bool _decodedHeader;
 
@@ -26,18 +26,18 @@
 // Based off ffmpeg's msrledec.c
 
 #include "graphics/video/codecs/msrle.h"
+#include "graphics/surfacepool.h"
 
 namespace Graphics {
 
 MSRLEDecoder::MSRLEDecoder(uint16 width, uint16 height, byte bitsPerPixel) {
-	_surface = new Graphics::Surface();
-	_surface->create(width, height, 1);
+	_surface = SurfacePoolMan.acquire(width, height, 1);
+	memset(_surface->pixels, 0, _surface->pitch * _surface->h);
 	_bitsPerPixel = bitsPerPixel;
 }
 
 MSRLEDecoder::~MSRLEDecoder() {
-	_surface->free();
-	delete _surface;
+	SurfacePoolMan.release(_surface);
 }
 
 Surface *MSRLEDecoder::decodeImage(Common::SeekableReadStream *stream) {
@@ -26,6 +26,7 @@
  // Based off ffmpeg's msvideo.cpp
 
 #include "graphics/video/codecs/msvideo1.h"
+#include "graphics/surfacepool.h"
 
 namespace Graphics {
 
@@ -36,14 +37,13 @@ namespace Graphics {
   }
 
 MSVideo1Decoder::MSVideo1Decoder(uint16 width, uint16 height, byte bitsPerPixel) : Codec() {
-	_surface = new Graphics::Surface();
-	_surface->create(width, height, (bitsPerPixel == 8) ? 1 : 2);
+	_surface = SurfacePoolMan.acquire(width, height, (bitsPerPixel == 8) ? 1 : 2);
+	memset(_surface->pixels, 0, _surface->pitch * _surface->h);
 	_bitsPerPixel = bitsPerPixel;
 }
 
 MSVideo1Decoder::~MSVideo1Decoder() {
-	_surface->free();
-	delete _surface;
+	SurfacePoolMan.release(_surface);
 }
 
 void MSVideo1Decoder::decode8(Common::SeekableReadStream *stream) {
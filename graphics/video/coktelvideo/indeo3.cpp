@@ -61,6 +61,7 @@ Indeo3::~Indeo3() {
 	delete[] _iv_frame[0].the_buf;
 	delete[] _ModPred;
 	delete[] _corrector_type;
+	delete[] _blitBuf;
 	delete _ditherSL;
 }
 
@@ -182,6 +183,8 @@ void Indeo3::allocFrames() {
 		_iv_frame[1].Vbuf[-i] = 0x80;
 		_iv_frame[1].Vbuf[chroma_pixels+i-1] = 0x80;
 	}
+
+	_blitBuf = new byte[luma_width * 3];
 }
 
 bool Indeo3::decompressFrame(byte *inData, uint32 dataLen,
@@ -282,6 +285,9 @@ bool Indeo3::decompressFrame(byte *inData, uint32 dataLen,
 	blitState.bufU          = _cur_frame->Ubuf;
 	blitState.bufV          = _cur_frame->Vbuf;
 	blitState.bufOut        = outData;
+	blitState.lineY         = _blitBuf;
+	blitState.lineU         = _blitBuf + blitState.widthY;
+	blitState.lineV         = _blitBuf + blitState.widthY * 2;
 
 	blitFrame(blitState);
 
@@ -293,27 +299,61 @@ void Indeo3::blitFrame(BlitState &s) {
 		_ditherSL->newFrame();
 
 	for (s.curY = 0; s.curY < s.uheightOut; s.curY++) {
+		// The chroma planes have a quarter of the resolution in both
+		// directions, so one chroma line is used for four lines
+		if ((s.curY & 3) == 0)
+			scaleLineUV(s);
+		scaleLineY(s);
+
 		if (_dither == kDitherNone)
 			blitLine(s);
 		else
 			blitLineDither(s);
+
+		s.bufY += s.uwidthOut;
 	}
 }
 
-void Indeo3::blitLine(BlitState &s) {
-	byte *lineU = s.bufU + (s.curY >> 2) * s.uwidthUV;
-	byte *lineV = s.bufV + (s.curY >> 2) * s.uwidthUV;
+// The blitters look up all three components of an output pixel with the same
+// index, so the current lines are first scaled to the output width.
 
-	for (s.curX = 0; s.curX < s.uwidthOut; s.curX++) {
-		byte dataY = *s.bufY++;
-		byte dataU = lineU[s.curX >> 2];
-		byte dataV = lineV[s.curX >> 2];
+void Indeo3::scaleLineY(BlitState &s) {
+	if (s.scaleWYOut == 1) {
+		s.lineY = s.bufY;
+		return;
+	}
+
+	s.lineY = _blitBuf;
 
+	byte *dest = s.lineY;
+	for (s.curX = 0; s.curX < s.uwidthOut; s.curX++)
 		for (int n = 0; n < s.scaleWYOut; n++)
-			*s.bufOut++ = _palLUT->findNearest(dataY, dataU, dataV);
+			*dest++ = s.bufY[s.curX];
+}
+
+void Indeo3::scaleLineUV(BlitState &s) {
+	const byte *srcU = s.bufU + (s.curY >> 2) * s.uwidthUV;
+	const byte *srcV = s.bufV + (s.curY >> 2) * s.uwidthUV;
+	byte *destU = s.lineU;
+	byte *destV = s.lineV;
+
+	for (s.curX = 0; s.curX < s.uwidthOut; s.curX++) {
+		byte dataU = srcU[s.curX >> 2];
+		byte dataV = srcV[s.curX >> 2];
+
+		for (int n = 0; n < s.scaleWYOut; n++) {
+			*destU++ = dataU;
+			*destV++ = dataV;
+		}
 	}
+}
 
-	byte *lineDest = s.bufOut - s.lineWidthOut;
+void Indeo3::blitLine(BlitState &s) {
+	for (uint32 x = 0; x < s.lineWidthOut; x++)
+		s.bufOut[x] = _palLUT->findNearest(s.lineY[x], s.lineU[x], s.lineV[x]);
+
+	byte *lineDest = s.bufOut;
+	s.bufOut += s.lineWidthOut;
 	for (int n = 1; n < s.scaleHYOut; n++) {
 		memcpy(s.bufOut, lineDest, s.lineWidthOut);
 		s.bufOut += s.lineWidthOut;
@@ -321,26 +361,12 @@ void Indeo3::blitLine(BlitState &s) {
 }
 
 void Indeo3::blitLineDither(BlitState &s) {
-	byte *lineU = s.bufU + (s.curY >> 2) * s.uwidthUV;
-	byte *lineV = s.bufV + (s.curY >> 2) * s.uwidthUV;
-
 	for (uint16 i = 0; i < s.scaleHYOut; i++) {
-		byte *bufY = s.bufY;
-
-		for (s.curX = 0; s.curX < s.uwidthOut; s.curX++) {
-			byte dataY = *bufY++;
-			byte dataU = lineU[s.curX >> 2];
-			byte dataV = lineV[s.curX >> 2];
-
-			for (int n = 0; n < s.scaleWYOut; n++)
-				*s.bufOut++ = _ditherSL->dither(dataY, dataU, dataV, s.curX * s.scaleWYOut + n);
-
-		}
+		_ditherSL->ditherLine(s.bufOut, s.lineY, s.lineU, s.lineV, s.lineWidthOut);
+		s.bufOut += s.lineWidthOut;
 
 		_ditherSL->nextLine();
 	}
-
-	s.bufY += s.uwidthOut;
 }
 
 typedef struct {
@@ -501,11 +527,12 @@ void Indeo3::decodeChunk(byte *cur, byte *ref, int width, int height,
 			cmd = (bit_buf >> bit_pos) & 0x03;
 
 			if (cmd == 0 || ref_vectors != NULL) {
-				for (lp1 = 0; lp1 < blks_width; lp1++) {
-					for (i = 0, j = 0; i < blks_height; i++, j += width_tbl[1])
-						((uint32 *)cur_frm_pos)[j] = ((uint32 *)ref_frm_pos)[j];
-					cur_frm_pos += 4;
-					ref_frm_pos += 4;
+				// Copy the cell line by line. Without a motion vector, the
+				// line above is copied down, which is then already filled.
+				for (i = 0; i < blks_height; i++) {
+					memmove(cur_frm_pos, ref_frm_pos, blks_width << 2);
+					cur_frm_pos += width_tbl[1] << 2;
+					ref_frm_pos += width_tbl[1] << 2;
 				}
 			} else if (cmd != 1)
 				return;
@@ -89,6 +89,9 @@ private:
 	byte *_ModPred;
 	uint16 *_corrector_type;
 
+	/** Buffer for three lines of Y, U and V values in output resolution. */
+	byte *_blitBuf;
+
 	Graphics::PaletteLUT *_palLUT;
 
 	DitherAlgorithm _dither;
@@ -104,6 +107,7 @@ private:
 		uint16 scaleHYUV, scaleHYOut;
 		uint16 lineWidthOut, lineHeightOut;
 		byte *bufY, *bufU, *bufV, *bufOut;
+		byte *lineY, *lineU, *lineV;
 	};
 
 	void buildModPred();
@@ -115,6 +119,8 @@ private:
 
 	void blitFrame(BlitState &s);
 
+	void scaleLineY(BlitState &s);
+	void scaleLineUV(BlitState &s);
 	void blitLine(BlitState &s);
 	void blitLineDither(BlitState &s);
 };
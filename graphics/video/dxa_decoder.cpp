@@ -29,6 +29,8 @@
 #include "common/system.h"
 #include "common/util.h"
 
+#include "graphics/surface.h"
+#include "graphics/surfacepool.h"
 #include "graphics/video/dxa_decoder.h"
 
 #ifdef USE_ZLIB
@@ -42,7 +44,7 @@ DXADecoder::DXADecoder() {
 
 	_frameBuffer1 = 0;
 	_frameBuffer2 = 0;
-	_scaledBuffer = 0;
+	_frameSurfaces[0] = _frameSurfaces[1] = 0;
 	_videoFrameBuffer = 0;
 
 	_inBuffer = 0;
@@ -113,20 +115,14 @@ bool DXADecoder::loadFile(const char *fileName) {
 
 	_frameSize = _videoInfo.width * _videoInfo.height;
 	_decompBufferSize = _frameSize;
-	_frameBuffer1 = (uint8 *)malloc(_frameSize);
+	_frameSurfaces[0] = SurfacePoolMan.acquire(_videoInfo.width, _videoInfo.height, 1);
+	_frameSurfaces[1] = SurfacePoolMan.acquire(_videoInfo.width, _videoInfo.height, 1);
+	_frameBuffer1 = (byte *)_frameSurfaces[0]->pixels;
 	memset(_frameBuffer1, 0, _frameSize);
-	_frameBuffer2 = (uint8 *)malloc(_frameSize);
+	_frameBuffer2 = (byte *)_frameSurfaces[1]->pixels;
 	memset(_frameBuffer2, 0, _frameSize);
-	if (!_frameBuffer1 || !_frameBuffer2)
-		error("DXADecoder: Error allocating frame buffers (size %u)", _frameSize);
-
-	_scaledBuffer = 0;
-	if (_scaleMode != S_NONE) {
-		_scaledBuffer = (uint8 *)malloc(_frameSize);
-		memset(_scaledBuffer, 0, _frameSize);
-		if (!_scaledBuffer)
-			error("Error allocating scale buffer (size %u)", _frameSize);
-	}
+
+	_videoFrameBuffer = _frameBuffer1;
 
 #ifdef DXA_EXPERIMENT_MAXD
 	// Check for an extended header
@@ -173,9 +169,11 @@ void DXADecoder::closeFile() {
 	delete _fileStream;
 	_fileStream = 0;
 
-	free(_frameBuffer1);
-	free(_frameBuffer2);
-	free(_scaledBuffer);
+	SurfacePoolMan.release(_frameSurfaces[0]);
+	SurfacePoolMan.release(_frameSurfaces[1]);
+	_frameSurfaces[0] = _frameSurfaces[1] = 0;
+	_frameBuffer1 = _frameBuffer2 = 0;
+	_videoFrameBuffer = 0;
 	free(_inBuffer);
 	free(_decompBuffer);
 
@@ -193,6 +191,15 @@ void DXADecoder::decodeZlib(byte *data, int size, int totalSize) {
 #define BLOCKW 4
 #define BLOCKH 4
 
+// Copy an unchanged block from the previous frame
+static inline void copyBlock(byte *dst, const byte *src, int w, int h, int pitch) {
+	for (int yc = 0; yc < h; yc++) {
+		memcpy(dst, src, w);
+		src += pitch;
+		dst += pitch;
+	}
+}
+
 void DXADecoder::decode12(int size) {
 #ifdef USE_ZLIB
 	if (_decompBuffer == NULL) {
@@ -206,15 +213,18 @@ void DXADecoder::decode12(int size) {
 
 	byte *dat = _decompBuffer;
 
-	memcpy(_frameBuffer2, _frameBuffer1, _frameSize);
-
+	// The frame is decoded into _frameBuffer2, _frameBuffer1 holds the
+	// previous one.
 	for (uint32 by = 0; by < _videoInfo.height; by += BLOCKH) {
 		for (uint32 bx = 0; bx < _videoInfo.width; bx += BLOCKW) {
 			byte type = *dat++;
-			byte *b2 = _frameBuffer1 + bx + by * _videoInfo.width;
+			byte *b2 = _frameBuffer2 + bx + by * _videoInfo.width;
+			const byte *prev = _frameBuffer1 + bx + by * _videoInfo.width;
 
 			switch (type) {
 			case 0:
+			case 5:
+				copyBlock(b2, prev, BLOCKW, BLOCKH, _videoInfo.width);
 				break;
 			case 10:
 			case 11:
@@ -236,6 +246,8 @@ void DXADecoder::decode12(int size) {
 					dat += 2;
 				}
 
+				copyBlock(b2, prev, BLOCKW, BLOCKH, _videoInfo.width);
+
 				for (int yc = 0; yc < BLOCKH; yc++) {
 					for (int xc = 0; xc < BLOCKW; xc++) {
 						if (diffMap & 0x8000) {
@@ -275,16 +287,10 @@ void DXADecoder::decode12(int size) {
 				int my = mbyte & 0x07;
 				if (mbyte & 0x08)
 					my = -my;
-				byte *b1 = _frameBuffer2 + (bx+mx) + (by+my) * _videoInfo.width;
-				for (int yc = 0; yc < BLOCKH; yc++) {
-					memcpy(b2, b1, BLOCKW);
-					b1 += _videoInfo.width;
-					b2 += _videoInfo.width;
-				}
+				byte *b1 = _frameBuffer1 + (bx+mx) + (by+my) * _videoInfo.width;
+				copyBlock(b2, b1, BLOCKW, BLOCKH, _videoInfo.width);
 				break;
 			}
-			case 5:
-				break;
 			default:
 				error("decode12: Unknown type %d", type);
 			}
@@ -307,8 +313,6 @@ void DXADecoder::decode13(int size) {
 	/* decompress the input data */
 	decodeZlib(_decompBuffer, size, _decompBufferSize);
 
-	memcpy(_frameBuffer2, _frameBuffer1, _frameSize);
-
 	int codeSize = _videoInfo.width * _curHeight / 16;
 	int dataSize, motSize, maskSize;
 
@@ -321,19 +325,25 @@ void DXADecoder::decode13(int size) {
 	motBuf = &dataBuf[dataSize];
 	maskBuf = &motBuf[motSize];
 
+	// The frame is decoded into _frameBuffer2, _frameBuffer1 holds the
+	// previous one.
 	for (uint32 by = 0; by < _curHeight; by += BLOCKH) {
 		for (uint32 bx = 0; bx < _videoInfo.width; bx += BLOCKW) {
 			uint8 type = *codeBuf++;
-			uint8 *b2 = (uint8*)_frameBuffer1 + bx + by * _videoInfo.width;
+			uint8 *b2 = (uint8*)_frameBuffer2 + bx + by * _videoInfo.width;
+			const uint8 *prev = (uint8*)_frameBuffer1 + bx + by * _videoInfo.width;
 
 			switch (type) {
 			case 0:
+				copyBlock(b2, prev, BLOCKW, BLOCKH, _videoInfo.width);
 				break;
 
 			case 1: {
 				uint16 diffMap = READ_BE_UINT16(maskBuf);
 				maskBuf += 2;
 
+				copyBlock(b2, prev, BLOCKW, BLOCKH, _videoInfo.width);
+
 				for (int yc = 0; yc < BLOCKH; yc++) {
 					for (int xc = 0; xc < BLOCKW; xc++) {
 						if (diffMap & 0x8000) {
@@ -375,12 +385,8 @@ void DXADecoder::decode13(int size) {
 				if (mbyte & 0x08)
 					my = -my;
 
-				uint8 *b1 = (uint8*)_frameBuffer2 + (bx+mx) + (by+my) * _videoInfo.width;
-				for (int yc = 0; yc < BLOCKH; yc++) {
-					memcpy(b2, b1, BLOCKW);
-					b1 += _videoInfo.width;
-					b2 += _videoInfo.width;
-				}
+				uint8 *b1 = (uint8*)_frameBuffer1 + (bx+mx) + (by+my) * _videoInfo.width;
+				copyBlock(b2, b1, BLOCKW, BLOCKH, _videoInfo.width);
 				break;
 			}
 			case 8: {
@@ -391,10 +397,11 @@ void DXADecoder::decode13(int size) {
 
 				for (int subBlock = 0; subBlock < 4; subBlock++) {
 					int sx = bx + subX[subBlock], sy = by + subY[subBlock];
-					b2 = (uint8*)_frameBuffer1 + sx + sy * _videoInfo.width;
+					b2 = (uint8*)_frameBuffer2 + sx + sy * _videoInfo.width;
 					switch (subMask & 0xC0) {
 					// 00: skip
 					case 0x00:
+						copyBlock(b2, (uint8*)_frameBuffer1 + sx + sy * _videoInfo.width, BLOCKW / 2, BLOCKH / 2, _videoInfo.width);
 						break;
 					// 01: solid color
 					case 0x40: {
@@ -419,12 +426,8 @@ void DXADecoder::decode13(int size) {
 						if (mbyte & 0x08)
 							my = -my;
 
-						uint8 *b1 = (uint8*)_frameBuffer2 + (sx+mx) + (sy+my) * _videoInfo.width;
-						for (int yc = 0; yc < BLOCKH / 2; yc++) {
-							memcpy(b2, b1, BLOCKW / 2);
-							b1 += _videoInfo.width;
-							b2 += _videoInfo.width;
-						}
+						uint8 *b1 = (uint8*)_frameBuffer1 + (sx+mx) + (sy+my) * _videoInfo.width;
+						copyBlock(b2, b1, BLOCKW / 2, BLOCKH / 2, _videoInfo.width);
 						break;
 					}
 					// 03: raw
@@ -510,12 +513,16 @@ bool DXADecoder::decodeNextFrame() {
 
 		_fileStream->read(_inBuffer, size);
 
+		// All frame types are decoded into _frameBuffer2, which then
+		// becomes the current frame, instead of copying the previous one.
 		switch (type) {
 		case 2:
-			decodeZlib(_frameBuffer1, size, _frameSize);
+			decodeZlib(_frameBuffer2, size, _frameSize);
 			break;
 		case 3:
 			decodeZlib(_frameBuffer2, size, _frameSize);
+			for (uint32 offs = 0; offs < _curHeight * _videoInfo.width; ++offs)
+				_frameBuffer2[offs] ^= _frameBuffer1[offs];
 			break;
 		case 12:
 			decode12(size);
@@ -527,37 +534,52 @@ bool DXADecoder::decodeNextFrame() {
 			error("decodeFrame: Unknown compression type %d", type);
 		}
 
-		if (type == 3) {
-			for (uint32 j = 0; j < _curHeight; ++j) {
-				for (uint32 i = 0; i < _videoInfo.width; ++i) {
-					const int offs = j * _videoInfo.width + i;
-					_frameBuffer1[offs] ^= _frameBuffer2[offs];
-				}
-			}
-		}
+		SWAP(_frameBuffer1, _frameBuffer2);
 	}
 
+	// Scaled frames are only scaled when they are copied
+	_videoFrameBuffer = _frameBuffer1;
+
+	return ++_videoInfo.currentFrame < _videoInfo.frameCount;
+}
+
+byte DXADecoder::getPixel(int x, int y) {
+	// getPixel(offset) passes the offset as x
+	y += x / _videoInfo.width;
+	x %= _videoInfo.width;
+
 	switch (_scaleMode) {
 	case S_INTERLACED:
-		for (int cy = 0; cy < _curHeight; cy++) {
-			memcpy(&_scaledBuffer[2 * cy * _videoInfo.width], &_frameBuffer1[cy * _videoInfo.width], _videoInfo.width);
-			memset(&_scaledBuffer[((2 * cy) + 1) * _videoInfo.width], 0, _videoInfo.width);
-		}
-		_videoFrameBuffer = _scaledBuffer;
-		break;
+		return (y & 1) ? 0 : _frameBuffer1[(y / 2) * _videoInfo.width + x];
 	case S_DOUBLE:
-		for (int cy = 0; cy < _curHeight; cy++) {
-			memcpy(&_scaledBuffer[2 * cy * _videoInfo.width], &_frameBuffer1[cy * _videoInfo.width], _videoInfo.width);
-			memcpy(&_scaledBuffer[((2 * cy) + 1) * _videoInfo.width], &_frameBuffer1[cy * _videoInfo.width], _videoInfo.width);
-		}
-		_videoFrameBuffer = _scaledBuffer;
-		break;
-	case S_NONE:
-		_videoFrameBuffer = _frameBuffer1;
-		break;
+		return _frameBuffer1[(y / 2) * _videoInfo.width + x];
+	default:
+		return _frameBuffer1[y * _videoInfo.width + x];
 	}
+}
 
-	return ++_videoInfo.currentFrame < _videoInfo.frameCount;
+void DXADecoder::copyFrameToBuffer(byte *dst, uint x, uint y, uint pitch) {
+	if (_scaleMode == S_NONE) {
+		VideoDecoder::copyFrameToBuffer(dst, x, y, pitch);
+		return;
+	}
+
+	// Scale the frame while copying it, rather than into a separate buffer
+	const byte *src = _frameBuffer1;
+	dst += y * pitch + x;
+
+	for (uint cy = 0; cy < _curHeight; cy++) {
+		memcpy(dst, src, _videoInfo.width);
+		dst += pitch;
+
+		if (_scaleMode == S_INTERLACED)
+			memset(dst, 0, _videoInfo.width);
+		else
+			memcpy(dst, src, _videoInfo.width);
+		dst += pitch;
+
+		src += _videoInfo.width;
+	}
 }
 
 } // End of namespace Graphics
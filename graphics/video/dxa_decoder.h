@@ -30,6 +30,8 @@
 
 namespace Graphics {
 
+struct Surface;
+
 /**
  * Decoder for DXA videos.
  *
@@ -56,6 +58,9 @@ public:
 
 	bool decodeNextFrame();
 
+	byte getPixel(int x, int y);
+	void copyFrameToBuffer(byte *dst, uint x, uint y, uint pitch);
+
 	/**
 	 * Get the sound chunk tag of the loaded DXA file
 	 */
@@ -72,9 +77,12 @@ private:
 		S_DOUBLE
 	};
 
+	// The current and the previous frame, swapped after each decoded frame.
+	// Scaled videos are stored unscaled. Both are held by surfaces from the
+	// surface pool, which are not swapped.
 	byte *_frameBuffer1;
 	byte *_frameBuffer2;
-	byte *_scaledBuffer;
+	Surface *_frameSurfaces[2];
 	byte *_inBuffer;
 	uint32 _inBufferSize;
 	byte *_decompBuffer;
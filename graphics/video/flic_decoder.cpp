@@ -29,12 +29,16 @@
 #include "common/endian.h"
 #include "common/system.h"
 
+#include "graphics/surface.h"
+#include "graphics/surfacepool.h"
+
 namespace Graphics {
 
 FlicDecoder::FlicDecoder() {
 	_paletteChanged = false;
 	_fileStream = 0;
 	_videoFrameBuffer = 0;
+	_frameSurface = 0;
 	memset(&_videoInfo, 0, sizeof(_videoInfo));
 }
 
@@ -80,7 +84,8 @@ bool FlicDecoder::loadFile(const char *fileName) {
 	_offsetFrame1 = _fileStream->readUint32LE();
 	_offsetFrame2 = _fileStream->readUint32LE();
 
-	_videoFrameBuffer = new byte[_videoInfo.width * _videoInfo.height];
+	_frameSurface = SurfacePoolMan.acquire(_videoInfo.width, _videoInfo.height, 1);
+	_videoFrameBuffer = (byte *)_frameSurface->pixels;
 	_palette = (byte *)malloc(3 * 256);
 	memset(_palette, 0, 3 * 256);
 	_paletteChanged = false;
@@ -98,7 +103,8 @@ void FlicDecoder::closeFile() {
 	delete _fileStream;
 	_fileStream = 0;
 
-	delete[] _videoFrameBuffer;
+	SurfacePoolMan.release(_frameSurface);
+	_frameSurface = 0;
 	_videoFrameBuffer = 0;
 
 	free(_palette);
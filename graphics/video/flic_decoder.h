@@ -36,6 +36,8 @@ namespace Common {
 
 namespace Graphics {
 
+struct Surface;
+
 /**
  *
  * Decoder for FLIC videos.
@@ -74,6 +76,7 @@ public:
 private:
 	uint16 _offsetFrame1;
 	uint16 _offsetFrame2;
+	Surface *_frameSurface; // holds _videoFrameBuffer, from the surface pool
 	byte *_palette;
 	bool _paletteChanged;
 
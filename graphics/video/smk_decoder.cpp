@@ -35,6 +35,9 @@
 #include "common/stream.h"
 #include "common/system.h"
 
+#include "graphics/surface.h"
+#include "graphics/surfacepool.h"
+
 #include "sound/audiostream.h"
 #include "sound/mixer.h"
 #include "sound/decoders/raw.h"
@@ -51,73 +54,89 @@ enum SmkBlockTypes {
 /*
  * class BitStream
  * Little-endian bit stream provider.
+ *
+ * Up to 32 bits are kept in a buffer, which is refilled a word at a time,
+ * so that the Huffman decoders can peek at several bits at once. Reading
+ * past the end of the data returns zero bits.
  */
 
 class BitStream {
 public:
 	BitStream(byte *buf, uint32 length)
-		: _buf(buf), _end(buf+length), _bitCount(8) {
-		_curByte = *_buf++;
+		: _buf(buf), _end(buf+length), _bits(0), _bitCount(0) {
+		refill();
 	}
 
-	bool getBit();
-	byte getBits8();
+	bool getBit() {
+		if (_bitCount == 0)
+			refill();
 
-	byte peek8() const;
-	void skip(int n);
+		bool v = _bits & 1;
 
-private:
-	byte *_buf;
-	byte *_end;
-	byte _curByte;
-	byte  _bitCount;
-};
+		_bits >>= 1;
+		--_bitCount;
 
-bool BitStream::getBit() {
-	if (_bitCount == 0) {
-		assert(_buf < _end);
-		_curByte = *_buf++;
-		_bitCount = 8;
+		return v;
 	}
 
-	bool v = _curByte & 1;
-
-	_curByte >>= 1;
-	--_bitCount;
-
-	return v;
-}
+	byte getBits8() {
+		byte v = peekBits(8);
+		skip(8);
+		return v;
+	}
 
-byte BitStream::getBits8() {
-	assert(_buf < _end);
+	/**
+	 * Return the next n (n <= 24) bits, without consuming them. A refill
+	 * only guarantees 24 valid bits in the buffer.
+	 */
+	uint32 peekBits(int n) {
+		if (_bitCount < n)
+			refill();
 
-	byte v = (*_buf << _bitCount) | _curByte;
-	_curByte = *_buf++ >> (8 - _bitCount);
+		return _bits & ((1 << n) - 1);
+	}
 
-	return v;
-}
+	void skip(int n) {
+		assert(n <= _bitCount);
+		_bits >>= n;
+		_bitCount -= n;
+	}
 
-byte BitStream::peek8() const {
-	if (_buf == _end)
-		return _curByte;
+private:
+	void refill();
 
-	assert(_buf < _end);
-	return (*_buf << _bitCount) | _curByte;
-}
+	byte *_buf;
+	byte *_end;
+	uint32 _bits;
+	int _bitCount;
+};
 
-void BitStream::skip(int n) {
-	assert(n <= 8);
-	_curByte >>= n;
+void BitStream::refill() {
+	if (_end - _buf >= 4) {
+		// Load a whole word, but only consume the bytes which fit into
+		// the buffer completely. The bits of the next byte which do get
+		// loaded already are the same which will be loaded again later.
+		_bits |= READ_LE_UINT32(_buf) << _bitCount;
+		int n = (31 - _bitCount) >> 3;
+		_buf += n;
+		_bitCount += n * 8;
+		return;
+	}
 
-	if (_bitCount >= n) {
-		_bitCount -= n;
-	} else {
-		assert(_buf < _end);
-		_bitCount = _bitCount + 8 - n;
-		_curByte = *_buf++ >> (8 - _bitCount);
+	while (_bitCount <= 24) {
+		if (_buf < _end)
+			_bits |= *_buf++ << _bitCount;
+		_bitCount += 8;
 	}
 }
 
+enum {
+	// The number of bits resolved by the lookup tables of the Huffman
+	// trees. Longer codes are resolved by walking the remaining tree.
+	SMK_LOOKUP_BITS = 10,
+	SMK_LOOKUP_SIZE = 1 << SMK_LOOKUP_BITS
+};
+
 /*
  * class SmallHuffmanTree
  * A Huffman-tree to hold 8-bit values.
@@ -138,8 +157,10 @@ private:
 	uint16 _treeSize;
 	uint16 _tree[511];
 
-	uint16 _prefixtree[256];
-	byte _prefixlength[256];
+	// The index of the tree entry (leaf, or node for longer codes)
+	// for each SMK_LOOKUP_BITS long prefix, shifted left by 4, and
+	// the number of bits of that prefix in the low 4 bits.
+	uint16 _prefixtree[SMK_LOOKUP_SIZE];
 
 	BitStream &_bs;
 };
@@ -149,8 +170,7 @@ SmallHuffmanTree::SmallHuffmanTree(BitStream &bs)
 	uint32 bit = _bs.getBit();
 	assert(bit);
 
-	for (uint16 i = 0; i < 256; ++i)
-		_prefixtree[i] = _prefixlength[i] = 0;
+	memset(_prefixtree, 0, sizeof(_prefixtree));
 
 	decodeTree(0, 0);
 
@@ -162,11 +182,9 @@ uint16 SmallHuffmanTree::decodeTree(uint32 prefix, int length) {
 	if (!_bs.getBit()) { // Leaf
 		_tree[_treeSize] = _bs.getBits8();
 
-		if (length <= 8) {
-			for (int i = 0; i < 256; i += (1 << length)) {
-				_prefixtree[prefix | i] = _treeSize;
-				_prefixlength[prefix | i] = length;
-			}
+		if (length <= SMK_LOOKUP_BITS) {
+			for (int i = 0; i < SMK_LOOKUP_SIZE; i += (1 << length))
+				_prefixtree[prefix | i] = (_treeSize << 4) | length;
 		}
 		++_treeSize;
 
@@ -175,10 +193,8 @@ uint16 SmallHuffmanTree::decodeTree(uint32 prefix, int length) {
 
 	uint16 t = _treeSize++;
 
-	if (length == 8) {
-		_prefixtree[prefix] = t;
-		_prefixlength[prefix] = 8;
-	}
+	if (length == SMK_LOOKUP_BITS)
+		_prefixtree[prefix] = (t << 4) | SMK_LOOKUP_BITS;
 
 	uint16 r1 = decodeTree(prefix, length + 1);
 
@@ -190,9 +206,9 @@ uint16 SmallHuffmanTree::decodeTree(uint32 prefix, int length) {
 }
 
 uint16 SmallHuffmanTree::getCode(BitStream &bs) {
-	byte peek = bs.peek8();
-	uint16 *p = &_tree[_prefixtree[peek]];
-	bs.skip(_prefixlength[peek]);
+	uint16 entry = _prefixtree[bs.peekBits(SMK_LOOKUP_BITS)];
+	uint16 *p = &_tree[entry >> 4];
+	bs.skip(entry & 15);
 
 	while (*p & SMK_NODE) {
 		if (bs.getBit())
@@ -226,8 +242,8 @@ private:
 	uint32 *_tree;
 	uint32  _last[3];
 
-	uint32 _prefixtree[256];
-	byte _prefixlength[256];
+	// See SmallHuffmanTree::_prefixtree
+	uint32 _prefixtree[SMK_LOOKUP_SIZE];
 
 	/* Used during construction */
 	BitStream &_bs;
@@ -238,6 +254,8 @@ private:
 
 BigHuffmanTree::BigHuffmanTree(BitStream &bs, int allocSize)
 	: _bs(bs) {
+	memset(_prefixtree, 0, sizeof(_prefixtree));
+
 	uint32 bit = _bs.getBit();
 	if (!bit) {
 		_tree = new uint32[1];
@@ -246,9 +264,6 @@ BigHuffmanTree::BigHuffmanTree(BitStream &bs, int allocSize)
 		return;
 	}
 
-	for (uint32 i = 0; i < 256; ++i)
-		_prefixtree[i] = _prefixlength[i] = 0;
-
 	_loBytes = new SmallHuffmanTree(_bs);
 	_hiBytes = new SmallHuffmanTree(_bs);
 
@@ -295,11 +310,9 @@ uint32 BigHuffmanTree::decodeTree(uint32 prefix, int length) {
 
 		_tree[_treeSize] = v;
 
-		if (length <= 8) {
-			for (int i = 0; i < 256; i += (1 << length)) {
-				_prefixtree[prefix | i] = _treeSize;
-				_prefixlength[prefix | i] = length;
-			}
+		if (length <= SMK_LOOKUP_BITS) {
+			for (int i = 0; i < SMK_LOOKUP_SIZE; i += (1 << length))
+				_prefixtree[prefix | i] = (_treeSize << 4) | length;
 		}
 
 		for (int i = 0; i < 3; ++i) {
@@ -315,10 +328,8 @@ uint32 BigHuffmanTree::decodeTree(uint32 prefix, int length) {
 
 	uint32 t = _treeSize++;
 
-	if (length == 8) {
-		_prefixtree[prefix] = t;
-		_prefixlength[prefix] = 8;
-	}
+	if (length == SMK_LOOKUP_BITS)
+		_prefixtree[prefix] = (t << 4) | SMK_LOOKUP_BITS;
 
 	uint32 r1 = decodeTree(prefix, length + 1);
 
@@ -329,9 +340,9 @@ uint32 BigHuffmanTree::decodeTree(uint32 prefix, int length) {
 }
 
 uint32 BigHuffmanTree::getCode(BitStream &bs) {
-	byte peek = bs.peek8();
-	uint32 *p = &_tree[_prefixtree[peek]];
-	bs.skip(_prefixlength[peek]);
+	uint32 entry = _prefixtree[bs.peekBits(SMK_LOOKUP_BITS)];
+	uint32 *p = &_tree[entry >> 4];
+	bs.skip(entry & 15);
 
 	while (*p & SMK_NODE) {
 		if (bs.getBit())
@@ -350,7 +361,7 @@ uint32 BigHuffmanTree::getCode(BitStream &bs) {
 }
 
 SmackerDecoder::SmackerDecoder(Audio::Mixer *mixer, Audio::Mixer::SoundType soundType)
-	: _audioStarted(false), _audioStream(0), _mixer(mixer), _soundType(soundType) {
+	: _audioStarted(false), _audioStream(0), _mixer(mixer), _soundType(soundType), _frameSurface(0) {
 }
 
 SmackerDecoder::~SmackerDecoder() {
@@ -494,7 +505,8 @@ bool SmackerDecoder::loadFile(const char *fileName) {
 
 	delete[] huffmanTrees;
 
-	_videoFrameBuffer = (byte *)malloc(2 * _videoInfo.width * _videoInfo.height);
+	_frameSurface = SurfacePoolMan.acquire(_videoInfo.width, 2 * _videoInfo.height, 1);
+	_videoFrameBuffer = (byte *)_frameSurface->pixels;
 	memset(_videoFrameBuffer, 0, 2 * _videoInfo.width * _videoInfo.height);
 	_palette = (byte *)malloc(3 * 256);
 	memset(_palette, 0, 3 * 256);
@@ -524,7 +536,9 @@ void SmackerDecoder::closeFile() {
 
 	free(_frameSizes);
 	free(_frameTypes);
-	free(_videoFrameBuffer);
+	SurfacePoolMan.release(_frameSurface);
+	_frameSurface = 0;
+	_videoFrameBuffer = 0;
 	free(_palette);
 }
 
@@ -36,6 +36,7 @@ namespace Audio {
 namespace Graphics {
 
 class BigHuffmanTree;
+struct Surface;
 
 /**
  * Decoder for Smacker v2/v4 videos.
@@ -109,6 +110,8 @@ private:
 	// (bit 0) is set, it denotes a frame that contains a palette record
 	byte *_frameTypes;
 	byte *_frameData;
+	// The surface holding _videoFrameBuffer, from the surface pool
+	Surface *_frameSurface;
 	// The RGB palette
 	byte *_palette;
 
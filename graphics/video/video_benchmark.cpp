@@ -0,0 +1,127 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#include "graphics/video/video_benchmark.h"
+
+#include "common/debug.h"
+#include "common/system.h"
+#include "common/util.h"
+
+namespace Graphics {
+
+VideoBenchmark::VideoBenchmark(const Common::String &fileName) : _fileName(fileName),
+	_frames(0), _time(0), _maxBatchTime(0), _crc(0xFFFFFFFF),
+	_batch(0), _batchSize(0), _batchCapacity(0), _batchFrames(0), _batchStart(0) {
+}
+
+VideoBenchmark::~VideoBenchmark() {
+	free(_batch);
+}
+
+void VideoBenchmark::start() {
+	_batchStart = g_system->getMillis();
+}
+
+void VideoBenchmark::addFrame(const byte *pixels, uint pitch, uint width, uint height) {
+	const uint32 size = width * height;
+
+	// Only happens for the first batch, unless the frame size changes
+	if (_batchSize + size > _batchCapacity) {
+		_batchCapacity = MAX<uint32>(_batchSize + size, kBatchFrames * size);
+		_batch = (byte *)realloc(_batch, _batchCapacity);
+		assert(_batch);
+	}
+
+	byte *dst = _batch + _batchSize;
+	for (uint y = 0; y < height; y++, pixels += pitch, dst += width)
+		memcpy(dst, pixels, width);
+
+	_batchSize += size;
+	_batchFrameSizes[_batchFrames++] = size;
+
+	if (_batchFrames == kBatchFrames)
+		finishBatch();
+}
+
+void VideoBenchmark::stop() {
+	if (_batchFrames)
+		finishBatch();
+}
+
+void VideoBenchmark::finishBatch() {
+	const uint32 time = g_system->getMillis() - _batchStart;
+
+	debug(1, "%s: Frames %d to %d: %d ms", _fileName.c_str(), _frames, _frames + _batchFrames - 1, time);
+
+	const byte *frame = _batch;
+	for (uint i = 0; i < _batchFrames; i++) {
+		uint32 crc = updateCRC(0xFFFFFFFF, frame, _batchFrameSizes[i]);
+		_crc = updateCRC(_crc, frame, _batchFrameSizes[i]);
+		debug(1, "%s: Frame %d: CRC %08x", _fileName.c_str(), _frames + i, crc ^ 0xFFFFFFFF);
+		frame += _batchFrameSizes[i];
+	}
+
+	// A partial batch at the end is only taken into account if there was
+	// no complete one
+	if (_batchFrames == kBatchFrames || _frames < kBatchFrames)
+		_maxBatchTime = MAX(_maxBatchTime, time);
+
+	_frames += _batchFrames;
+	_time += time;
+	_batchFrames = 0;
+	_batchSize = 0;
+
+	// The CRCs are not part of the measured time
+	_batchStart = g_system->getMillis();
+}
+
+void VideoBenchmark::printResult(int width, int height) const {
+	printf("%s: %dx%d, %d frames in %d ms, %.1f frames/s, slowest %d frames in %d ms, CRC %08x\n",
+			_fileName.c_str(), width, height, _frames, _time,
+			(_time > 0) ? (_frames * 1000.0 / _time) : 0.0,
+			MIN<uint32>(_frames, kBatchFrames), _maxBatchTime, getCRC());
+}
+
+uint32 VideoBenchmark::updateCRC(uint32 crc, const byte *data, uint size) {
+	static uint32 table[256];
+	static bool initialized = false;
+
+	if (!initialized) {
+		for (uint32 i = 0; i < 256; i++) {
+			uint32 c = i;
+			for (int j = 0; j < 8; j++)
+				c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+			table[i] = c;
+		}
+		initialized = true;
+	}
+
+	while (size--)
+		crc = table[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+
+	return crc;
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,105 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#ifndef GRAPHICS_VIDEO_BENCHMARK_H
+#define GRAPHICS_VIDEO_BENCHMARK_H
+
+#include "common/str.h"
+
+namespace Graphics {
+
+/**
+ * Collects the decoded frames of a video for the --bench-video command line
+ * option, and prints the decoding speed and a CRC of all frames.
+ *
+ * g_system->getMillis() only has a resolution of 1 ms, which is about the
+ * time a frame of a small video takes to decode. Thus the decoding is timed
+ * in batches of frames. The frames of a batch are copied into a buffer, and
+ * their CRCs are only computed at the end of the batch, so that this is not
+ * part of the measured time.
+ *
+ * Usage:
+ *
+ *   VideoBenchmark bench(fileName);
+ *   bench.start();
+ *   while (...) {
+ *     // decode a frame
+ *     bench.addFrame(pixels, pitch, width, height);
+ *   }
+ *   bench.stop();
+ *   bench.printResult(width, height);
+ */
+class VideoBenchmark {
+public:
+	VideoBenchmark(const Common::String &fileName);
+	~VideoBenchmark();
+
+	/** Start the timing, right before the first frame is decoded. */
+	void start();
+
+	/**
+	 * Add a decoded frame.
+	 * @param pixels	the frame's pixels
+	 * @param pitch		the distance between two lines of the frame in bytes
+	 * @param width		the width of a line in bytes
+	 * @param height	the height of the frame
+	 */
+	void addFrame(const byte *pixels, uint pitch, uint width, uint height);
+
+	/** Stop the timing, after the last frame has been added. */
+	void stop();
+
+	uint32 getFrames() const { return _frames; }
+	uint32 getCRC() const { return _crc ^ 0xFFFFFFFF; }
+
+	void printResult(int width, int height) const;
+
+private:
+	enum {
+		/** The number of frames timed together. */
+		kBatchFrames = 8
+	};
+
+	void finishBatch();
+	static uint32 updateCRC(uint32 crc, const byte *data, uint size);
+
+	Common::String _fileName;
+	uint32 _frames;
+	uint32 _time;
+	uint32 _maxBatchTime;
+	uint32 _crc;
+
+	/** The frames of the current batch, without padding between lines. */
+	byte *_batch;
+	uint32 _batchSize;
+	uint32 _batchCapacity;
+	uint32 _batchFrameSizes[kBatchFrames];
+	uint _batchFrames;
+	uint32 _batchStart;
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -36,7 +36,7 @@
 
 namespace Graphics {
 
-VideoDecoder::VideoDecoder() : _fileStream(0) {
+VideoDecoder::VideoDecoder() : _fileStream(0), _paletteCapture(0), _paletteCaptured(false) {
 	_curFrameBlack = 0;
 	_curFrameWhite = 255;
 }
@@ -118,6 +118,12 @@ void VideoDecoder::copyFrameToBuffer(byte *dst, uint x, uint y, uint pitch) {
 }
 
 void VideoDecoder::setPalette(byte *pal) {
+	if (_paletteCapture) {
+		memcpy(_paletteCapture, pal, 256 * 3);
+		_paletteCaptured = true;
+		return;
+	}
+
 	byte videoPalette[256 * 4];
 
 	uint32 maxWeight = 0;
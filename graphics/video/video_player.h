@@ -36,10 +36,13 @@ namespace Common {
 
 namespace Graphics {
 
+class AsyncVideoDecoder;
+
 /**
  * Implementation of a generic video decoder
  */
 class VideoDecoder {
+	friend class AsyncVideoDecoder;
 public:
 	VideoDecoder();
 	virtual ~VideoDecoder();
@@ -123,7 +126,7 @@ public:
 	 * @param x	the x coordinate of the pixel
 	 * @param y	the y coordinate of the pixel
 	 */
-	byte getPixel(int x, int y) {
+	virtual byte getPixel(int x, int y) {
 		return *(_videoFrameBuffer + y * _videoInfo.width + x * 1);
 	}
 
@@ -151,7 +154,7 @@ public:
 	 * @param y		the y position of the buffer
 	 * @param pitch		the pitch of buffer
 	 */
-	void copyFrameToBuffer(byte *dst, uint x, uint y, uint pitch);
+	virtual void copyFrameToBuffer(byte *dst, uint x, uint y, uint pitch);
 
 	/**
 	 * Decode the next frame to _videoFrameBuffer
@@ -174,6 +177,14 @@ protected:
 
 	Common::SeekableReadStream *_fileStream;
 	byte *_videoFrameBuffer;
+
+	/**
+	 * If set, setPalette() copies the palette here and sets
+	 * _paletteCaptured, instead of applying it. Used by AsyncVideoDecoder,
+	 * to apply the palette when the frame is shown rather than decoded.
+	 */
+	byte *_paletteCapture;
+	bool _paletteCaptured;
 };
 
 class VideoPlayer {
@@ -24,6 +24,7 @@
  */
 
 #include "common/debug.h"
+#include "common/memorypool.h"
 #include "common/system.h"
 
 #include "gui/debugger.h"
@@ -58,6 +59,8 @@ Debugger::Debugger() {
 	DCmd_Register("debugflag_list",		WRAP_METHOD(Debugger, Cmd_DebugFlagsList));
 	DCmd_Register("debugflag_enable",	WRAP_METHOD(Debugger, Cmd_DebugFlagEnable));
 	DCmd_Register("debugflag_disable",	WRAP_METHOD(Debugger, Cmd_DebugFlagDisable));
+
+	DCmd_Register("mempool",			WRAP_METHOD(Debugger, Cmd_MemPool));
 }
 
 Debugger::~Debugger() {
@@ -514,6 +517,23 @@ bool Debugger::Cmd_DebugFlagDisable(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::Cmd_MemPool(int argc, const char **argv) {
+	Common::SharedMemoryPool &pool = Common::SharedMemoryPool::instance();
+
+	if (argc > 1 && !strcmp(argv[1], "free"))
+		pool.freeUnusedPages();
+
+	Common::SizeClassMemoryPool::Stats stats;
+	pool.getStats(stats);
+
+	DebugPrintf("Shared memory pool:\n");
+	DebugPrintf("  %u allocations, %u frees, %u malloc calls\n", stats.allocCount, stats.freeCount, stats.mallocCount);
+	DebugPrintf("  %u chunks in use, %u of %u reserved bytes in use\n", (uint)stats.usedChunks, (uint)stats.usedBytes, (uint)stats.reservedBytes);
+	if (argc <= 1)
+		DebugPrintf("Use 'mempool free' to release unused pages\n");
+	return true;
+}
+
 // Console handler
 #ifndef USE_TEXT_CONSOLE
 bool Debugger::debuggerInputCallback(GUI::ConsoleDialog *console, const char *input, void *refCon) {
@@ -25,6 +25,7 @@
 
 #include "common/util.h"
 #include "common/system.h"
+#include "common/memorypool.h"
 
 #include "sound/mixer_intern.h"
 #include "sound/rate.h"
@@ -41,8 +42,11 @@ namespace Audio {
 
 /**
  * Channel used by the default Mixer implementation.
+ *
+ * Channels are allocated from the shared memory pool, since they are
+ * frequently created by the engines and destroyed in the mixer thread.
  */
-class Channel {
+class Channel : public Common::PooledObject {
 public:
 	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *input, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
 	~Channel();
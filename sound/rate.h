@@ -27,6 +27,7 @@
 #define SOUND_RATE_H
 
 #include "common/scummsys.h"
+#include "common/memorypool.h"
 #include "engines/engine.h"
 
 class AudioStream;
@@ -70,7 +71,7 @@ static inline void clampedAdd(int16& a, int b) {
 #endif
 }
 
-class RateConverter {
+class RateConverter : public Common::PooledObject {
 public:
 	RateConverter() {}
 	virtual ~RateConverter() {}
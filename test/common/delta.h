@@ -0,0 +1,126 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/delta.h"
+#include "common/stream.h"
+
+#include <stdlib.h>
+
+class DeltaTestSuite : public CxxTest::TestSuite
+{
+	public:
+	static uint random(uint &seed) {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	static byte *makeBuffer(uint32 size, uint &seed) {
+		byte *buffer = (byte *)malloc(size);
+		for (uint32 i = 0; i < size; i++)
+			buffer[i] = random(seed);
+		return buffer;
+	}
+
+	// Encode the delta between the two buffers, verify that decoding it
+	// yields the data again, and return the size of the delta.
+	static uint32 roundTrip(const byte *base, uint32 baseSize, const byte *data, uint32 dataSize) {
+		Common::MemoryWriteStreamDynamic out;
+		const uint32 written = Common::encodeDelta(base, baseSize, data, dataSize, out);
+		TS_ASSERT_EQUALS(written, out.size());
+
+		Common::MemoryReadStream in(out.getData(), out.size());
+		uint32 size;
+		byte *decoded = Common::decodeDelta(base, baseSize, in, size);
+		TS_ASSERT(decoded != 0);
+		if (decoded) {
+			TS_ASSERT_EQUALS(size, dataSize);
+			TS_ASSERT(size != dataSize || !memcmp(decoded, data, size));
+			free(decoded);
+		}
+
+		free(out.getData());
+		return written;
+	}
+
+	void test_empty() {
+		const byte data[] = { 1, 2, 3 };
+		roundTrip(0, 0, 0, 0);
+		roundTrip(0, 0, data, sizeof(data));
+		roundTrip(data, sizeof(data), 0, 0);
+		roundTrip(data, sizeof(data), data, sizeof(data));
+	}
+
+	void test_identical() {
+		uint seed = 1;
+		byte *base = makeBuffer(100000, seed);
+		TS_ASSERT_LESS_THAN(roundTrip(base, 100000, base, 100000), 20u);
+		free(base);
+	}
+
+	void test_changes() {
+		uint seed = 2;
+		byte *base = makeBuffer(100000, seed);
+		byte *data = (byte *)malloc(100000);
+		memcpy(data, base, 100000);
+		for (int i = 0; i < 20; i++)
+			data[random(seed) % 100000] ^= 0x55;
+
+		// Only the changed bytes and their surroundings are stored
+		TS_ASSERT_LESS_THAN(roundTrip(base, 100000, data, 100000), 1000u);
+
+		free(data);
+		free(base);
+	}
+
+	void test_moved() {
+		uint seed = 3;
+		byte *base = makeBuffer(100000, seed);
+		byte *data = (byte *)malloc(110000);
+
+		// Insert new data in the middle, shifting the rest of the base
+		memcpy(data, base, 30000);
+		for (int i = 30000; i < 40000; i++)
+			data[i] = random(seed);
+		memcpy(data + 40000, base + 30000, 70000);
+
+		TS_ASSERT_LESS_THAN(roundTrip(base, 100000, data, 110000), 10100u);
+
+		// Remove data again, and grow the end
+		TS_ASSERT_LESS_THAN(roundTrip(data, 110000, base, 100000), 100u);
+		TS_ASSERT_LESS_THAN(roundTrip(base, 50000, base, 100000), 50100u);
+
+		free(data);
+		free(base);
+	}
+
+	void test_unrelated() {
+		uint seed = 4;
+		byte *base = makeBuffer(10000, seed);
+		byte *data = makeBuffer(10001, seed);
+		TS_ASSERT_LESS_THAN(roundTrip(base, 10000, data, 10001), 10020u);
+		free(data);
+		free(base);
+	}
+
+	void test_corrupt() {
+		uint seed = 5;
+		byte *base = makeBuffer(1000, seed);
+		byte *data = makeBuffer(1000, seed);
+		memcpy(data + 200, base, 500);
+
+		Common::MemoryWriteStreamDynamic out;
+		Common::encodeDelta(base, 1000, data, 1000, out);
+		uint32 size;
+
+		// A truncated delta
+		Common::MemoryReadStream truncated(out.getData(), out.size() - 1);
+		TS_ASSERT(Common::decodeDelta(base, 1000, truncated, size) == 0);
+
+		// A delta applied to a base which is too short
+		Common::MemoryReadStream shortBase(out.getData(), out.size());
+		TS_ASSERT(Common::decodeDelta(base, 400, shortBase, size) == 0);
+
+		free(out.getData());
+		free(data);
+		free(base);
+	}
+};
@@ -0,0 +1,189 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/flathashmap.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+
+// A hash function which maps everything into the same slot, to
+// exercise the displacement and backward shift code paths.
+struct FlatHashMapTestConstantHash {
+	uint operator()(int x) const { return 42; }
+};
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+
+		Common::FlatHashMap<Common::String, Common::String> container2;
+		TS_ASSERT(container2.empty());
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(!container2.empty());
+		container2.clear(true);
+		TS_ASSERT(container2.empty());
+		TS_ASSERT_EQUALS(container2.begin(), container2.end());
+	}
+
+	void test_contains() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(container.contains(0));
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT(!container.contains(17));
+		TS_ASSERT(!container.contains(-1));
+
+		Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> container2;
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(container2.contains("foo"));
+		TS_ASSERT(container2.contains("QUUX"));
+		TS_ASSERT(!container2.contains("bar"));
+		TS_ASSERT(!container2.contains("asdf"));
+	}
+
+	void test_add_remove() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		TS_ASSERT(container.contains(1));
+		container.erase(1);
+		TS_ASSERT(!container.contains(1));
+		container[1] = 42;
+		TS_ASSERT(container.contains(1));
+		container.erase(0);
+		TS_ASSERT(!container.empty());
+		container.erase(1);
+		TS_ASSERT(!container.empty());
+		container.erase(2);
+		TS_ASSERT(!container.empty());
+		container.erase(3);
+		TS_ASSERT(!container.empty());
+		container.erase(4);
+		TS_ASSERT(container.empty());
+		container.erase(4);
+		TS_ASSERT(container.empty());
+	}
+
+	void test_lookup_with_default() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = -1;
+		container[2] = 45;
+
+		const Common::FlatHashMap<int, int> &containerRef = container;
+
+		TS_ASSERT_EQUALS(containerRef.getVal(0), 17);
+		TS_ASSERT_EQUALS(containerRef.getVal(1), -1);
+		TS_ASSERT_EQUALS(containerRef.getVal(17), 0);
+		TS_ASSERT_EQUALS(containerRef.getVal(0, -10), 17);
+		TS_ASSERT_EQUALS(containerRef.getVal(17, -10), -10);
+		TS_ASSERT_EQUALS(container.size(), 3u);
+	}
+
+	void test_collision() {
+		Common::FlatHashMap<int, int, FlatHashMapTestConstantHash> h;
+		for (int i = 0; i < 10; i++)
+			h[i] = i * 10;
+		for (int i = 0; i < 10; i++)
+			TS_ASSERT_EQUALS(h[i], i * 10);
+
+		h.erase(0);
+		h.erase(5);
+		h.erase(9);
+		TS_ASSERT(!h.contains(0));
+		TS_ASSERT(!h.contains(5));
+		TS_ASSERT(!h.contains(9));
+		TS_ASSERT_EQUALS(h.size(), 7u);
+		for (int i = 1; i < 9; i++) {
+			if (i != 5)
+				TS_ASSERT_EQUALS(h[i], i * 10);
+		}
+
+		h[5] = 1;
+		TS_ASSERT_EQUALS(h[5], 1);
+		TS_ASSERT_EQUALS(h[8], 80);
+	}
+
+	void test_iterator() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		container.erase(1);
+		container[1] = 42;
+		container.erase(0);
+		container.erase(1);
+
+		int found = 0;
+		Common::FlatHashMap<int, int>::const_iterator i;
+		for (i = container.begin(); i != container.end(); ++i) {
+			int key = i->_key;
+			TS_ASSERT(key >= 0 && key <= 4);
+			TS_ASSERT(!(found & (1 << key)));
+			found |= 1 << key;
+		}
+		TS_ASSERT(found == 16+8+4);
+	}
+
+	void test_copy() {
+		Common::FlatHashMap<Common::String, int> map1, map2;
+		map1["a"] = 1;
+		map1["b"] = 2;
+		map2 = map1;
+		map1.erase("a");
+		TS_ASSERT_EQUALS(map2["a"], 1);
+		TS_ASSERT_EQUALS(map2["b"], 2);
+
+		Common::FlatHashMap<Common::String, int> map3(map2);
+		TS_ASSERT_EQUALS(map3.size(), 2u);
+		TS_ASSERT_EQUALS(map3["b"], 2);
+	}
+
+	void test_against_hashmap() {
+		// Perform the same pseudo random operations on a HashMap and a
+		// FlatHashMap, and verify that both always agree.
+		Common::HashMap<int, int> ref;
+		Common::FlatHashMap<int, int> flat;
+		uint seed = 12345;
+
+		for (int i = 0; i < 20000; i++) {
+			seed = seed * 1103515245 + 12345;
+			int key = (seed >> 8) % 1000;
+			if ((seed >> 24) & 1) {
+				ref[key] = i;
+				flat[key] = i;
+			} else {
+				ref.erase(key);
+				flat.erase(key);
+			}
+			TS_ASSERT_EQUALS(ref.size(), flat.size());
+		}
+
+		for (int key = 0; key < 1000; key++) {
+			TS_ASSERT_EQUALS(ref.contains(key), flat.contains(key));
+			if (ref.contains(key))
+				TS_ASSERT_EQUALS(ref[key], flat[key]);
+		}
+
+		uint count = 0;
+		for (Common::FlatHashMap<int, int>::const_iterator i = flat.begin(); i != flat.end(); ++i) {
+			TS_ASSERT(ref.contains(i->_key));
+			count++;
+		}
+		TS_ASSERT_EQUALS(count, ref.size());
+	}
+};
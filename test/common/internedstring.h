@@ -0,0 +1,106 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/internedstring.h"
+#include "common/hash-str.h"
+
+class InternedStringTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_identity() {
+		Common::InternedString a("interned-test-foo");
+		Common::InternedString b(Common::String("interned-test-") + "foo");
+		Common::InternedString c("interned-test-bar");
+
+		TS_ASSERT_EQUALS(a.c_str(), b.c_str());
+		TS_ASSERT(a == b);
+		TS_ASSERT(a != c);
+		TS_ASSERT_EQUALS(a.str(), "interned-test-foo");
+		TS_ASSERT_EQUALS(a.hash(), Common::hashit("interned-test-foo"));
+		TS_ASSERT_EQUALS(a.size(), 17u);
+
+		Common::InternedString empty;
+		TS_ASSERT(empty.empty());
+		TS_ASSERT(empty == Common::InternedString(""));
+	}
+
+	void test_ignore_case() {
+		Common::InternedString a("Interned-Test-MixedCase");
+		Common::InternedString b("INTERNED-TEST-MIXEDCASE");
+
+		TS_ASSERT(a != b);
+		TS_ASSERT(a.equalsIgnoreCase(b));
+		TS_ASSERT_EQUALS(a.hashIgnoreCase(), b.hashIgnoreCase());
+		TS_ASSERT_EQUALS(a.toLowercase().str(), "interned-test-mixedcase");
+		TS_ASSERT(a.toLowercase() == b.toLowercase());
+		TS_ASSERT(!a.equalsIgnoreCase(Common::InternedString("interned-test-other")));
+	}
+
+	void test_find() {
+		Common::InternedString result;
+		uint poolSize = Common::InternedString::getPoolSize();
+
+		TS_ASSERT(!Common::InternedString::find("interned-test-never-interned", result));
+		TS_ASSERT(!Common::InternedString::findIgnoreCase("Interned-Test-Never-Interned", result));
+		TS_ASSERT_EQUALS(Common::InternedString::getPoolSize(), poolSize);
+
+		Common::InternedString a("Interned-Test-Found");
+		TS_ASSERT(Common::InternedString::find("Interned-Test-Found", result));
+		TS_ASSERT(result == a);
+		TS_ASSERT(!Common::InternedString::find("interned-test-FOUND", result));
+		TS_ASSERT(Common::InternedString::findIgnoreCase("interned-test-FOUND", result));
+		TS_ASSERT(result.equalsIgnoreCase(a));
+	}
+
+	void test_hashmap() {
+		Common::HashMap<Common::InternedString, int, Common::InternedString_IgnoreCase_Hash, Common::InternedString_IgnoreCase_EqualTo> map;
+		map["Interned-Test-Key"] = 1;
+		map["interned-test-other-key"] = 2;
+
+		TS_ASSERT(map.contains("INTERNED-TEST-KEY"));
+		TS_ASSERT_EQUALS(map["interned-test-key"], 1);
+		TS_ASSERT_EQUALS(map["Interned-Test-Other-Key"], 2);
+		TS_ASSERT_EQUALS(map.size(), 2u);
+	}
+
+	void test_free_pool() {
+		Common::InternedString a("interned-test-freed");
+		TS_ASSERT(Common::InternedString::getPoolSize() > 0);
+
+		Common::InternedString::freePool();
+		TS_ASSERT_EQUALS(Common::InternedString::getPoolSize(), 0u);
+
+		Common::InternedString result;
+		TS_ASSERT(!Common::InternedString::find("interned-test-freed", result));
+
+		Common::InternedString b("interned-test-freed");
+		TS_ASSERT(Common::InternedString::find("interned-test-freed", result));
+		TS_ASSERT(result == b);
+	}
+
+	// Append the given piece count times to str, and return how often the
+	// string storage had to be reallocated for that.
+	static int appendPieces(Common::String &str, const char *piece, int count) {
+		int reallocs = 0;
+		for (int i = 0; i < count; i++) {
+			const char *storage = str.c_str();
+			str += piece;
+			if (str.c_str() != storage)
+				reallocs++;
+		}
+		return reallocs;
+	}
+
+	void test_reserve_append() {
+		const char *piece = "a somewhat longer piece of text";
+
+		Common::String appended;
+		appendPieces(appended, piece, 100);
+
+		Common::String reserved;
+		reserved.reserve(100 * strlen(piece));
+		int reserveAllocs = appendPieces(reserved, piece, 100);
+
+		TS_ASSERT_EQUALS(appended, reserved);
+		TS_ASSERT_EQUALS(reserveAllocs, 0);
+	}
+};
@@ -0,0 +1,100 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memorypool.h"
+
+class MemoryPoolTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_chunks() {
+		Common::MemoryPool pool(sizeof(int));
+		int *chunks[100];
+
+		for (int i = 0; i < 100; i++) {
+			chunks[i] = (int *)pool.allocChunk();
+			*chunks[i] = i;
+		}
+		TS_ASSERT_EQUALS(pool.getUsedChunks(), 100u);
+		for (int i = 0; i < 100; i++)
+			TS_ASSERT_EQUALS(*chunks[i], i);
+
+		for (int i = 0; i < 100; i += 2)
+			pool.freeChunk(chunks[i]);
+		TS_ASSERT_EQUALS(pool.getUsedChunks(), 50u);
+		for (int i = 1; i < 100; i += 2)
+			TS_ASSERT_EQUALS(*chunks[i], i);
+	}
+
+	void test_free_unused_pages() {
+		Common::MemoryPool pool(16);
+		void *chunks[1000];
+
+		for (int i = 0; i < 1000; i++)
+			chunks[i] = pool.allocChunk();
+		size_t numPages = pool.getNumPages();
+		TS_ASSERT(numPages > 1);
+
+		// Free everything but the last chunk, which lives in the largest
+		// (i.e. last allocated) page.
+		for (int i = 0; i < 999; i++)
+			pool.freeChunk(chunks[i]);
+		pool.freeUnusedPages();
+		TS_ASSERT_EQUALS(pool.getNumPages(), 1u);
+		TS_ASSERT_EQUALS(pool.getUsedChunks(), 1u);
+
+		// The remaining page must still be usable.
+		for (int i = 0; i < 999; i++)
+			chunks[i] = pool.allocChunk();
+		TS_ASSERT_EQUALS(pool.getUsedChunks(), 1000u);
+		for (int i = 0; i < 1000; i++)
+			pool.freeChunk(chunks[i]);
+		pool.freeUnusedPages();
+		TS_ASSERT_EQUALS(pool.getNumPages(), 0u);
+	}
+
+	void test_size_classes() {
+		TS_ASSERT_EQUALS(Common::SizeClassMemoryPool::getSizeClassChunkSize(1), 8u);
+		TS_ASSERT_EQUALS(Common::SizeClassMemoryPool::getSizeClassChunkSize(8), 8u);
+		TS_ASSERT_EQUALS(Common::SizeClassMemoryPool::getSizeClassChunkSize(9), 16u);
+		TS_ASSERT_EQUALS(Common::SizeClassMemoryPool::getSizeClassChunkSize(65), 80u);
+		TS_ASSERT_EQUALS(Common::SizeClassMemoryPool::getSizeClassChunkSize(129), 160u);
+		TS_ASSERT_EQUALS(Common::SizeClassMemoryPool::getSizeClassChunkSize(256), 256u);
+		TS_ASSERT_EQUALS(Common::SizeClassMemoryPool::getSizeClassChunkSize(257), 0u);
+
+		for (size_t size = 1; size <= 256; size++)
+			TS_ASSERT(Common::SizeClassMemoryPool::getSizeClassChunkSize(size) >= size);
+	}
+
+	void test_size_class_pool() {
+		Common::SizeClassMemoryPool pool;
+		Common::SizeClassMemoryPool::Stats stats;
+		byte *chunks[300];
+
+		for (int i = 0; i < 300; i++) {
+			chunks[i] = (byte *)pool.allocChunk(i + 1);
+			memset(chunks[i], i & 0xFF, i + 1);
+		}
+
+		pool.getStats(stats);
+		TS_ASSERT_EQUALS(stats.allocCount, 300u);
+		TS_ASSERT_EQUALS(stats.freeCount, 0u);
+		TS_ASSERT_EQUALS(stats.usedChunks, 256u);
+		TS_ASSERT(stats.usedBytes <= stats.reservedBytes);
+		// 44 large requests, plus at least one page per size class
+		TS_ASSERT(stats.mallocCount >= 44u + Common::SizeClassMemoryPool::kNumSizeClasses);
+
+		for (int i = 0; i < 300; i++) {
+			TS_ASSERT_EQUALS(chunks[i][0], i & 0xFF);
+			TS_ASSERT_EQUALS(chunks[i][i], i & 0xFF);
+			pool.freeChunk(chunks[i], i + 1);
+		}
+
+		pool.getStats(stats);
+		TS_ASSERT_EQUALS(stats.freeCount, 300u);
+		TS_ASSERT_EQUALS(stats.usedChunks, 0u);
+		TS_ASSERT_EQUALS(stats.usedBytes, 0u);
+
+		pool.freeUnusedPages();
+		pool.getStats(stats);
+		TS_ASSERT_EQUALS(stats.reservedBytes, 0u);
+	}
+};
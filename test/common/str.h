@@ -60,6 +60,16 @@ class StringTestSuite : public CxxTest::TestSuite
 		TS_ASSERT_EQUALS(str, "fooX");
 	}
 
+	void test_concat_empty() {
+		// Concatenating an empty string shares the storage of the other one
+		Common::String str("01234567890123456789012345678901");
+		Common::String empty;
+		TS_ASSERT_EQUALS((str + empty).c_str(), str.c_str());
+		TS_ASSERT_EQUALS((empty + str).c_str(), str.c_str());
+		TS_ASSERT_EQUALS((str + "").c_str(), str.c_str());
+		TS_ASSERT_EQUALS(str + "", "01234567890123456789012345678901");
+	}
+
 	void test_refCount() {
 		// using internal storage
 		Common::String foo1("foo");
@@ -0,0 +1,96 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/surface.h"
+#include "graphics/surfacepool.h"
+
+class SurfacePoolTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_reuse() {
+		Graphics::SurfacePool pool;
+
+		Graphics::Surface *a = pool.acquire(32, 32, 1);
+		TS_ASSERT_EQUALS(a->w, 32);
+		TS_ASSERT_EQUALS(a->h, 32);
+		TS_ASSERT_EQUALS(a->bytesPerPixel, 1);
+		pool.release(a);
+
+		// Only a surface of the same size and depth is reused
+		Graphics::Surface *b = pool.acquire(32, 32, 2);
+		TS_ASSERT_DIFFERS(a, b);
+		Graphics::Surface *c = pool.acquire(16, 64, 1);
+		TS_ASSERT_DIFFERS(a, c);
+		Graphics::Surface *d = pool.acquire(32, 32, 1);
+		TS_ASSERT_EQUALS(a, d);
+
+		// The pool is empty now, so the next one is created anew
+		Graphics::Surface *e = pool.acquire(32, 32, 1);
+		TS_ASSERT_DIFFERS(d, e);
+
+		pool.release(b);
+		pool.release(c);
+		pool.release(d);
+		pool.release(e);
+		pool.release(0);
+	}
+
+	void test_trim() {
+		Graphics::SurfacePool pool(2048);
+
+		Graphics::Surface *a = pool.acquire(32, 32, 1);
+		Graphics::Surface *b = pool.acquire(32, 16, 1);
+		Graphics::Surface *c = pool.acquire(16, 32, 1);
+		Graphics::Surface *d = pool.acquire(16, 16, 1);
+		Graphics::Surface *big = pool.acquire(64, 64, 1);
+
+		pool.release(a);
+		pool.release(b);
+		pool.release(c);
+		TS_ASSERT_EQUALS(pool.getStatistics().retainedBytes, 2048u);
+		TS_ASSERT_EQUALS(pool.getStatistics().discarded, 0u);
+
+		// Exceeds the limit, so the least recently released one is freed
+		pool.release(d);
+		TS_ASSERT_EQUALS(pool.getStatistics().retainedBytes, 1280u);
+		TS_ASSERT_EQUALS(pool.getStatistics().discarded, 1u);
+
+		// Larger than the limit, so it is not retained at all
+		pool.release(big);
+		TS_ASSERT_EQUALS(pool.getStatistics().retainedBytes, 1280u);
+		TS_ASSERT_EQUALS(pool.getStatistics().discarded, 2u);
+
+		Graphics::Surface *a2 = pool.acquire(32, 32, 1);
+		TS_ASSERT_EQUALS(pool.getStatistics().reused, 0u);
+		Graphics::Surface *b2 = pool.acquire(32, 16, 1);
+		TS_ASSERT_EQUALS(b, b2);
+		TS_ASSERT_EQUALS(pool.getStatistics().reused, 1u);
+		pool.release(a2);
+		pool.release(b2);
+
+		// Lowering the limit frees the surfaces exceeding it right away
+		pool.setMaxRetainedBytes(0);
+		TS_ASSERT_EQUALS(pool.getStatistics().retainedBytes, 0u);
+	}
+
+	void test_statistics() {
+		Graphics::SurfacePool pool;
+		const Graphics::SurfacePool::Statistics &stats = pool.getStatistics();
+		TS_ASSERT_EQUALS(stats.acquired, 0u);
+
+		Graphics::Surface *a = pool.acquire(32, 32, 1);
+		Graphics::Surface *b = pool.acquire(32, 32, 1);
+		pool.release(a);
+		pool.release(b);
+		TS_ASSERT_EQUALS(stats.retainedBytes, 2048u);
+
+		a = pool.acquire(32, 32, 1);
+		pool.release(a);
+		pool.clear();
+
+		TS_ASSERT_EQUALS(stats.acquired, 3u);
+		TS_ASSERT_EQUALS(stats.reused, 1u);
+		TS_ASSERT_EQUALS(stats.discarded, 2u);
+		TS_ASSERT_EQUALS(stats.retainedBytes, 0u);
+		TS_ASSERT_EQUALS(stats.peakRetainedBytes, 2048u);
+	}
+};
@@ -5,8 +5,8 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/sound/*.h
-TEST_LIBS    := sound/libsound.a common/libcommon.a
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/graphics/*.h $(srcdir)/test/sound/*.h
+TEST_LIBS    := graphics/libgraphics.a sound/libsound.a common/libcommon.a
 
 #
 TEST_FLAGS   := --runner=StdioPrinter
@@ -34,8 +34,15 @@ test/runner.cpp: $(TESTS)
 	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
 
 
+# Decode the videos in VIDEOS (a video or a directory of videos) as fast as
+# possible and print the decoding speed and CRCs, e.g.
+#   make bench-video VIDEOS=~/videos
+bench-video: $(EXECUTABLE)
+	./$(EXECUTABLE) --bench-video=$(VIDEOS)
+
+
 clean: clean-test
 clean-test:
 	-$(RM) test/runner.cpp test/runner
 
-.PHONY: test clean-test
+.PHONY: test clean-test bench-video